@@ -0,0 +1,168 @@
+#include "benchmarks.h"
+#include "harness.h"
+
+#include "os_memory.h"
+#include "freelist_host_memory.h"
+#include "pool_host_memory.h"
+#include "monotonic_buffer_host_memory.h"
+
+#include <memory_resource>
+#include <vector>
+
+using namespace rcq;
+using namespace rcq_benchmark;
+
+namespace
+{
+	constexpr uint32_t ALLOCATION_COUNT = 1 << 14;
+	constexpr size_t FREELIST_SIZE = 256 * 1024 * 1024;
+	constexpr size_t BLOCK_SIZE = 64;
+	constexpr size_t ALIGNMENT = 16;
+	constexpr size_t MIN_SIZE = 16;
+	constexpr size_t MAX_SIZE = 4096;
+
+	//allocates sizes[i] bytes in order, then frees them in free_order, returns the allocation count
+	uint64_t alloc_free(host_memory* memory, const std::vector<size_t>& sizes, const std::vector<uint32_t>& free_order,
+		std::vector<size_t>& ps)
+	{
+		for (uint32_t i = 0; i < ALLOCATION_COUNT; ++i)
+			ps[i] = memory->allocate(sizes[i], ALIGNMENT);
+		for (uint32_t i : free_order)
+			memory->deallocate(ps[i]);
+		keep(ps[0]);
+		return ALLOCATION_COUNT;
+	}
+
+	uint64_t alloc_free(std::pmr::memory_resource* resource, const std::vector<size_t>& sizes,
+		const std::vector<uint32_t>& free_order, std::vector<void*>& ps)
+	{
+		for (uint32_t i = 0; i < ALLOCATION_COUNT; ++i)
+			ps[i] = resource->allocate(sizes[i], ALIGNMENT);
+		for (uint32_t i : free_order)
+			resource->deallocate(ps[i], sizes[i], ALIGNMENT);
+		keep(reinterpret_cast<uint64_t>(ps[0]));
+		return ALLOCATION_COUNT;
+	}
+
+	//a size is freed and allocated again at random slots, the live set stays at ALLOCATION_COUNT
+	uint64_t churn(host_memory* memory, const std::vector<size_t>& sizes, const std::vector<uint32_t>& order,
+		std::vector<size_t>& ps)
+	{
+		for (uint32_t i : order)
+		{
+			memory->deallocate(ps[i]);
+			ps[i] = memory->allocate(sizes[i], ALIGNMENT);
+		}
+		keep(ps[0]);
+		return ALLOCATION_COUNT;
+	}
+
+	uint64_t churn(std::pmr::memory_resource* resource, const std::vector<size_t>& sizes, const std::vector<uint32_t>& order,
+		std::vector<void*>& ps)
+	{
+		for (uint32_t i : order)
+		{
+			resource->deallocate(ps[i], sizes[i], ALIGNMENT);
+			ps[i] = resource->allocate(sizes[i], ALIGNMENT);
+		}
+		keep(reinterpret_cast<uint64_t>(ps[0]));
+		return ALLOCATION_COUNT;
+	}
+
+	//the rcq resource against its std::pmr counterpart for the lifo, fifo, random free orders and the churn
+	void run_rows(const char* name, host_memory* memory, std::pmr::memory_resource* resource, const std::vector<size_t>& sizes,
+		const std::vector<uint32_t>& random_order)
+	{
+		std::vector<uint32_t> fifo_order(ALLOCATION_COUNT);
+		std::vector<uint32_t> lifo_order(ALLOCATION_COUNT);
+		for (uint32_t i = 0; i < ALLOCATION_COUNT; ++i)
+		{
+			fifo_order[i] = i;
+			lifo_order[i] = ALLOCATION_COUNT - 1 - i;
+		}
+
+		std::vector<size_t> ps(ALLOCATION_COUNT);
+		std::vector<void*> pmr_ps(ALLOCATION_COUNT);
+		const std::vector<uint32_t>* orders[] = { &lifo_order, &fifo_order, &random_order };
+		double ns[8];
+		for (uint32_t i = 0; i < 3; ++i)
+		{
+			ns[2 * i] = measure([&]() { return alloc_free(memory, sizes, *orders[i], ps); });
+			ns[2 * i + 1] = measure([&]() { return alloc_free(resource, sizes, *orders[i], pmr_ps); });
+		}
+
+		for (uint32_t i = 0; i < ALLOCATION_COUNT; ++i)
+		{
+			ps[i] = memory->allocate(sizes[i], ALIGNMENT);
+			pmr_ps[i] = resource->allocate(sizes[i], ALIGNMENT);
+		}
+		ns[6] = measure([&]() { return churn(memory, sizes, random_order, ps); });
+		ns[7] = measure([&]() { return churn(resource, sizes, random_order, pmr_ps); });
+		for (uint32_t i = 0; i < ALLOCATION_COUNT; ++i)
+		{
+			memory->deallocate(ps[i]);
+			resource->deallocate(pmr_ps[i], sizes[i], ALIGNMENT);
+		}
+
+		print_row(name, ns, 8);
+	}
+}
+
+void rcq_benchmark::run_allocator_benchmark()
+{
+	auto random_order = shuffled_indices(ALLOCATION_COUNT, 2);
+	std::vector<size_t> fixed_sizes(ALLOCATION_COUNT, BLOCK_SIZE);
+	std::vector<size_t> random_sizes(ALLOCATION_COUNT);
+	std::mt19937 rng(3);
+	std::uniform_int_distribution<size_t> size(MIN_SIZE, MAX_SIZE);
+	for (auto& s : random_sizes)
+		s = size(rng);
+
+	printf("allocators, %u allocations, ns per allocation and free\n", ALLOCATION_COUNT);
+	printf("%-28s %12s %12s %12s %12s %12s %12s %12s %12s\n", "", "rcq lifo", "pmr lifo", "rcq fifo", "pmr fifo",
+		"rcq random", "pmr random", "rcq churn", "pmr churn");
+
+	run_rows("os / new_delete fixed", &OS_MEMORY, std::pmr::new_delete_resource(), fixed_sizes, random_order);
+	run_rows("os / new_delete random", &OS_MEMORY, std::pmr::new_delete_resource(), random_sizes, random_order);
+
+	{
+		pool_host_memory pool(BLOCK_SIZE, ALIGNMENT, &OS_MEMORY);
+		std::pmr::pool_options options;
+		options.largest_required_pool_block = BLOCK_SIZE;
+		std::pmr::unsynchronized_pool_resource pmr_pool(options);
+		run_rows("pool / pool fixed", &pool, &pmr_pool, fixed_sizes, random_order);
+		pool.reset();
+	}
+
+	{
+		freelist_host_memory freelist(FREELIST_SIZE, ALIGNMENT, &OS_MEMORY);
+		std::pmr::unsynchronized_pool_resource pmr_pool;
+		run_rows("freelist / pool fixed", &freelist, &pmr_pool, fixed_sizes, random_order);
+		run_rows("freelist / pool random", &freelist, &pmr_pool, random_sizes, random_order);
+		freelist.reset();
+	}
+
+	//the monotonic buffers never free, only the allocation is measured and the buffers are rebuilt every round
+	double ns[2];
+	ns[0] = measure([&]()
+	{
+		monotonic_buffer_host_memory buffer(64 * 1024, ALIGNMENT, &OS_MEMORY);
+		uint64_t sum = 0;
+		for (size_t s : random_sizes)
+			sum += buffer.allocate(s, ALIGNMENT);
+		keep(sum);
+		buffer.reset();
+		return ALLOCATION_COUNT;
+	});
+	ns[1] = measure([&]()
+	{
+		std::pmr::monotonic_buffer_resource buffer(64 * 1024);
+		uint64_t sum = 0;
+		for (size_t s : random_sizes)
+			sum += reinterpret_cast<uint64_t>(buffer.allocate(s, ALIGNMENT));
+		keep(sum);
+		return ALLOCATION_COUNT;
+	});
+	printf("\n%-28s %12s %12s\n", "", "rcq", "pmr");
+	print_row("monotonic random", ns, 2);
+}
\ No newline at end of file
@@ -0,0 +1,12 @@
+#pragma once
+
+namespace rcq_benchmark
+{
+	void run_mpmc_queue_benchmark();
+	void run_container_benchmark();
+	void run_allocator_benchmark();
+
+	//the tests return false if a check failed
+	bool run_container_tests();
+	bool run_fft_tests();
+}
\ No newline at end of file
@@ -0,0 +1,381 @@
+#include "benchmarks.h"
+#include "harness.h"
+
+#include "vector.h"
+#include "list.h"
+#include "stack.h"
+#include "slot_map.h"
+#include "os_memory.h"
+#include "freelist_host_memory.h"
+
+#include <deque>
+#include <list>
+#include <memory_resource>
+#include <stack>
+#include <unordered_map>
+#include <vector>
+
+using namespace rcq;
+using namespace rcq_benchmark;
+
+namespace
+{
+	constexpr uint32_t ELEMENT_COUNT = 1 << 14;
+	constexpr size_t FREELIST_SIZE = 256 * 1024 * 1024;
+	constexpr uint32_t BACKING_COUNT = 2;
+
+	struct element
+	{
+		uint64_t key;
+		float data[6];
+	};
+
+	//the rcq containers use memory, the std::pmr ones resource
+	struct backing
+	{
+		host_memory* memory;
+		std::pmr::memory_resource* resource;
+	};
+
+	//f measures the rcq and the std::pmr version on a backing and writes their ns per operation
+	template<typename F>
+	void run_row(const char* name, const backing* backings, F f)
+	{
+		double ns[2 * BACKING_COUNT];
+		for (uint32_t i = 0; i < BACKING_COUNT; ++i)
+			f(backings[i], ns + 2 * i);
+		print_row(name, ns, 2 * BACKING_COUNT);
+	}
+
+	void run_vector(const backing* backings, const std::vector<uint32_t>& order)
+	{
+		run_row("vector push_back", backings, [&](const backing& b, double* ns)
+		{
+			ns[0] = measure([&]()
+			{
+				rcq::vector<element> v(b.memory);
+				for (uint32_t i = 0; i < ELEMENT_COUNT; ++i)
+					v.push_back()->key = i;
+				keep(v.size());
+				return ELEMENT_COUNT;
+			});
+			ns[1] = measure([&]()
+			{
+				std::pmr::vector<element> v(b.resource);
+				for (uint32_t i = 0; i < ELEMENT_COUNT; ++i)
+					v.push_back({ i });
+				keep(v.size());
+				return ELEMENT_COUNT;
+			});
+		});
+
+		run_row("vector iterate", backings, [&](const backing& b, double* ns)
+		{
+			rcq::vector<element> v(b.memory, ELEMENT_COUNT);
+			std::pmr::vector<element> pmr_v(ELEMENT_COUNT, b.resource);
+			for (uint32_t i = 0; i < ELEMENT_COUNT; ++i)
+				v[i].key = pmr_v[i].key = i;
+
+			ns[0] = measure([&]()
+			{
+				uint64_t sum = 0;
+				for (auto& e : v)
+					sum += e.key;
+				keep(sum);
+				return ELEMENT_COUNT;
+			});
+			ns[1] = measure([&]()
+			{
+				uint64_t sum = 0;
+				for (auto& e : pmr_v)
+					sum += e.key;
+				keep(sum);
+				return ELEMENT_COUNT;
+			});
+		});
+
+		//the erased element is replaced by the last one
+		run_row("vector push_back+erase", backings, [&](const backing& b, double* ns)
+		{
+			ns[0] = measure([&]()
+			{
+				rcq::vector<element> v(b.memory);
+				for (uint32_t i = 0; i < ELEMENT_COUNT; ++i)
+					v.push_back()->key = i;
+				for (uint32_t i : order)
+				{
+					size_t index = i % v.size();
+					v[index] = *v.last();
+					v.resize(v.size() - 1);
+				}
+				keep(v.size());
+				return ELEMENT_COUNT;
+			});
+			ns[1] = measure([&]()
+			{
+				std::pmr::vector<element> v(b.resource);
+				for (uint32_t i = 0; i < ELEMENT_COUNT; ++i)
+					v.push_back({ i });
+				for (uint32_t i : order)
+				{
+					size_t index = i % v.size();
+					v[index] = v.back();
+					v.pop_back();
+				}
+				keep(v.size());
+				return ELEMENT_COUNT;
+			});
+		});
+	}
+
+	void run_list(const backing* backings, const std::vector<uint32_t>& order)
+	{
+		run_row("list push_back", backings, [&](const backing& b, double* ns)
+		{
+			ns[0] = measure([&]()
+			{
+				rcq::list<element> l(b.memory);
+				for (uint32_t i = 0; i < ELEMENT_COUNT; ++i)
+					l.insert(l.end())->key = i;
+				keep(l.size());
+				return ELEMENT_COUNT;
+			});
+			ns[1] = measure([&]()
+			{
+				std::pmr::list<element> l(b.resource);
+				for (uint32_t i = 0; i < ELEMENT_COUNT; ++i)
+					l.push_back({ i });
+				keep(l.size());
+				return ELEMENT_COUNT;
+			});
+		});
+
+		run_row("list iterate", backings, [&](const backing& b, double* ns)
+		{
+			rcq::list<element> l(b.memory);
+			std::pmr::list<element> pmr_l(b.resource);
+			for (uint32_t i = 0; i < ELEMENT_COUNT; ++i)
+			{
+				l.insert(l.end())->key = i;
+				pmr_l.push_back({ i });
+			}
+
+			ns[0] = measure([&]()
+			{
+				uint64_t sum = 0;
+				for (auto it = l.begin(); it != l.end(); ++it)
+					sum += it->key;
+				keep(sum);
+				return ELEMENT_COUNT;
+			});
+			ns[1] = measure([&]()
+			{
+				uint64_t sum = 0;
+				for (auto& e : pmr_l)
+					sum += e.key;
+				keep(sum);
+				return ELEMENT_COUNT;
+			});
+		});
+
+		run_row("list push_back+erase", backings, [&](const backing& b, double* ns)
+		{
+			std::vector<rcq::list<element>::iterator> its(ELEMENT_COUNT, nullptr);
+			std::vector<std::pmr::list<element>::iterator> pmr_its(ELEMENT_COUNT);
+
+			ns[0] = measure([&]()
+			{
+				rcq::list<element> l(b.memory);
+				for (uint32_t i = 0; i < ELEMENT_COUNT; ++i)
+				{
+					its[i] = l.insert(l.end());
+					its[i]->key = i;
+				}
+				for (uint32_t i : order)
+					l.erase(its[i]);
+				keep(l.size());
+				return ELEMENT_COUNT;
+			});
+			ns[1] = measure([&]()
+			{
+				std::pmr::list<element> l(b.resource);
+				for (uint32_t i = 0; i < ELEMENT_COUNT; ++i)
+					pmr_its[i] = l.insert(l.end(), { i });
+				for (uint32_t i : order)
+					l.erase(pmr_its[i]);
+				keep(l.size());
+				return ELEMENT_COUNT;
+			});
+		});
+	}
+
+	void run_stack(const backing* backings)
+	{
+		run_row("stack push+pop", backings, [&](const backing& b, double* ns)
+		{
+			ns[0] = measure([&]()
+			{
+				rcq::stack<element> s(b.memory);
+				for (uint32_t i = 0; i < ELEMENT_COUNT; ++i)
+					s.push()->key = i;
+				uint64_t sum = 0;
+				while (!s.empty())
+				{
+					sum += s.top()->key;
+					s.pop();
+				}
+				keep(sum);
+				return ELEMENT_COUNT;
+			});
+			ns[1] = measure([&]()
+			{
+				std::stack<element, std::pmr::deque<element>> s{ std::pmr::deque<element>(b.resource) };
+				for (uint32_t i = 0; i < ELEMENT_COUNT; ++i)
+					s.push({ i });
+				uint64_t sum = 0;
+				while (!s.empty())
+				{
+					sum += s.top().key;
+					s.pop();
+				}
+				keep(sum);
+				return ELEMENT_COUNT;
+			});
+		});
+	}
+
+	//the std::pmr counterpart of a slot map is a hash map from the handles
+	void run_slot_map(const backing* backings, const std::vector<uint32_t>& order)
+	{
+		run_row("slot_map push", backings, [&](const backing& b, double* ns)
+		{
+			ns[0] = measure([&]()
+			{
+				slot_map<element> m(256, b.memory);
+				slot s;
+				for (uint32_t i = 0; i < ELEMENT_COUNT; ++i)
+					m.push(s)->key = i;
+				keep(m.size());
+				return ELEMENT_COUNT;
+			});
+			ns[1] = measure([&]()
+			{
+				std::pmr::unordered_map<uint32_t, element> m(b.resource);
+				for (uint32_t i = 0; i < ELEMENT_COUNT; ++i)
+					m.emplace(i, element{ i });
+				keep(m.size());
+				return ELEMENT_COUNT;
+			});
+		});
+
+		run_row("slot_map iterate", backings, [&](const backing& b, double* ns)
+		{
+			slot_map<element> m(256, b.memory);
+			std::pmr::unordered_map<uint32_t, element> pmr_m(b.resource);
+			slot s;
+			for (uint32_t i = 0; i < ELEMENT_COUNT; ++i)
+			{
+				m.push(s)->key = i;
+				pmr_m.emplace(i, element{ i });
+			}
+
+			ns[0] = measure([&]()
+			{
+				uint64_t sum = 0;
+				m.for_each([&](element& e) { sum += e.key; });
+				keep(sum);
+				return ELEMENT_COUNT;
+			});
+			ns[1] = measure([&]()
+			{
+				uint64_t sum = 0;
+				for (auto& e : pmr_m)
+					sum += e.second.key;
+				keep(sum);
+				return ELEMENT_COUNT;
+			});
+		});
+
+		run_row("slot_map lookup", backings, [&](const backing& b, double* ns)
+		{
+			slot_map<element> m(256, b.memory);
+			std::pmr::unordered_map<uint32_t, element> pmr_m(b.resource);
+			std::vector<slot> slots(ELEMENT_COUNT);
+			for (uint32_t i = 0; i < ELEMENT_COUNT; ++i)
+			{
+				m.push(slots[i])->key = i;
+				pmr_m.emplace(i, element{ i });
+			}
+
+			ns[0] = measure([&]()
+			{
+				uint64_t sum = 0;
+				for (uint32_t i : order)
+					sum += m.get(slots[i])->key;
+				keep(sum);
+				return ELEMENT_COUNT;
+			});
+			ns[1] = measure([&]()
+			{
+				uint64_t sum = 0;
+				for (uint32_t i : order)
+					sum += pmr_m.find(i)->second.key;
+				keep(sum);
+				return ELEMENT_COUNT;
+			});
+		});
+
+		//the destroyed handles are checked, so a broken slot map shows up as a mismatch
+		run_row("slot_map push+destroy", backings, [&](const backing& b, double* ns)
+		{
+			std::vector<slot> slots(ELEMENT_COUNT);
+			bool valid = true;
+			ns[0] = measure([&]()
+			{
+				slot_map<element> m(256, b.memory);
+				for (uint32_t i = 0; i < ELEMENT_COUNT; ++i)
+					m.push(slots[i])->key = i;
+				for (uint32_t i : order)
+				{
+					valid &= m.get(slots[i])->key == i;
+					valid &= m.destroy(slots[i]);
+				}
+				keep(m.size());
+				return ELEMENT_COUNT;
+			});
+			ns[1] = measure([&]()
+			{
+				std::pmr::unordered_map<uint32_t, element> m(b.resource);
+				for (uint32_t i = 0; i < ELEMENT_COUNT; ++i)
+					m.emplace(i, element{ i });
+				for (uint32_t i : order)
+					m.erase(i);
+				keep(m.size());
+				return ELEMENT_COUNT;
+			});
+			if (!valid)
+				printf("slot_map handle mismatch\n");
+		});
+	}
+}
+
+void rcq_benchmark::run_container_benchmark()
+{
+	freelist_host_memory freelist(FREELIST_SIZE, 64, &OS_MEMORY);
+	std::pmr::unsynchronized_pool_resource pool;
+	const backing backings[BACKING_COUNT] =
+	{
+		{ &OS_MEMORY, std::pmr::new_delete_resource() },
+		{ &freelist, &pool }
+	};
+	auto order = shuffled_indices(ELEMENT_COUNT, 1);
+
+	printf("containers of %u elements, ns per element\n", ELEMENT_COUNT);
+	printf("%-28s %12s %12s %12s %12s\n", "", "rcq os", "pmr new", "rcq freelist", "pmr pool");
+	run_vector(backings, order);
+	run_list(backings, order);
+	run_stack(backings);
+	run_slot_map(backings, order);
+
+	freelist.reset();
+}
\ No newline at end of file
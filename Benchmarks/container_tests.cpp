@@ -0,0 +1,73 @@
+#include "benchmarks.h"
+#include "tests.h"
+
+#include "slot_map.h"
+#include "os_memory.h"
+
+#include <vector>
+
+using namespace rcq;
+using namespace rcq_benchmark;
+
+namespace
+{
+	//more than one chunk, so the moved elements cross the chunk boundaries
+	constexpr uint32_t ELEMENT_COUNT = 1000;
+
+	//push, destroy from the middle, every live slot has to resolve to its own value and the destroyed ones to nothing
+	bool test_slot_map_destroy()
+	{
+		const char* name = "slot_map destroy";
+		bool passed = true;
+
+		slot_map<uint64_t> m(256, &OS_MEMORY);
+		std::vector<slot> slots(ELEMENT_COUNT);
+		for (uint32_t i = 0; i < ELEMENT_COUNT; ++i)
+			*m.push(slots[i]) = i;
+
+		std::vector<bool> live(ELEMENT_COUNT, true);
+		for (uint32_t i = ELEMENT_COUNT / 4; i < 3 * ELEMENT_COUNT / 4; i += 3)
+		{
+			passed &= check(m.destroy(slots[i]), name, "destroy of a live slot");
+			live[i] = false;
+		}
+		passed &= check(!m.destroy(slots[ELEMENT_COUNT / 4]), name, "second destroy of a slot");
+
+		uint32_t live_count = 0;
+		uint64_t live_sum = 0;
+		for (uint32_t i = 0; i < ELEMENT_COUNT; ++i)
+		{
+			uint64_t* value = m.get(slots[i]);
+			if (live[i])
+			{
+				passed &= check(value != nullptr && *value == i, name, "live slot resolves to its value");
+				++live_count;
+				live_sum += i;
+			}
+			else
+				passed &= check(value == nullptr, name, "destroyed slot resolves to nothing");
+		}
+		passed &= check(m.size() == live_count, name, "size");
+
+		//the freed slots are reused with a new generation
+		slot s;
+		*m.push(s) = ELEMENT_COUNT;
+		passed &= check(m.get(s) != nullptr && *m.get(s) == ELEMENT_COUNT, name, "reused slot resolves to its value");
+		live_sum += ELEMENT_COUNT;
+		++live_count;
+
+		uint32_t visited_count = 0;
+		uint64_t visited_sum = 0;
+		m.for_each([&](uint64_t& v) { ++visited_count; visited_sum += v; });
+		passed &= check(visited_count == live_count && visited_sum == live_sum, name, "for_each visits the live elements");
+
+		return passed;
+	}
+}
+
+bool rcq_benchmark::run_container_tests()
+{
+	bool passed = test_slot_map_destroy();
+	printf("container tests %s\n", passed ? "passed" : "failed");
+	return passed;
+}
\ No newline at end of file
@@ -0,0 +1,113 @@
+#include "benchmarks.h"
+#include "tests.h"
+
+#include "simd_fft.h"
+#include "os_memory.h"
+
+#include <math.h>
+#include <string.h>
+#include <random>
+
+using namespace rcq;
+using namespace rcq_benchmark;
+
+namespace
+{
+	//two complex fields, so the plane loop of the stages is covered
+	constexpr uint32_t PLANE_COUNT = 4;
+	//a lane range not starting at 0, as the simulator threads get
+	constexpr uint32_t LANE_BEGIN = simd_fft::LANE_STEP;
+	constexpr uint32_t LANE_END = 2 * simd_fft::LANE_STEP;
+	//the float error grows with sqrt(size) for inputs in [-1, 1], the tolerance is scaled with it
+	constexpr double TOLERANCE = 1e-5;
+
+	//the planes are size*size, the lanes are columns
+	bool test_fft_against_dft(uint32_t size, bool allow_avx2)
+	{
+		const char* name = "simd_fft";
+		size_t element_count = static_cast<size_t>(size)*size;
+
+		float* planes[2][PLANE_COUNT];
+		for (auto& p : planes)
+		{
+			for (auto& plane : p)
+				plane = reinterpret_cast<float*>(OS_MEMORY.allocate(element_count * sizeof(float), 32));
+		}
+
+		std::mt19937 generator(size);
+		std::uniform_real_distribution<float> distribution(-1.f, 1.f);
+		for (uint32_t plane = 0; plane < PLANE_COUNT; ++plane)
+		{
+			for (size_t i = 0; i < element_count; ++i)
+				planes[0][plane][i] = distribution(generator);
+		}
+
+		//the input is kept in planes[0] for the reference, so it is transformed from a copy
+		float* input[PLANE_COUNT];
+		for (uint32_t plane = 0; plane < PLANE_COUNT; ++plane)
+		{
+			input[plane] = reinterpret_cast<float*>(OS_MEMORY.allocate(element_count * sizeof(float), 32));
+			memcpy(input[plane], planes[0][plane], element_count * sizeof(float));
+		}
+
+		simd_fft fft(size, allow_avx2);
+		const float* const* result = fft.transform_columns(input, planes[1], PLANE_COUNT, LANE_BEGIN, LANE_END);
+
+		double max_error = 0.0;
+		for (uint32_t plane = 0; plane < PLANE_COUNT; plane += 2)
+		{
+			const float* in_re = planes[0][plane];
+			const float* in_im = planes[0][plane + 1];
+			for (uint32_t lane = LANE_BEGIN; lane < LANE_END; ++lane)
+			{
+				for (uint32_t j = 0; j < size; ++j)
+				{
+					//out[j] = sum in[n]*exp(2*pi*i*j*n/size)
+					double re = 0.0;
+					double im = 0.0;
+					for (uint32_t n = 0; n < size; ++n)
+					{
+						double angle = 2.0*3.14159265358979323846*static_cast<double>((static_cast<uint64_t>(j)*n) % size) / size;
+						double c = cos(angle);
+						double s = sin(angle);
+						double a_re = in_re[static_cast<size_t>(n)*size + lane];
+						double a_im = in_im[static_cast<size_t>(n)*size + lane];
+						re += a_re*c - a_im*s;
+						im += a_re*s + a_im*c;
+					}
+
+					size_t index = static_cast<size_t>(j)*size + lane;
+					max_error = fmax(max_error, fabs(result[plane][index] - re));
+					max_error = fmax(max_error, fabs(result[plane + 1][index] - im));
+				}
+			}
+		}
+
+		bool passed = check(max_error <= TOLERANCE*sqrt(static_cast<double>(size)), name, "matches the naive dft");
+		if (!passed)
+			printf("%s: size %u, avx2 allowed %d, max error %g\n", name, size, allow_avx2, max_error);
+
+		for (auto& p : planes)
+		{
+			for (auto plane : p)
+				OS_MEMORY.deallocate(reinterpret_cast<size_t>(plane));
+		}
+		for (auto plane : input)
+			OS_MEMORY.deallocate(reinterpret_cast<size_t>(plane));
+
+		return passed;
+	}
+}
+
+bool rcq_benchmark::run_fft_tests()
+{
+	bool passed = true;
+	//odd and even log2 sizes up to the largest water grid, the sse kernels are checked on avx2 machines too
+	for (uint32_t size = 2 * simd_fft::LANE_STEP; size <= 1024; size <<= 1)
+	{
+		passed &= test_fft_against_dft(size, false);
+		passed &= test_fft_against_dft(size, true);
+	}
+	printf("fft tests %s\n", passed ? "passed" : "failed");
+	return passed;
+}
\ No newline at end of file
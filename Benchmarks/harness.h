@@ -0,0 +1,60 @@
+#pragma once
+
+#include <algorithm>
+#include <chrono>
+#include <random>
+#include <vector>
+#include <stdint.h>
+#include <stdio.h>
+
+namespace rcq_benchmark
+{
+	constexpr double MIN_SECONDS = 0.2;
+
+	//the measured loops pass their results here, so they are not optimized away
+	inline void keep(uint64_t value)
+	{
+#ifdef _MSC_VER
+		//no inline assembly on x64, the store to a volatile is observable
+		static volatile uint64_t sink;
+		sink = value;
+#else
+		//the value has to be in a register, and the asm may read any memory the loop wrote
+		asm volatile("" : : "r"(value) : "memory");
+#endif
+	}
+
+	//runs f until it took at least MIN_SECONDS, f returns its operation count, returns ns per operation
+	template<typename F>
+	double measure(F f)
+	{
+		uint64_t op_count = 0;
+		double seconds;
+		auto start = std::chrono::steady_clock::now();
+		do
+		{
+			op_count += f();
+			seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+		} while (seconds < MIN_SECONDS);
+		return seconds*1e9 / op_count;
+	}
+
+	//the same random order for the rcq and the std::pmr side
+	inline std::vector<uint32_t> shuffled_indices(uint32_t count, uint32_t seed)
+	{
+		std::vector<uint32_t> indices(count);
+		for (uint32_t i = 0; i < count; ++i)
+			indices[i] = i;
+		std::shuffle(indices.begin(), indices.end(), std::mt19937(seed));
+		return indices;
+	}
+
+	//ns per operation of the rcq and the std::pmr version, for every backing memory
+	inline void print_row(const char* name, const double* ns, uint32_t count)
+	{
+		printf("%-28s", name);
+		for (uint32_t i = 0; i < count; ++i)
+			printf(" %12.2f", ns[i]);
+		printf("\n");
+	}
+}
\ No newline at end of file
@@ -0,0 +1,47 @@
+#include "benchmarks.h"
+
+#include <stdio.h>
+#include <string.h>
+
+//rcq_benchmarks [tests|mpmc_queue|containers|allocators], every suite runs without an argument
+int main(int argc, char** argv)
+{
+	const char* suite = argc > 1 ? argv[1] : nullptr;
+	bool found = false;
+	auto selected = [&](const char* name)
+	{
+		if (suite != nullptr && strcmp(suite, name) != 0)
+			return false;
+		found = true;
+		return true;
+	};
+	auto run = [&](const char* name, void(*f)())
+	{
+		if (selected(name))
+		{
+			f();
+			printf("\n");
+		}
+	};
+
+	//the tests run first, a failed check stops the run
+	if (selected("tests"))
+	{
+		bool passed = rcq_benchmark::run_container_tests();
+		passed &= rcq_benchmark::run_fft_tests();
+		if (!passed)
+			return 1;
+		printf("\n");
+	}
+
+	run("mpmc_queue", rcq_benchmark::run_mpmc_queue_benchmark);
+	run("containers", rcq_benchmark::run_container_benchmark);
+	run("allocators", rcq_benchmark::run_allocator_benchmark);
+
+	if (!found)
+	{
+		printf("unknown suite %s\n", suite);
+		return 1;
+	}
+	return 0;
+}
\ No newline at end of file
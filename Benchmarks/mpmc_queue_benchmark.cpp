@@ -0,0 +1,153 @@
+#include "benchmarks.h"
+
+#include "mpmc_queue.h"
+#include "os_memory.h"
+
+#include <chrono>
+#include <deque>
+#include <mutex>
+#include <stdio.h>
+#include <thread>
+#include <vector>
+
+using namespace rcq;
+
+namespace
+{
+	constexpr uint64_t VALUE_COUNT_PER_PRODUCER = 1 << 20;
+	constexpr size_t QUEUE_CAPACITY = 1024;
+	constexpr size_t BATCH_SIZE = 16;
+
+	//the baseline the engine used to wrap its queues with
+	class locked_queue
+	{
+	public:
+		bool try_push(uint64_t value)
+		{
+			std::lock_guard<std::mutex> lock(m_mutex);
+			if (m_values.size() == QUEUE_CAPACITY)
+				return false;
+			m_values.push_back(value);
+			return true;
+		}
+
+		bool try_pop(uint64_t& value)
+		{
+			std::lock_guard<std::mutex> lock(m_mutex);
+			if (m_values.empty())
+				return false;
+			value = m_values.front();
+			m_values.pop_front();
+			return true;
+		}
+
+	private:
+		std::mutex m_mutex;
+		std::deque<uint64_t> m_values;
+	};
+
+	//every producer pushes its values, the consumers pop until all of them arrived, returns the values per second
+	template<typename Push, typename Pop>
+	double run(uint32_t producer_count, uint32_t consumer_count, Push push, Pop pop)
+	{
+		uint64_t value_count = producer_count*VALUE_COUNT_PER_PRODUCER;
+		std::atomic<uint64_t> popped_count(0);
+		std::atomic<uint64_t> checksum(0);
+
+		auto start = std::chrono::steady_clock::now();
+
+		std::vector<std::thread> threads;
+		for (uint32_t i = 0; i < producer_count; ++i)
+		{
+			threads.emplace_back([i, push]()
+			{
+				uint64_t first = i*VALUE_COUNT_PER_PRODUCER;
+				uint64_t pushed_count = 0;
+				while (pushed_count != VALUE_COUNT_PER_PRODUCER)
+				{
+					uint64_t count = push(first + pushed_count, VALUE_COUNT_PER_PRODUCER - pushed_count);
+					if (count == 0)
+						std::this_thread::yield();
+					pushed_count += count;
+				}
+			});
+		}
+		for (uint32_t i = 0; i < consumer_count; ++i)
+		{
+			threads.emplace_back([&, pop]()
+			{
+				uint64_t sum = 0;
+				while (popped_count.load(std::memory_order_relaxed) != value_count)
+				{
+					uint64_t count = pop(sum);
+					if (count == 0)
+						std::this_thread::yield();
+					popped_count += count;
+				}
+				checksum += sum;
+			});
+		}
+		for (auto& t : threads)
+			t.join();
+
+		double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+		if (checksum != value_count*(value_count - 1) / 2)
+			printf("checksum mismatch\n");
+		return value_count / seconds;
+	}
+}
+
+void rcq_benchmark::run_mpmc_queue_benchmark()
+{
+	const uint32_t thread_counts[][2] = { { 1, 1 }, { 2, 2 }, { 4, 4 }, { 1, 4 }, { 4, 1 } };
+
+	printf("queue contention, million values per second\n");
+	printf("producers consumers       locked         mpmc   mpmc batch\n");
+	for (auto& c : thread_counts)
+	{
+		locked_queue locked;
+		double locked_rate = run(c[0], c[1], [&](uint64_t value, uint64_t)
+		{
+			return locked.try_push(value) ? uint64_t(1) : uint64_t(0);
+		}, [&](uint64_t& sum)
+		{
+			uint64_t value;
+			if (!locked.try_pop(value))
+				return uint64_t(0);
+			sum += value;
+			return uint64_t(1);
+		});
+
+		mpmc_queue<uint64_t> single(&OS_MEMORY, QUEUE_CAPACITY);
+		double single_rate = run(c[0], c[1], [&](uint64_t value, uint64_t)
+		{
+			return single.try_push(value) ? uint64_t(1) : uint64_t(0);
+		}, [&](uint64_t& sum)
+		{
+			uint64_t value;
+			if (!single.try_pop(value))
+				return uint64_t(0);
+			sum += value;
+			return uint64_t(1);
+		});
+
+		mpmc_queue<uint64_t> batched(&OS_MEMORY, QUEUE_CAPACITY);
+		double batched_rate = run(c[0], c[1], [&](uint64_t first, uint64_t remaining)
+		{
+			uint64_t values[BATCH_SIZE];
+			size_t count = remaining < BATCH_SIZE ? static_cast<size_t>(remaining) : BATCH_SIZE;
+			for (size_t i = 0; i < count; ++i)
+				values[i] = first + i;
+			return static_cast<uint64_t>(batched.try_push(values, count));
+		}, [&](uint64_t& sum)
+		{
+			uint64_t values[BATCH_SIZE];
+			size_t count = batched.try_pop(values, BATCH_SIZE);
+			for (size_t i = 0; i < count; ++i)
+				sum += values[i];
+			return static_cast<uint64_t>(count);
+		});
+
+		printf("%9u %9u %12.2f %12.2f %12.2f\n", c[0], c[1], locked_rate / 1e6, single_rate / 1e6, batched_rate / 1e6);
+	}
+}
\ No newline at end of file
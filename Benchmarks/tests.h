@@ -0,0 +1,14 @@
+#pragma once
+
+#include <stdio.h>
+
+namespace rcq_benchmark
+{
+	//prints the failed check, the tests keep running to report every failure
+	inline bool check(bool condition, const char* test, const char* what)
+	{
+		if (!condition)
+			printf("%s: %s failed\n", test, what);
+		return condition;
+	}
+}
\ No newline at end of file
@@ -0,0 +1,112 @@
+#include "tests.h"
+
+#include "freelist_device_memory.h"
+#include "os_memory.h"
+
+using namespace rcq;
+using namespace rcq_benchmark;
+
+namespace
+{
+	constexpr VkDeviceSize MEMORY_SIZE = 1 << 20;
+	constexpr VkDeviceSize ALIGNMENT = 256;
+	constexpr VkDeviceSize RESOURCE_SIZE = 4096;
+	constexpr uint32_t RESOURCE_COUNT = 4;
+
+	//the freelist only takes its range from the upstream, no device memory is needed to walk it
+	class fake_upstream_memory : public device_memory
+	{
+	public:
+		fake_upstream_memory() :
+			device_memory(ALIGNMENT, VK_NULL_HANDLE, &m_memory, nullptr),
+			m_memory(VK_NULL_HANDLE)
+		{}
+
+		VkDeviceSize allocate(VkDeviceSize, VkDeviceSize) override
+		{
+			return 0;
+		}
+
+		void deallocate(VkDeviceSize) override
+		{}
+
+	private:
+		VkDeviceMemory m_memory;
+	};
+
+	//frees a hole below the top resources, then moves the top one down into it as the defragmentation does
+	bool test_freelist_relocation()
+	{
+		const char* name = "freelist_device_memory relocation";
+		bool passed = true;
+
+		fake_upstream_memory upstream;
+		freelist_device_memory memory;
+		memory.init(MEMORY_SIZE, ALIGNMENT, &upstream, &OS_MEMORY);
+
+		//the owners only have to be distinct addresses
+		int owners[RESOURCE_COUNT];
+		VkDeviceSize offsets[RESOURCE_COUNT];
+		for (uint32_t i = 0; i < RESOURCE_COUNT; ++i)
+			offsets[i] = memory.allocate(RESOURCE_SIZE, ALIGNMENT, &owners[i]);
+		passed &= check(memory.lowest_free() == RESOURCE_COUNT*RESOURCE_SIZE, name, "lowest free range after the resources");
+
+		memory.deallocate(offsets[1]);
+		passed &= check(memory.lowest_free() == offsets[1], name, "lowest free range is the hole");
+
+		//the owners above the hole from the highest address down
+		const void* visited[RESOURCE_COUNT];
+		uint32_t visited_count = 0;
+		bool finished = memory.for_each_owner_above(memory.lowest_free(), [&](const void* owner)
+		{
+			visited[visited_count++] = owner;
+			return true;
+		});
+		passed &= check(finished && visited_count == 2 && visited[0] == &owners[3] && visited[1] == &owners[2], name,
+			"owners above the hole in descending order");
+
+		visited_count = 0;
+		finished = memory.for_each_owner_above(memory.lowest_free(), [&](const void* owner)
+		{
+			visited[visited_count++] = owner;
+			return false;
+		});
+		passed &= check(!finished && visited_count == 1, name, "the walk stops when the callable returns false");
+
+		//the hole is too small for two resources and nothing is free below the first one
+		passed &= check(memory.allocate_below(2 * RESOURCE_SIZE, ALIGNMENT, offsets[3], &owners[3]) == offsets[3], name,
+			"no range below the limit for a larger resource");
+		passed &= check(memory.allocate_below(RESOURCE_SIZE, ALIGNMENT, offsets[0], &owners[3]) == offsets[0], name,
+			"no range below the lowest resource");
+
+		VkDeviceSize moved = memory.allocate_below(RESOURCE_SIZE, ALIGNMENT, offsets[3], &owners[3]);
+		passed &= check(moved == offsets[1], name, "the top resource is moved into the hole");
+
+		//the old range merges with the free top, nothing is left to move
+		memory.deallocate(offsets[3]);
+		passed &= check(memory.lowest_free() == offsets[3], name, "the free range is at the top after the move");
+		visited_count = 0;
+		memory.for_each_owner_above(memory.lowest_free(), [&](const void*)
+		{
+			++visited_count;
+			return true;
+		});
+		passed &= check(visited_count == 0, name, "no owner above the top free range");
+
+		memory.deallocate(offsets[0]);
+		memory.deallocate(moved);
+		memory.deallocate(offsets[2]);
+		passed &= check(memory.unused(), name, "empty after freeing every resource");
+		memory.reset();
+
+		return passed;
+	}
+}
+
+//the freelist tests need the vulkan headers, they are kept out of rcq_benchmarks
+int main()
+{
+	bool passed = test_freelist_relocation();
+	printf("device memory tests %s\n", passed ? "passed" : "failed");
+	return passed ? 0 : 1;
+}
\ No newline at end of file
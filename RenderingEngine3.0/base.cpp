@@ -1,9 +1,12 @@
 #include "base.h"
 
-#include "const_swap_chain_image_extent.h"
 #include "const_max_alignment.h"
 
 #include "os_memory.h"
+#include "enum_memory_type.h"
+#include "memory_registry.h"
+#include "vector.h"
+#include "utility.h"
 
 #include <assert.h>
 
@@ -17,6 +20,7 @@ base::base(const base_create_info& info) :
 	m_host_memory(64*1024*1024, MAX_ALIGNMENT, &OS_MEMORY)
 {
 	m_vk_alloc.init(&m_host_memory);
+	memory_registry::add("base", "host_memory", &m_host_memory);
 
 	create_window();
 	create_instance();
@@ -26,10 +30,15 @@ base::base(const base_create_info& info) :
 		setup_debug_callbacks();
 	}
 
-	create_surface();
+	if (!info.headless)
+		create_surface();
 	pick_physical_device();
 	create_logical_device();
-	create_swapchain();
+	pick_memory_types();
+	if (info.headless)
+		create_offscreen_images();
+	else
+		create_swapchain();
 	create_swapchain_views();
 	fill_base_info();
 }
@@ -37,17 +46,30 @@ base::base(const base_create_info& info) :
 
 base::~base()
 {
+	memory_registry::remove_owner("base");
+
 	for (auto& v : m_swapchain_views)
 		vkDestroyImageView(m_device, v, m_vk_alloc);
-	vkDestroySwapchainKHR(m_device, m_swapchain, m_vk_alloc);
+	if (m_info.headless)
+	{
+		for (auto& im : m_swapchain_images)
+			vkDestroyImage(m_device, im, m_vk_alloc);
+		vkFreeMemory(m_device, m_offscreen_memory, m_vk_alloc);
+	}
+	else
+		vkDestroySwapchainKHR(m_device, m_swapchain, m_vk_alloc);
 	vkDestroyDevice(m_device, m_vk_alloc);
-	vkDestroySurfaceKHR(m_vk_instance, m_surface, m_vk_alloc);
+	if (!m_info.headless)
+		vkDestroySurfaceKHR(m_vk_instance, m_surface, m_vk_alloc);
 	if (m_info.enable_validation_layers)
 		DestroyDebugReportCallbackEXT(m_vk_instance, m_callback, m_vk_alloc);
 	vkDestroyInstance(m_vk_instance, m_vk_alloc);
 
-	glfwDestroyWindow(m_window);
-	glfwTerminate();
+	if (!m_info.headless)
+	{
+		glfwDestroyWindow(m_window);
+		glfwTerminate();
+	}
 }
 
 void base::init(const base_create_info& info)
@@ -65,10 +87,16 @@ void base::destroy()
 
 void base::create_window()
 {
+	if (m_info.headless)
+	{
+		m_window = nullptr;
+		return;
+	}
+
 	glfwInit();
 	glfwWindowHint(GLFW_CLIENT_API, GLFW_NO_API);
 	glfwWindowHint(GLFW_RESIZABLE, GLFW_FALSE);
-	m_window = glfwCreateWindow(SWAP_CHAIN_IMAGE_EXTENT.width, SWAP_CHAIN_IMAGE_EXTENT.height, m_info.window_name, nullptr, nullptr);
+	m_window = glfwCreateWindow(m_info.extent.width, m_info.extent.height, m_info.window_name, nullptr, nullptr);
 }
 
 bool base::check_validation_layer_support()
@@ -115,9 +143,11 @@ void base::create_instance()
 	create_info.pApplicationInfo = &app_info;
 
 
-	uint32_t glfw_extension_count;
-	const char** glfw_extensions;
-	glfw_extensions = glfwGetRequiredInstanceExtensions(&glfw_extension_count);
+	//the surface extensions are only needed with a window
+	uint32_t glfw_extension_count = 0;
+	const char** glfw_extensions = nullptr;
+	if (!m_info.headless)
+		glfw_extensions = glfwGetRequiredInstanceExtensions(&glfw_extension_count);
 	const char* required_extensions[32];
 	uint32_t required_extension_count = glfw_extension_count + m_info.instance_extensions_count;
 	assert(required_extension_count <= 32);
@@ -203,32 +233,36 @@ uint32_t base::find_queue_family_index()
 	assert(queue_family_count <= 16);
 	vkGetPhysicalDeviceQueueFamilyProperties(m_physical_device, &queue_family_count, queue_families);
 
-	int i = 0;
-	for (const auto& family : queue_families)
+	//a family with a queue for every role and sparse binding, in headless mode any graphics and compute family will do
+	uint32_t fallback = ~0u;
+	for (uint32_t i = 0; i < queue_family_count; ++i)
 	{
-		if (family.queueCount < 5)
-		{
-			++i;
+		const auto& family = queue_families[i];
+		if (!((family.queueFlags & VK_QUEUE_GRAPHICS_BIT) && (family.queueFlags & VK_QUEUE_COMPUTE_BIT)))
 			continue;
-		}
 
-		if (!((family.queueFlags & VK_QUEUE_GRAPHICS_BIT) && (family.queueFlags & VK_QUEUE_SPARSE_BINDING_BIT) &&
-			(family.queueFlags & VK_QUEUE_COMPUTE_BIT) && family.queueFlags))
+		if (family.queueCount < QUEUE_COUNT || !(family.queueFlags & VK_QUEUE_SPARSE_BINDING_BIT))
 		{
-			++i;
+			if (m_info.headless && fallback == ~0u)
+				fallback = i;
 			continue;
 		}
 
-		VkBool32 present_support = false;
-		vkGetPhysicalDeviceSurfaceSupportKHR(m_physical_device, i, m_surface, &present_support);
+		VkBool32 present_support = m_info.headless;
+		if (!m_info.headless)
+			vkGetPhysicalDeviceSurfaceSupportKHR(m_physical_device, i, m_surface, &present_support);
 
 		if (present_support)
+		{
+			m_queue_count = QUEUE_COUNT;
+			m_queue_flags = family.queueFlags;
 			return i;
-
-		++i;
+		}
 	}
-	assert(false);
-	return ~0;
+	assert(fallback != ~0u);
+	m_queue_count = queue_families[fallback].queueCount < QUEUE_COUNT ? queue_families[fallback].queueCount : QUEUE_COUNT;
+	m_queue_flags = queue_families[fallback].queueFlags;
+	return fallback;
 }
 
 void base::create_logical_device()
@@ -259,16 +293,70 @@ void base::create_logical_device()
 	VkDeviceQueueCreateInfo queue = {};
 	queue.sType = VK_STRUCTURE_TYPE_DEVICE_QUEUE_CREATE_INFO;
 	queue.queueFamilyIndex = m_queue_family_index;
-	queue.queueCount = QUEUE_COUNT;
+	queue.queueCount = m_queue_count;
 	queue.pQueuePriorities = queue_priorities;
 
+	//the feature struct is an array of VkBool32
+	VkPhysicalDeviceFeatures supported_features;
+	vkGetPhysicalDeviceFeatures(m_physical_device, &supported_features);
+	{
+		constexpr uint32_t FEATURE_COUNT = sizeof(VkPhysicalDeviceFeatures) / sizeof(VkBool32);
+		auto required = reinterpret_cast<const VkBool32*>(&m_info.device_features);
+		auto optional = reinterpret_cast<const VkBool32*>(&m_info.optional_device_features);
+		auto supported = reinterpret_cast<const VkBool32*>(&supported_features);
+		auto enabled = reinterpret_cast<VkBool32*>(&m_enabled_features);
+		for (uint32_t i = 0; i < FEATURE_COUNT; ++i)
+			enabled[i] = (required[i] || (optional[i] && supported[i])) ? VK_TRUE : VK_FALSE;
+	}
+	//the sparse binds need a queue with sparse binding, without one the terrain is not supported
+	if (!(m_queue_flags & VK_QUEUE_SPARSE_BINDING_BIT))
+	{
+		assert(!m_info.device_features.sparseBinding);
+		m_enabled_features.sparseBinding = VK_FALSE;
+	}
+
+	//the required extensions and the supported optional ones
+	uint32_t available_extension_count;
+	vkEnumerateDeviceExtensionProperties(m_physical_device, nullptr, &available_extension_count, nullptr);
+	vector<VkExtensionProperties> available_extensions(&m_host_memory, available_extension_count);
+	vkEnumerateDeviceExtensionProperties(m_physical_device, nullptr, &available_extension_count, available_extensions.data());
+
+	const char* extensions[32];
+	uint32_t extension_count = m_info.device_extensions_count;
+	assert(extension_count + m_info.optional_device_extensions_count <= 32);
+	for (uint32_t i = 0; i < m_info.device_extensions_count; ++i)
+		extensions[i] = m_info.device_extensions[i];
+	for (uint32_t i = 0; i < m_info.optional_device_extensions_count; ++i)
+	{
+		for (auto& e : available_extensions)
+		{
+			if (strcmp(m_info.optional_device_extensions[i], e.extensionName) == 0)
+			{
+				extensions[extension_count++] = m_info.optional_device_extensions[i];
+				break;
+			}
+		}
+	}
+
+	auto enabled = [&](const char* name)
+	{
+		for (uint32_t i = 0; i < extension_count; ++i)
+		{
+			if (strcmp(extensions[i], name) == 0)
+				return true;
+		}
+		return false;
+	};
+	m_dedicated_allocation = enabled(VK_KHR_GET_MEMORY_REQUIREMENTS_2_EXTENSION_NAME) &&
+		enabled(VK_KHR_DEDICATED_ALLOCATION_EXTENSION_NAME);
+
 	VkDeviceCreateInfo create_info = {};
 	create_info.sType = VK_STRUCTURE_TYPE_DEVICE_CREATE_INFO;
 	create_info.pQueueCreateInfos = &queue;
 	create_info.queueCreateInfoCount = 1;
-	create_info.pEnabledFeatures = &m_info.device_features;
-	create_info.ppEnabledExtensionNames = m_info.device_extensions;
-	create_info.enabledExtensionCount = m_info.device_extensions_count;
+	create_info.pEnabledFeatures = &m_enabled_features;
+	create_info.ppEnabledExtensionNames = extensions;
+	create_info.enabledExtensionCount = extension_count;
 
 	if (m_info.enable_validation_layers)
 	{
@@ -281,7 +369,68 @@ void base::create_logical_device()
 	assert(vkCreateDevice(m_physical_device, &create_info, m_vk_alloc, &m_device) == VK_SUCCESS);
 
 	for (uint32_t i = 0; i < QUEUE_COUNT; ++i)
-		vkGetDeviceQueue(m_device, m_queue_family_index, i, m_queues + i);
+		vkGetDeviceQueue(m_device, m_queue_family_index, i < m_queue_count ? i : QUEUE_RENDER, m_queues + i);
+}
+
+//the device local types are the ones a probe buffer and a probe image can use, the roles missing on the device fall back
+void base::pick_memory_types()
+{
+	VkPhysicalDeviceMemoryProperties memory_properties;
+	vkGetPhysicalDeviceMemoryProperties(m_physical_device, &memory_properties);
+
+	//probe buffer with the usages of the device local buffers
+	VkBufferCreateInfo b = {};
+	b.sType = VK_STRUCTURE_TYPE_BUFFER_CREATE_INFO;
+	b.sharingMode = VK_SHARING_MODE_EXCLUSIVE;
+	b.size = 256;
+	b.usage = VK_BUFFER_USAGE_VERTEX_BUFFER_BIT | VK_BUFFER_USAGE_INDEX_BUFFER_BIT | VK_BUFFER_USAGE_UNIFORM_BUFFER_BIT |
+		VK_BUFFER_USAGE_STORAGE_BUFFER_BIT | VK_BUFFER_USAGE_TRANSFER_SRC_BIT | VK_BUFFER_USAGE_TRANSFER_DST_BIT;
+
+	VkBuffer buffer;
+	assert(vkCreateBuffer(m_device, &b, m_vk_alloc, &buffer) == VK_SUCCESS);
+	VkMemoryRequirements buffer_mr;
+	vkGetBufferMemoryRequirements(m_device, buffer, &buffer_mr);
+	vkDestroyBuffer(m_device, buffer, m_vk_alloc);
+
+	//probe image, a sampled texture
+	VkImageCreateInfo im = {};
+	im.sType = VK_STRUCTURE_TYPE_IMAGE_CREATE_INFO;
+	im.arrayLayers = 1;
+	im.extent.width = 64;
+	im.extent.height = 64;
+	im.extent.depth = 1;
+	im.format = VK_FORMAT_R8G8B8A8_UNORM;
+	im.imageType = VK_IMAGE_TYPE_2D;
+	im.initialLayout = VK_IMAGE_LAYOUT_UNDEFINED;
+	im.mipLevels = 1;
+	im.samples = VK_SAMPLE_COUNT_1_BIT;
+	im.sharingMode = VK_SHARING_MODE_EXCLUSIVE;
+	im.tiling = VK_IMAGE_TILING_OPTIMAL;
+	im.usage = VK_IMAGE_USAGE_TRANSFER_DST_BIT | VK_IMAGE_USAGE_SAMPLED_BIT | VK_IMAGE_USAGE_COLOR_ATTACHMENT_BIT;
+
+	VkImage image;
+	assert(vkCreateImage(m_device, &im, m_vk_alloc, &image) == VK_SUCCESS);
+	VkMemoryRequirements image_mr;
+	vkGetImageMemoryRequirements(m_device, image, &image_mr);
+	vkDestroyImage(m_device, image, m_vk_alloc);
+
+	m_memory_types[MEMORY_TYPE_DL0] = utility::find_memory_type(memory_properties, buffer_mr.memoryTypeBits,
+		VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT);
+	m_memory_types[MEMORY_TYPE_DL1] = utility::find_memory_type(memory_properties, image_mr.memoryTypeBits,
+		VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT);
+	m_memory_types[MEMORY_TYPE_HVC] = utility::find_memory_type(memory_properties, buffer_mr.memoryTypeBits,
+		VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT | VK_MEMORY_PROPERTY_HOST_COHERENT_BIT);
+	m_memory_types[MEMORY_TYPE_HVCC] = utility::find_memory_type(memory_properties, buffer_mr.memoryTypeBits,
+		VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT | VK_MEMORY_PROPERTY_HOST_COHERENT_BIT | VK_MEMORY_PROPERTY_HOST_CACHED_BIT);
+	m_memory_types[MEMORY_TYPE_LAZY] = utility::find_memory_type(memory_properties, ~0u,
+		VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT | VK_MEMORY_PROPERTY_LAZILY_ALLOCATED_BIT);
+
+	assert(m_memory_types[MEMORY_TYPE_DL0] != ~0u && m_memory_types[MEMORY_TYPE_DL1] != ~0u &&
+		m_memory_types[MEMORY_TYPE_HVC] != ~0u);
+	if (m_memory_types[MEMORY_TYPE_HVCC] == ~0u)
+		m_memory_types[MEMORY_TYPE_HVCC] = m_memory_types[MEMORY_TYPE_HVC];
+	if (m_memory_types[MEMORY_TYPE_LAZY] == ~0u)
+		m_memory_types[MEMORY_TYPE_LAZY] = m_memory_types[MEMORY_TYPE_DL1];
 }
 
 void base::create_swapchain()
@@ -335,10 +484,10 @@ void base::create_swapchain()
 	if (capabilities.maxImageCount != 0)
 		assert(capabilities.maxImageCount >= SWAP_CHAIN_IMAGE_COUNT);
 
-	assert(capabilities.minImageExtent.width <= SWAP_CHAIN_IMAGE_EXTENT.width &&
-		capabilities.minImageExtent.height <= SWAP_CHAIN_IMAGE_EXTENT.height &&
-		capabilities.maxImageExtent.width >= SWAP_CHAIN_IMAGE_EXTENT.width &&
-		capabilities.maxImageExtent.height >= SWAP_CHAIN_IMAGE_EXTENT.height);
+	assert(capabilities.minImageExtent.width <= m_info.extent.width &&
+		capabilities.minImageExtent.height <= m_info.extent.height &&
+		capabilities.maxImageExtent.width >= m_info.extent.width &&
+		capabilities.maxImageExtent.height >= m_info.extent.height);
 
 
 
@@ -349,7 +498,7 @@ void base::create_swapchain()
 	sc.minImageCount = SWAP_CHAIN_IMAGE_COUNT;
 	sc.imageFormat = surface_format.format;
 	sc.imageColorSpace = surface_format.colorSpace;
-	sc.imageExtent = SWAP_CHAIN_IMAGE_EXTENT;
+	sc.imageExtent = m_info.extent;
 	sc.presentMode = present_mode;
 	sc.compositeAlpha = VK_COMPOSITE_ALPHA_OPAQUE_BIT_KHR;
 	sc.imageArrayLayers = 1;
@@ -383,6 +532,43 @@ void base::create_swapchain()
 	vkGetSwapchainImagesKHR(m_device, m_swapchain, &image_count, m_swapchain_images);
 }
 
+void base::create_offscreen_images()
+{
+	m_swapchain = VK_NULL_HANDLE;
+
+	//the final image is read back instead of presented
+	VkImageCreateInfo image = {};
+	image.sType = VK_STRUCTURE_TYPE_IMAGE_CREATE_INFO;
+	image.arrayLayers = 1;
+	image.extent.width = m_info.extent.width;
+	image.extent.height = m_info.extent.height;
+	image.extent.depth = 1;
+	image.format = VK_FORMAT_B8G8R8A8_UNORM;
+	image.imageType = VK_IMAGE_TYPE_2D;
+	image.initialLayout = VK_IMAGE_LAYOUT_UNDEFINED;
+	image.mipLevels = 1;
+	image.samples = VK_SAMPLE_COUNT_1_BIT;
+	image.sharingMode = VK_SHARING_MODE_EXCLUSIVE;
+	image.tiling = VK_IMAGE_TILING_OPTIMAL;
+	image.usage = VK_IMAGE_USAGE_COLOR_ATTACHMENT_BIT | VK_IMAGE_USAGE_TRANSFER_SRC_BIT;
+
+	for (auto& im : m_swapchain_images)
+		assert(vkCreateImage(m_device, &image, m_vk_alloc, &im) == VK_SUCCESS);
+
+	VkMemoryRequirements mr;
+	vkGetImageMemoryRequirements(m_device, m_swapchain_images[0], &mr);
+	VkDeviceSize image_size = (mr.size + mr.alignment - 1) & ~(mr.alignment - 1);
+
+	VkMemoryAllocateInfo alloc = {};
+	alloc.sType = VK_STRUCTURE_TYPE_MEMORY_ALLOCATE_INFO;
+	alloc.allocationSize = image_size*SWAP_CHAIN_IMAGE_COUNT;
+	alloc.memoryTypeIndex = m_memory_types[MEMORY_TYPE_DL1];
+	assert(vkAllocateMemory(m_device, &alloc, m_vk_alloc, &m_offscreen_memory) == VK_SUCCESS);
+
+	for (uint32_t i = 0; i < SWAP_CHAIN_IMAGE_COUNT; ++i)
+		assert(vkBindImageMemory(m_device, m_swapchain_images[i], m_offscreen_memory, i*image_size) == VK_SUCCESS);
+}
+
 void base::create_swapchain_views()
 {
 	VkImageViewCreateInfo view = {};
@@ -409,11 +595,23 @@ void base::fill_base_info()
 	m_base_info.physical_device = m_physical_device;
 	m_base_info.queue_family_index = m_queue_family_index;
 	m_base_info.swapchain = m_swapchain;
+	m_base_info.extent = m_info.extent;
+	m_base_info.headless = m_info.headless;
 	m_base_info.window = m_window;
-	for(uint32_t i=0; i<SWAP_CHAIN_IMAGE_COUNT; ++i)
+	m_base_info.enabled_features = m_enabled_features;
+	m_base_info.dedicated_allocation = m_dedicated_allocation;
+	for (uint32_t i = 0; i < MEMORY_TYPE_COUNT; ++i)
+		m_base_info.memory_types[i] = m_memory_types[i];
+	for (uint32_t i = 0; i < SWAP_CHAIN_IMAGE_COUNT; ++i)
+	{
+		m_base_info.swapchain_images[i] = m_swapchain_images[i];
 		m_base_info.swapchain_views[i] = m_swapchain_views[i];
+	}
 	for (uint32_t i = 0; i < QUEUE_COUNT; ++i)
+	{
 		m_base_info.queues[i] = m_queues[i];
+		m_base_info.queue_mutexes[i] = m_queue_mutexes + (i < m_queue_count ? i : QUEUE_RENDER);
+	}
 }
 
 
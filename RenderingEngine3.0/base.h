@@ -8,9 +8,12 @@
 #include "base_create_info.h"
 #include "base_info.h"
 
+#include "enum_memory_type.h"
+
 #include "const_swap_chain_image_count.h"
 
 #include <iostream>
+#include <mutex>
 
 namespace rcq
 {
@@ -58,9 +61,24 @@ namespace rcq
 		VkImage m_swapchain_images[SWAP_CHAIN_IMAGE_COUNT];
 		VkImageView m_swapchain_views[SWAP_CHAIN_IMAGE_COUNT];
 
-		//queues
+		//images of the swapchain in headless mode
+		VkDeviceMemory m_offscreen_memory;
+
+		//queues, in headless mode the family may have fewer queues than roles, the rest share the render queue
 		uint32_t m_queue_family_index;
+		uint32_t m_queue_count;
+		VkQueueFlags m_queue_flags;
 		VkQueue m_queues[QUEUE_COUNT];
+		std::mutex m_queue_mutexes[QUEUE_COUNT];
+
+		//required features and the supported optional ones
+		VkPhysicalDeviceFeatures m_enabled_features;
+
+		//the extensions of the dedicated allocations are enabled
+		bool m_dedicated_allocation;
+
+		//memory type index of every role
+		uint32_t m_memory_types[MEMORY_TYPE_COUNT];
 
 
 		//create functions
@@ -71,7 +89,9 @@ namespace rcq
 		void pick_physical_device();
 		uint32_t find_queue_family_index();
 		void create_logical_device();
+		void pick_memory_types();
 		void create_swapchain();
+		void create_offscreen_images();
 		void create_swapchain_views();
 		void fill_base_info();
 		bool check_validation_layer_support();
@@ -12,8 +12,13 @@ namespace rcq
 		uint32_t instance_extensions_count;
 		const char** device_extensions;
 		uint32_t device_extensions_count;
+		const char** optional_device_extensions; //enabled only if the device supports them
+		uint32_t optional_device_extensions_count;
 		const char* window_name;
+		VkExtent2D extent; //of the window, or of the offscreen images in headless mode
+		bool headless; //no window, surface and swapchain, the frames are rendered into offscreen images
 		bool enable_validation_layers;
 		VkPhysicalDeviceFeatures device_features;
+		VkPhysicalDeviceFeatures optional_device_features; //enabled only if the device supports them
 	};
 }
\ No newline at end of file
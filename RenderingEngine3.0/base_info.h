@@ -5,6 +5,9 @@
 #include "const_swap_chain_image_count.h"
 
 #include "enum_queue.h"
+#include "enum_memory_type.h"
+
+#include <mutex>
 
 namespace rcq
 {
@@ -12,10 +15,17 @@ namespace rcq
 	{
 		VkPhysicalDevice physical_device;
 		VkDevice device;
+		VkImage swapchain_images[SWAP_CHAIN_IMAGE_COUNT]; //offscreen images in headless mode
 		VkImageView swapchain_views[SWAP_CHAIN_IMAGE_COUNT];
-		VkSwapchainKHR swapchain;
+		VkSwapchainKHR swapchain; //null in headless mode
+		VkExtent2D extent;
+		bool headless;
 		uint32_t queue_family_index;
 		VkQueue queues[QUEUE_COUNT];
-		GLFWwindow* window;
+		std::mutex* queue_mutexes[QUEUE_COUNT]; //locked while using the queue, the roles sharing a queue share the mutex
+		GLFWwindow* window; //null in headless mode
+		VkPhysicalDeviceFeatures enabled_features;
+		uint32_t memory_types[MEMORY_TYPE_COUNT]; //memory type index of every role
+		bool dedicated_allocation; //VK_KHR_get_memory_requirements2 and VK_KHR_dedicated_allocation are enabled
 	};
 }
\ No newline at end of file
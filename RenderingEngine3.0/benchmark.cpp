@@ -0,0 +1,198 @@
+#include "benchmark.h"
+
+#include <fstream>
+#include <sstream>
+#include <string>
+#include <algorithm>
+#include <iostream>
+#include <math.h>
+
+bool benchmark::load(const char* filename)
+{
+	std::ifstream file(filename);
+	if (!file)
+		return false;
+
+	std::string line;
+	uint32_t line_index = 0;
+	while (std::getline(file, line))
+	{
+		++line_index;
+		line = line.substr(0, line.find('#'));
+		std::istringstream in(line);
+		std::string command;
+		if (!(in >> command))
+			continue;
+
+		if (command == "frames")
+			in >> m_frame_count;
+		else if (command == "warmup")
+			in >> m_warmup_frame_count;
+		else if (command == "dt")
+			in >> m_dt;
+		else if (command == "objects")
+			in >> m_object_count;
+		else if (command == "seed")
+			in >> m_seed;
+		else if (command == "camera")
+		{
+			camera_key key;
+			in >> key.time >> key.pos.x >> key.pos.y >> key.pos.z >> key.look_dir.x >> key.look_dir.y >> key.look_dir.z;
+			m_camera_keys.push_back(key);
+		}
+		else if (command == "light")
+		{
+			light_key key;
+			in >> key.time >> key.dir.x >> key.dir.y >> key.dir.z;
+			m_light_keys.push_back(key);
+		}
+		else
+			in.setstate(std::ios::failbit);
+
+		if (in.fail())
+		{
+			std::cerr << filename << ':' << line_index << ": invalid command\n";
+			return false;
+		}
+	}
+
+	auto by_time = [](const auto& a, const auto& b) { return a.time < b.time; };
+	std::stable_sort(m_camera_keys.begin(), m_camera_keys.end(), by_time);
+	std::stable_sort(m_light_keys.begin(), m_light_keys.end(), by_time);
+	return m_frame_count > 0 && m_dt > 0.f;
+}
+
+//k0 and k1 are the keys around time, t is the weight of k1, the keys are clamped at the ends
+template<typename key>
+void benchmark::find_keys(const std::vector<key>& keys, float time, const key*& k0, const key*& k1, float& t)
+{
+	auto next = std::upper_bound(keys.begin(), keys.end(), time, [](float time, const key& k) { return time < k.time; });
+	if (next == keys.begin())
+	{
+		k0 = k1 = &keys.front();
+		t = 0.f;
+	}
+	else if (next == keys.end())
+	{
+		k0 = k1 = &keys.back();
+		t = 0.f;
+	}
+	else
+	{
+		k0 = &*(next - 1);
+		k1 = &*next;
+		t = (time - k0->time) / (k1->time - k0->time);
+	}
+}
+
+void benchmark::run(scene& sc)
+{
+	sc.add_procedural_objects(m_object_count, m_seed);
+
+	m_frame_times.clear();
+	m_gpu_frame_times.clear();
+	for (auto& times : m_pass_times)
+		times.clear();
+
+	uint64_t last_gpu_frame = rcq_user::get_gpu_pass_times().frame_index;
+	rcq_user::timer t;
+	for (uint32_t i = 0; i < m_warmup_frame_count + m_frame_count; ++i)
+	{
+		float time = i*m_dt;
+		if (!m_camera_keys.empty())
+		{
+			const camera_key* k0;
+			const camera_key* k1;
+			float w;
+			find_keys(m_camera_keys, time, k0, k1, w);
+			sc.set_camera(glm::mix(k0->pos, k1->pos, w), glm::mix(k0->look_dir, k1->look_dir, w));
+		}
+		if (!m_light_keys.empty())
+		{
+			const light_key* k0;
+			const light_key* k1;
+			float w;
+			find_keys(m_light_keys, time, k0, k1, w);
+			sc.set_light_dir(glm::mix(k0->dir, k1->dir, w));
+		}
+
+		t.start();
+		sc.update(m_dt);
+		t.stop();
+
+		if (i < m_warmup_frame_count)
+			continue;
+
+		m_frame_times.push_back(t.get()*1000.f);
+
+		//the gpu times lag behind, a finished frame is taken once
+		auto gpu_times = rcq_user::get_gpu_pass_times();
+		if (gpu_times.frame_index == last_gpu_frame)
+			continue;
+		last_gpu_frame = gpu_times.frame_index;
+		if (gpu_times.frame_time >= 0.f)
+			m_gpu_frame_times.push_back(gpu_times.frame_time);
+		for (uint32_t p = 0; p < rcq_user::gpu_pass::count; ++p)
+		{
+			if (gpu_times.pass_times[p] >= 0.f)
+				m_pass_times[p].push_back(gpu_times.pass_times[p]);
+		}
+	}
+}
+
+//nearest rank, times has to be sorted
+static float percentile(const std::vector<float>& times, float p)
+{
+	size_t rank = static_cast<size_t>(ceilf(p / 100.f*times.size()));
+	return times[rank == 0 ? 0 : rank - 1];
+}
+
+static void write_stats(std::ofstream& file, std::vector<float> times)
+{
+	if (times.empty())
+	{
+		file << "{ \"samples\": 0 }";
+		return;
+	}
+
+	std::sort(times.begin(), times.end());
+	double sum = 0.0;
+	for (float t : times)
+		sum += t;
+
+	file << "{ \"samples\": " << times.size()
+		<< ", \"mean\": " << sum / times.size()
+		<< ", \"p50\": " << percentile(times, 50.f)
+		<< ", \"p90\": " << percentile(times, 90.f)
+		<< ", \"p95\": " << percentile(times, 95.f)
+		<< ", \"p99\": " << percentile(times, 99.f)
+		<< ", \"max\": " << times.back() << " }";
+}
+
+bool benchmark::save_report(const char* filename) const
+{
+	std::ofstream file(filename);
+	if (!file)
+		return false;
+
+	file << "{\n";
+	file << "\t\"frames\": " << m_frame_count << ",\n";
+	file << "\t\"warmup\": " << m_warmup_frame_count << ",\n";
+	file << "\t\"dt\": " << m_dt << ",\n";
+	file << "\t\"objects\": " << m_object_count << ",\n";
+	file << "\t\"seed\": " << m_seed << ",\n";
+	file << "\t\"frame_time_ms\": ";
+	write_stats(file, m_frame_times);
+	file << ",\n\t\"gpu_frame_time_ms\": ";
+	write_stats(file, m_gpu_frame_times);
+	file << ",\n\t\"gpu_pass_times_ms\":\n\t{\n";
+	for (uint32_t p = 0; p < rcq_user::gpu_pass::count; ++p)
+	{
+		file << "\t\t\"" << rcq_user::get_gpu_pass_name(p) << "\": ";
+		write_stats(file, m_pass_times[p]);
+		file << (p + 1 == rcq_user::gpu_pass::count ? "\n" : ",\n");
+	}
+	file << "\t}\n}\n";
+
+	return static_cast<bool>(file);
+}
\ No newline at end of file
@@ -0,0 +1,57 @@
+#pragma once
+
+#include "scene.h"
+
+#include <vector>
+
+//a scripted run of the scene, the camera and the light follow keyframes and the simulation uses a fixed time step,
+//so every run renders the same frames
+//description file, one command per line, # starts a comment:
+//	frames <count>
+//	warmup <count>
+//	dt <seconds>
+//	objects <count>
+//	seed <seed>
+//	camera <time> <pos x y z> <look dir x y z>
+//	light <time> <dir x y z>
+class benchmark
+{
+public:
+	bool load(const char* filename);
+
+	//the procedural objects are added before the first frame
+	void run(scene& sc);
+
+	//frame time percentiles and per pass gpu times in json
+	bool save_report(const char* filename) const;
+
+private:
+	struct camera_key
+	{
+		float time;
+		glm::vec3 pos;
+		glm::vec3 look_dir;
+	};
+
+	struct light_key
+	{
+		float time;
+		glm::vec3 dir;
+	};
+
+	template<typename key>
+	static void find_keys(const std::vector<key>& keys, float time, const key*& k0, const key*& k1, float& t);
+
+	uint32_t m_frame_count = 1000;
+	uint32_t m_warmup_frame_count = 100;
+	float m_dt = 1.f / 60.f;
+	uint32_t m_object_count = 0;
+	uint32_t m_seed = 0;
+	std::vector<camera_key> m_camera_keys;
+	std::vector<light_key> m_light_keys;
+
+	//ms, of the measured frames
+	std::vector<float> m_frame_times;
+	std::vector<float> m_gpu_frame_times;
+	std::vector<float> m_pass_times[rcq_user::gpu_pass::count];
+};
\ No newline at end of file
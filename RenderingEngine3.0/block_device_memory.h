@@ -0,0 +1,266 @@
+#pragma once
+
+#include <assert.h>
+#include <new>
+
+#include "freelist_device_memory.h"
+#include "vk_memory.h"
+#include "host_memory.h"
+
+#include "const_device_memory_max_block_count.h"
+
+namespace rcq
+{
+	//freelist blocks with their own VkDeviceMemory, a block is allocated if nothing fits in the others and freed if it gets empty
+	//the offsets carry the block index in their high bits, handle(p) and memory_offset(p) give what the resources are bound to
+	class block_device_memory : public device_memory
+	{
+	public:
+		static constexpr uint32_t BLOCK_INDEX_SHIFT = 40;
+
+		block_device_memory() {}
+
+		//a new block is refused if the live vkAllocateMemory count reached max_allocation_count, try_allocate returns false then
+		//heap_size is the size of the memory heap of the type, it is reported as the budget
+		void init(VkDevice device, uint32_t memory_type_index, VkDeviceSize block_size, VkDeviceSize alignment,
+			uint32_t max_allocation_count, VkDeviceSize heap_size, const vk_allocator* vk_alloc, host_memory* metadata_memory)
+		{
+			device_memory::init(alignment, device, nullptr, nullptr);
+
+			assert(alignof(block) <= metadata_memory->max_alignment());
+
+			m_memory_type_index = memory_type_index;
+			m_block_size = block_size;
+			m_max_allocation_count = max_allocation_count;
+			m_vk_alloc = vk_alloc;
+			m_metadata_memory = metadata_memory;
+			for (auto& b : m_blocks)
+				b = nullptr;
+
+			m_accounting.set_budget(heap_size);
+			uint32_t index = create_block(m_block_size);
+			assert(index != NO_BLOCK);
+		}
+
+		void reset()
+		{
+			for (uint32_t i = 0; i < DEVICE_MEMORY_MAX_BLOCK_COUNT; ++i)
+			{
+				if (m_blocks[i] != nullptr)
+					destroy_block(i);
+			}
+		}
+
+		~block_device_memory()
+		{}
+
+		//the memory and the offset in it to bind a resource allocated at p
+		VkDeviceMemory handle(VkDeviceSize p) const
+		{
+			return m_blocks[p >> BLOCK_INDEX_SHIFT]->memory.handle();
+		}
+
+		static VkDeviceSize memory_offset(VkDeviceSize p)
+		{
+			return p & ((VkDeviceSize(1) << BLOCK_INDEX_SHIFT) - 1);
+		}
+
+		VkDeviceSize allocate(VkDeviceSize size, VkDeviceSize alignment) override
+		{
+			VkDeviceSize p;
+			bool allocated = try_allocate(size, alignment, nullptr, p);
+			assert(allocated);
+			return p;
+		}
+
+		//first fit in block order, so the lower blocks are filled up and the higher ones get empty
+		//returns false if nothing fits and a new block is refused
+		bool try_allocate(VkDeviceSize size, VkDeviceSize alignment, const void* owner, VkDeviceSize& p)
+		{
+			for (block* b : m_blocks)
+			{
+				if (b != nullptr && allocate_in(b, size, alignment, owner, p))
+					return true;
+			}
+
+			//a resource larger than a block gets a block of its own size
+			VkDeviceSize block_size = align(size, m_max_alignment);
+			uint32_t index = create_block(block_size < m_block_size ? m_block_size : block_size);
+			if (index == NO_BLOCK)
+				return false;
+			bool fits = allocate_in(m_blocks[index], size, alignment, owner, p);
+			assert(fits);
+			return true;
+		}
+
+		void deallocate(VkDeviceSize p) override
+		{
+			uint32_t index = static_cast<uint32_t>(p >> BLOCK_INDEX_SHIFT);
+			uint64_t in_use = m_blocks[index]->freelist.stats().in_use;
+			m_blocks[index]->freelist.deallocate(p);
+			block_deallocated(index, in_use, 1);
+		}
+
+		//offsets must be sorted, the offsets of a block are freed with one walk
+		void deallocate(const VkDeviceSize* offsets, size_t count)
+		{
+			size_t i = 0;
+			while (i < count)
+			{
+				uint32_t index = static_cast<uint32_t>(offsets[i] >> BLOCK_INDEX_SHIFT);
+				size_t end = i + 1;
+				while (end < count && (offsets[end] >> BLOCK_INDEX_SHIFT) == index)
+					++end;
+
+				uint64_t in_use = m_blocks[index]->freelist.stats().in_use;
+				m_blocks[index]->freelist.deallocate(offsets + i, end - i);
+				block_deallocated(index, in_use, end - i);
+				i = end;
+			}
+		}
+
+		//the lowest free range that ends below limit, returns limit if there is none
+		VkDeviceSize allocate_below(VkDeviceSize size, VkDeviceSize alignment, VkDeviceSize limit, const void* owner)
+		{
+			uint32_t limit_index = static_cast<uint32_t>(limit >> BLOCK_INDEX_SHIFT);
+			for (uint32_t i = 0; i <= limit_index; ++i)
+			{
+				block* b = m_blocks[i];
+				if (b == nullptr)
+					continue;
+
+				uint64_t in_use = b->freelist.stats().in_use;
+				VkDeviceSize block_limit = i == limit_index ? limit : std::numeric_limits<VkDeviceSize>::max();
+				VkDeviceSize p = b->freelist.allocate_below(size, alignment, block_limit, owner);
+				if (p != block_limit)
+				{
+					block_allocated(b, in_use);
+					return p;
+				}
+			}
+			return limit;
+		}
+
+		//the owners of the allocations above the lowest free range from the highest address down, f returns false to stop
+		template<typename Callable>
+		void for_each_owner_above_free(Callable&& f)
+		{
+			VkDeviceSize lowest_free = std::numeric_limits<VkDeviceSize>::max();
+			uint32_t lowest_index = 0;
+			for (uint32_t i = 0; i < DEVICE_MEMORY_MAX_BLOCK_COUNT && lowest_free == std::numeric_limits<VkDeviceSize>::max(); ++i)
+			{
+				if (m_blocks[i] != nullptr)
+				{
+					lowest_free = m_blocks[i]->freelist.lowest_free();
+					lowest_index = i;
+				}
+			}
+
+			for (uint32_t i = DEVICE_MEMORY_MAX_BLOCK_COUNT; i-- > lowest_index;)
+			{
+				if (m_blocks[i] != nullptr && !m_blocks[i]->freelist.for_each_owner_above(lowest_free, f))
+					return;
+			}
+		}
+
+	private:
+		struct block
+		{
+			vk_memory memory;
+			freelist_device_memory freelist;
+		};
+
+		bool allocate_in(block* b, VkDeviceSize size, VkDeviceSize alignment, const void* owner, VkDeviceSize& p)
+		{
+			uint64_t in_use = b->freelist.stats().in_use;
+			if (!b->freelist.try_allocate(size, alignment, owner, p))
+				return false;
+			block_allocated(b, in_use);
+			return true;
+		}
+
+		//the stats of the heap follow the stats of the blocks, they are zero without RCQ_MEMORY_STATS
+		void block_allocated(block* b, uint64_t in_use)
+		{
+			m_accounting.allocated(b->freelist.stats().in_use - in_use);
+			account_free_blocks();
+		}
+
+		//an empty block is freed, the first one is kept to avoid reallocating it after every emptying
+		void block_deallocated(uint32_t index, uint64_t in_use, size_t count)
+		{
+			m_accounting.deallocated(in_use - m_blocks[index]->freelist.stats().in_use, count);
+			if (m_blocks[index]->freelist.unused() && index != lowest_block_index())
+				destroy_block(index);
+			account_free_blocks();
+		}
+
+		static constexpr uint32_t NO_BLOCK = ~0u;
+
+		//returns NO_BLOCK if the device allocation limit is reached or every block slot is used
+		uint32_t create_block(VkDeviceSize size)
+		{
+			if (vk_memory::allocation_count() >= m_max_allocation_count)
+				return NO_BLOCK;
+
+			uint32_t index = 0;
+			while (index < DEVICE_MEMORY_MAX_BLOCK_COUNT && m_blocks[index] != nullptr)
+				++index;
+			if (index == DEVICE_MEMORY_MAX_BLOCK_COUNT)
+				return NO_BLOCK;
+
+			block* b = new(reinterpret_cast<void*>(m_metadata_memory->allocate(sizeof(block), alignof(block)))) block;
+			b->memory.init(m_device, m_memory_type_index, m_vk_alloc, VkDeviceSize(index) << BLOCK_INDEX_SHIFT);
+			b->freelist.init(size, m_max_alignment, &b->memory, m_metadata_memory);
+			m_blocks[index] = b;
+
+			m_accounting.upstream_allocated(size);
+			return index;
+		}
+
+		void destroy_block(uint32_t index)
+		{
+			block* b = m_blocks[index];
+			VkDeviceSize size = b->memory.stats().capacity;
+			m_accounting.upstream_deallocated(size);
+
+			b->freelist.reset();
+			b->~block();
+			m_metadata_memory->deallocate(reinterpret_cast<size_t>(b));
+			m_blocks[index] = nullptr;
+		}
+
+		uint32_t lowest_block_index() const
+		{
+			uint32_t index = 0;
+			while (m_blocks[index] == nullptr)
+				++index;
+			return index;
+		}
+
+		//walks the blocks, only if the stats are kept
+		void account_free_blocks()
+		{
+#ifdef RCQ_MEMORY_STATS
+			VkDeviceSize largest = 0;
+			VkDeviceSize free = 0;
+			for (block* b : m_blocks)
+			{
+				if (b == nullptr)
+					continue;
+				memory_stats s = b->freelist.stats();
+				largest = s.largest_free_block > largest ? s.largest_free_block : largest;
+				free += s.capacity - s.in_use;
+			}
+			m_accounting.free_blocks(largest, free);
+#endif
+		}
+
+		block* m_blocks[DEVICE_MEMORY_MAX_BLOCK_COUNT];
+		uint32_t m_memory_type_index;
+		VkDeviceSize m_block_size;
+		uint32_t m_max_allocation_count;
+		const vk_allocator* m_vk_alloc;
+		host_memory* m_metadata_memory;
+	};
+}
\ No newline at end of file
@@ -0,0 +1,9 @@
+#pragma once
+
+#include <stdint.h>
+
+namespace rcq
+{
+	//bytes copied by the defragmentation in a frame
+	static constexpr uint64_t DEFRAGMENTATION_BYTE_BUDGET = 8 * 1024 * 1024;
+}
\ No newline at end of file
@@ -0,0 +1,9 @@
+#pragma once
+
+#include <stdint.h>
+
+namespace rcq
+{
+	//resources tried by the defragmentation in a frame for each device local memory
+	static constexpr uint32_t DEFRAGMENTATION_CANDIDATE_COUNT = 64;
+}
\ No newline at end of file
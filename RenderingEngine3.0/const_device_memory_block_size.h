@@ -0,0 +1,9 @@
+#pragma once
+
+#include <stdint.h>
+
+namespace rcq
+{
+	//bytes of a VkDeviceMemory block of the resource manager, larger resources get a block of their own size
+	static constexpr uint64_t DEVICE_MEMORY_BLOCK_SIZE = 256 * 1024 * 1024;
+}
\ No newline at end of file
@@ -0,0 +1,9 @@
+#pragma once
+
+#include <stdint.h>
+
+namespace rcq
+{
+	//VkDeviceMemory blocks of a block_device_memory
+	static constexpr uint32_t DEVICE_MEMORY_MAX_BLOCK_COUNT = 64;
+}
\ No newline at end of file
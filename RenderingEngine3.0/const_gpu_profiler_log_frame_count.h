@@ -0,0 +1,9 @@
+#pragma once
+
+#include <stdint.h>
+
+namespace rcq
+{
+	//frames kept in the rolling gpu profiler log
+	static constexpr uint32_t GPU_PROFILER_LOG_FRAME_COUNT = 512;
+}
\ No newline at end of file
@@ -0,0 +1,9 @@
+#pragma once
+
+#include <stdint.h>
+
+namespace rcq
+{
+	//memory resources the registry can hold at once
+	static constexpr uint32_t MEMORY_REGISTRY_CAPACITY = 64;
+}
\ No newline at end of file
@@ -0,0 +1,6 @@
+#pragma once
+
+namespace rcq
+{
+	static constexpr const char* PIPELINE_CACHE_FILENAME = "pipeline_cache.bin";
+}
\ No newline at end of file
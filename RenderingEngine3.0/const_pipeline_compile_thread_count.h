@@ -0,0 +1,8 @@
+#pragma once
+
+#include <stdint.h>
+
+namespace rcq
+{
+	static constexpr uint32_t PIPELINE_COMPILE_THREAD_COUNT = 4;
+}
\ No newline at end of file
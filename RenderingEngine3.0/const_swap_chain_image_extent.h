@@ -4,6 +4,7 @@
 
 namespace rcq
 {
+	//default extent of the window, the screen sized pipeline descriptions use it as a placeholder for the runtime one
 	static constexpr VkExtent2D SWAP_CHAIN_IMAGE_EXTENT =
 	{
 		1360,
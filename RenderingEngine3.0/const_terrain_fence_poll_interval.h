@@ -0,0 +1,9 @@
+#pragma once
+
+#include <chrono>
+
+namespace rcq
+{
+	//the terrain loader checks the fences of the batches in flight this often while it waits for requests
+	static constexpr std::chrono::microseconds TERRAIN_FENCE_POLL_INTERVAL(500);
+}
\ No newline at end of file
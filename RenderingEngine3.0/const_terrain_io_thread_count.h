@@ -0,0 +1,9 @@
+#pragma once
+
+#include <stdint.h>
+
+namespace rcq
+{
+	//threads issuing terrain page reads, the terrain loader thread is one of them
+	static constexpr uint32_t TERRAIN_IO_THREAD_COUNT = 4;
+}
\ No newline at end of file
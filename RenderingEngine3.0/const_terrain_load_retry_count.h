@@ -0,0 +1,9 @@
+#pragma once
+
+#include <stdint.h>
+
+namespace rcq
+{
+	//failed reads of a tile level before its load is dropped, the shader requests the level again later
+	static constexpr uint32_t TERRAIN_LOAD_RETRY_COUNT = 3;
+}
\ No newline at end of file
@@ -0,0 +1,9 @@
+#pragma once
+
+#include <stdint.h>
+
+namespace rcq
+{
+	//batches of tile loads, one is gathered while the others are in flight, they share the streaming slots
+	static constexpr uint32_t TERRAIN_STREAMING_BATCH_COUNT = 2;
+}
\ No newline at end of file
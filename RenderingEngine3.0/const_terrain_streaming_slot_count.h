@@ -0,0 +1,9 @@
+#pragma once
+
+#include <stdint.h>
+
+namespace rcq
+{
+	//tile loads in flight on the terrain loader queue, each has its own staging area
+	static constexpr uint32_t TERRAIN_STREAMING_SLOT_COUNT = 8;
+}
\ No newline at end of file
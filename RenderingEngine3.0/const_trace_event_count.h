@@ -0,0 +1,9 @@
+#pragma once
+
+#include <stdint.h>
+
+namespace rcq
+{
+	//events kept per thread by the tracer, the oldest ones are overwritten, power of 2
+	static constexpr uint32_t TRACE_EVENT_COUNT = 8192;
+}
\ No newline at end of file
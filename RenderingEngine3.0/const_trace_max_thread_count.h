@@ -0,0 +1,9 @@
+#pragma once
+
+#include <stdint.h>
+
+namespace rcq
+{
+	//threads that can emit trace events, the ones above it are not traced
+	static constexpr uint32_t TRACE_MAX_THREAD_COUNT = 32;
+}
\ No newline at end of file
@@ -4,5 +4,6 @@
 
 namespace rcq
 {
-	constexpr uint32_t WATER_GRID_SIZE = 1024;
+	//size of the noise files and the largest grid the fft shader supports
+	static constexpr uint32_t MAX_WATER_GRID_SIZE = 1024;
 }
\ No newline at end of file
@@ -0,0 +1,9 @@
+#pragma once
+
+#include <stdint.h>
+
+namespace rcq
+{
+	//must divide WATER_GRID_SIZE_256/8, every thread transforms a whole number of simd lanes
+	static constexpr uint32_t WATER_SIMULATION_THREAD_COUNT = 4;
+}
\ No newline at end of file
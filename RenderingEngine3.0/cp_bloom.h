@@ -1,6 +1,8 @@
 #pragma once
 
 #include "cp_create_info.h"
+#include "shader_code.h"
+#include "shaders/bloom_blur/comp.h"
 #include <array>
 
 namespace rcq
@@ -8,7 +10,7 @@ namespace rcq
 	template<>
 	struct cp_create_info<CP_BLOOM>
 	{
-		static constexpr const char* shader_filename = "shaders/bloom_blur/comp.spv";
+		static constexpr shader_code shader = { spirv_bloom_blur_comp, sizeof(spirv_bloom_blur_comp) };
 		static constexpr std::array<DSL_TYPE, 0> dsl_types = {};
 		static constexpr std::array<VkPushConstantRange, 1> push_consts =
 		{
@@ -1,6 +1,8 @@
 #pragma once
 
 #include "cp_create_info.h"
+#include "shader_code.h"
+#include "shaders/terrain_page_request/comp.h"
 #include <array>
 
 namespace rcq
@@ -8,7 +10,7 @@ namespace rcq
 	template<>
 	struct cp_create_info<CP_TERRAIN_TILE_REQUEST>
 	{
-		static constexpr const char* shader_filename = "shaders/terrain_page_request/comp.spv";
+		static constexpr shader_code shader = { spirv_terrain_page_request_comp, sizeof(spirv_terrain_page_request_comp) };
 		static constexpr std::array<DSL_TYPE, 1> dsl_types =
 		{
 			DSL_TYPE_TERRAIN_COMPUTE
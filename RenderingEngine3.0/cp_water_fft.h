@@ -1,6 +1,8 @@
 #pragma once
 
 #include "cp_create_info.h"
+#include "shader_code.h"
+#include "shaders/water_compute/comp.h"
 #include <array>
 
 namespace rcq
@@ -8,7 +10,7 @@ namespace rcq
 	template<>
 	struct cp_create_info<CP_WATER_FFT>
 	{
-		static constexpr const char* shader_filename = "shaders/water_compute/comp.spv";
+		static constexpr shader_code shader = { spirv_water_compute_comp, sizeof(spirv_water_compute_comp) };
 		static constexpr std::array<DSL_TYPE, 1> dsl_types =
 		{
 			DSL_TYPE_WATER_COMPUTE
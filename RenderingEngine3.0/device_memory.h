@@ -1,6 +1,7 @@
 #pragma once
 
 #include "vulkan.h"
+#include "memory_accounting.h"
 
 namespace rcq
 {
@@ -62,6 +63,11 @@ namespace rcq
 			return m_upstream;
 		}
 
+		memory_stats stats() const
+		{
+			return m_accounting.stats();
+		}
+
 	protected:
 
 		void init(VkDeviceSize max_alignment, VkDevice device, const VkDeviceMemory* handle, device_memory* upstream)
@@ -76,5 +82,6 @@ namespace rcq
 		VkDeviceSize m_max_alignment;
 		const VkDeviceMemory* m_handle;
 		VkDevice m_device;
+		memory_accounting m_accounting;
 	};
 }
\ No newline at end of file
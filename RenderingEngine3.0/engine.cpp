@@ -1,30 +1,46 @@
 #include "engine.h"
 
+#include "memory_registry.h"
+
 using namespace rcq;
 
 engine* engine::m_instance = nullptr;
 
 engine::engine(const base_info& info) : m_base(info)
 {
+	RCQ_TRACE_THREAD_NAME("render");
+
 	create_memory_resources_and_containers();
 	create_render_passes();
+	create_pipeline_cache();
+
+	//pipelines compile on worker threads, while the rest of the engine and the first resource builds proceed
+	m_pipeline_creation_timer.start();
 	create_graphics_pipelines();
 	create_compute_pipelines();
+	start_pipeline_compilation();
+
 	create_buffers_and_images();
 	create_samplers();
 	create_descriptor_pool();
 	allocate_and_update_dss();
 	create_framebuffers();
-	allocate_and_record_cbs();
 	create_sync_objects();
+	m_gpu_profiler.init(m_base, m_vk_alloc);
+	m_image_index = SWAP_CHAIN_IMAGE_COUNT - 1;
 }
 
 
 engine::~engine()
 {
-	vkQueueWaitIdle(m_base.queues[QUEUE_RENDER]);
-	vkQueueWaitIdle(m_base.queues[QUEUE_COMPUTE]);
-	vkQueueWaitIdle(m_base.queues[QUEUE_PRESENT]);
+	if (!m_pipelines_ready)
+		finish_pipeline_creation();
+
+	for (auto q : { QUEUE_RENDER, QUEUE_COMPUTE, QUEUE_PRESENT })
+	{
+		std::lock_guard<std::mutex> lock(*m_base.queue_mutexes[q]);
+		vkQueueWaitIdle(m_base.queues[q]);
+	}
 
 	assert(m_opaque_objects.size() == 0);
 
@@ -36,6 +52,7 @@ engine::~engine()
 		vkDestroyFence(m_base.device, f, m_vk_alloc);
 	for (auto& e : m_events)
 		vkDestroyEvent(m_base.device, e, m_vk_alloc);
+	m_gpu_profiler.destroy(m_vk_alloc);
 	for (auto& fb : m_fbs)
 		vkDestroyFramebuffer(m_base.device, fb, m_vk_alloc);
 	for(auto& fb : m_postprocessing_fbs)
@@ -44,16 +61,18 @@ engine::~engine()
 		vkDestroyCommandPool(m_base.device, cp, m_vk_alloc);
 	for (auto& gp : m_gps)
 	{
-		vkDestroyPipeline(m_base.device, gp.ppl, m_vk_alloc);
+		vkDestroyPipeline(m_base.device, gp.ppl, m_pipeline_vk_alloc);
 		vkDestroyPipelineLayout(m_base.device, gp.pl, m_vk_alloc);
 		vkDestroyDescriptorSetLayout(m_base.device, gp.dsl, m_vk_alloc);
 	}
 	for (auto& cp : m_cps)
 	{
-		vkDestroyPipeline(m_base.device, cp.ppl, m_vk_alloc);
+		vkDestroyPipeline(m_base.device, cp.ppl, m_pipeline_vk_alloc);
 		vkDestroyPipelineLayout(m_base.device, cp.pl, m_vk_alloc);
 		vkDestroyDescriptorSetLayout(m_base.device, cp.dsl, m_vk_alloc);
 	}
+	save_pipeline_cache();
+	vkDestroyPipelineCache(m_base.device, m_pipeline_cache, m_pipeline_vk_alloc);
 	for (auto& rp : m_rps)
 		vkDestroyRenderPass(m_base.device, rp, m_vk_alloc);
 	for (auto& s : m_samplers)
@@ -62,16 +81,20 @@ engine::~engine()
 	{
 		vkDestroyImageView(m_base.device, im.view, m_vk_alloc);
 		vkDestroyImage(m_base.device, im.image, m_vk_alloc);
+		if (im.memory == nullptr)
+			im.dedicated_memory.deallocate(0);
 	}
 	vkDestroyBuffer(m_base.device, m_res_data.staging_buffer, m_vk_alloc);
 	vkDestroyBuffer(m_base.device, m_res_data.buffer, m_vk_alloc);
 
 	vkDestroyDescriptorPool(m_base.device, m_dp, m_vk_alloc);
 
+	memory_registry::remove_owner("engine");
 	m_opaque_objects.reset();
 	m_mappable_memory.reset();
 	m_dl1_memory.reset();
 	m_dl0_memory.reset();
+	m_pipeline_host_memory.reset();
 	m_host_memory.reset();
 }
 
@@ -3,6 +3,7 @@
 #include "vk_memory.h"
 #include "vk_allocator.h"
 #include "freelist_host_memory.h"
+#include "synchronized_host_memory.h"
 #include "monotonic_buffer_device_memory.h"
 
 #include "slot_map.h"
@@ -14,9 +15,13 @@
 #include "pipeline.h"
 #include "base_info.h"
 #include "render_settings.h"
+#include "timer.h"
+#include "gpu_profiler.h"
+#include "trace.h"
 
 #include "const_frustum_split_count.h"
 #include "const_swap_chain_image_count.h"
+#include "const_pipeline_compile_thread_count.h"
 
 #include "enum_rp.h"
 #include "enum_cp.h"
@@ -32,6 +37,7 @@
 #include "enum_cpool.h"
 #include "enum_memory_type.h"
 
+#include <thread>
 
 namespace rcq
 {
@@ -44,6 +50,11 @@ namespace rcq
 
 		void render()
 		{
+			RCQ_TRACE_SCOPE("engine::render");
+
+			if (!m_pipelines_ready)
+				finish_pipeline_creation();
+
 			calc_projs();
 			process_render_settings();
 			record_and_submit();
@@ -102,6 +113,24 @@ namespace rcq
 			m_water_valid = false;
 		}
 
+		const gpu_pass_times& get_gpu_pass_times()
+		{
+			return m_gpu_profiler.last_frame();
+		}
+
+		const gpu_draw_statistics& get_gpu_draw_statistics()
+		{
+			return m_gpu_profiler.last_draw_statistics();
+		}
+
+		bool save_gpu_profiler_log(const char* filename)
+		{
+			return m_gpu_profiler.save_log(filename);
+		}
+
+		//binary ppm of the last rendered offscreen image, headless mode only
+		bool save_frame(const char* filename);
+
 	private:
 
 		//ctor, dtor, singleton pattern
@@ -116,9 +145,11 @@ namespace rcq
 		//create functions
 		void create_memory_resources_and_containers();
 		void create_render_passes();
+		void create_pipeline_cache();
 		void create_graphics_pipelines();
 		void create_compute_pipelines();
 		void create_buffers_and_images();
+		void bind_image_memory(res_image& im, VkImageUsageFlags usage);
 		void allocate_and_record_cbs();
 		void allocate_and_update_dss();
 		void create_descriptor_pool();
@@ -126,6 +157,15 @@ namespace rcq
 		void create_framebuffers();
 		void create_sync_objects();
 
+		//pipeline cache persistence
+		void report_pipeline_creation_time(float creation_time);
+		void save_pipeline_cache();
+
+		//parallel pipeline compilation
+		void start_pipeline_compilation();
+		void compile_pipelines(uint32_t thread_index);
+		void finish_pipeline_creation();
+
 		//base info
 		const base_info& m_base;
 
@@ -133,12 +173,31 @@ namespace rcq
 		void calc_projs();
 		void process_render_settings();
 		void record_and_submit();
+		void defragment_resources();
 		
 		//render passes, graphics and compute pipelines
 		VkRenderPass m_rps[RP_COUNT];
 		pipeline m_gps[GP_COUNT];
 		pipeline m_cps[CP_COUNT];
 
+		//pipeline cache
+		VkPipelineCache m_pipeline_cache;
+		bool m_pipeline_cache_loaded;
+		float m_cold_pipeline_creation_time;
+
+		//parallel pipeline compilation
+		VkGraphicsPipelineCreateInfo m_gp_create_infos[GP_COUNT];
+		VkPipelineShaderStageCreateInfo m_gp_shaders[GP_COUNT * 3];
+		uint32_t m_gp_shader_count;
+		VkViewport m_gp_viewports[GP_COUNT];
+		VkRect2D m_gp_scissors[GP_COUNT];
+		VkPipelineViewportStateCreateInfo m_gp_viewport_states[GP_COUNT];
+		VkComputePipelineCreateInfo m_cp_create_infos[CP_COUNT];
+		std::thread m_pipeline_compile_threads[PIPELINE_COMPILE_THREAD_COUNT];
+		std::atomic<uint32_t> m_running_pipeline_compile_threads;
+		timer m_pipeline_creation_timer;
+		bool m_pipelines_ready;
+
 		//command pools
 		VkCommandPool m_cpools[CPOOL_COUNT];
 
@@ -150,10 +209,14 @@ namespace rcq
 		//synchronization objects
 		VkSemaphore m_semaphores[SEMAPHORE_COUNT];
 		VkSemaphore m_present_ready_ss[SWAP_CHAIN_IMAGE_COUNT];
+		uint32_t m_image_index; //of the last submitted frame
 		VkFence m_fences[FENCE_COUNT];
 		VkEvent m_events[EVENT_COUNT];
 		std::atomic_bool m_render_dispatched;
 
+		//gpu timestamps
+		gpu_profiler m_gpu_profiler;
+
 		//framebuffers
 		VkFramebuffer m_fbs[FB_COUNT];
 		VkFramebuffer m_postprocessing_fbs[SWAP_CHAIN_IMAGE_COUNT];
@@ -167,6 +230,7 @@ namespace rcq
 		//resources
 		res_data m_res_data;
 		res_image m_res_image[RES_IMAGE_COUNT];
+		PFN_vkGetImageMemoryRequirements2KHR m_get_image_memory_requirements2; //null without dedicated allocations
 
 		//memory resources
 		freelist_host_memory m_host_memory;
@@ -177,6 +241,9 @@ namespace rcq
 		vk_memory m_vk_mappable_memory;
 		monotonic_buffer_device_memory m_mappable_memory;
 		vk_allocator m_vk_alloc;
+		freelist_host_memory m_pipeline_host_memory;
+		synchronized_host_memory m_synchronized_pipeline_host_memory;
+		vk_allocator m_pipeline_vk_alloc;
 
 		//renderables
 		slot_map<renderable<REND_TYPE_OPAQUE_OBJECT>> m_opaque_objects;
@@ -200,28 +267,24 @@ namespace rcq
 		template<uint32_t gp_id>
 		void prepare_gp_create_info(VkGraphicsPipelineCreateInfo& create_info, VkPipelineLayoutCreateInfo& layout,
 			VkPipelineShaderStageCreateInfo* shaders, VkShaderModuleCreateInfo* shader_modules, uint32_t& shader_index,
-			VkDescriptorSetLayout* dsls, uint32_t& dsl_index,
-			char* code, uint32_t& code_index);
+			VkDescriptorSetLayout* dsls, uint32_t& dsl_index);
 
 		template<uint32_t... gp_ids>
 		void prepare_gp_create_infos(std::index_sequence<gp_ids...>, 
 			VkGraphicsPipelineCreateInfo* create_infos, VkPipelineLayoutCreateInfo* layouts,
 			VkPipelineShaderStageCreateInfo* shaders, VkShaderModuleCreateInfo* shader_modules, uint32_t& shader_index,
-			VkDescriptorSetLayout* dsls, uint32_t& dsl_index,
-			char* code, uint32_t& code_index);
+			VkDescriptorSetLayout* dsls, uint32_t& dsl_index);
 
 		template<uint32_t cp_id>
 		void prepare_cp_create_info(VkComputePipelineCreateInfo& create_info, VkPipelineLayoutCreateInfo& layout, 
 			VkShaderModuleCreateInfo& shader_module,
-			VkDescriptorSetLayout* dsls, uint32_t& dsl_index,
-			char* code, uint32_t& code_index);
+			VkDescriptorSetLayout* dsls, uint32_t& dsl_index);
 
 		template<uint32_t... cp_ids>
 		void prepare_cp_create_infos(std::index_sequence<cp_ids...>,
 			VkComputePipelineCreateInfo* create_infos, VkPipelineLayoutCreateInfo* layouts,
 			VkShaderModuleCreateInfo* shader_modules,
-			VkDescriptorSetLayout* dsls, uint32_t& dsl_index,
-			char* code, uint32_t& code_index);
+			VkDescriptorSetLayout* dsls, uint32_t& dsl_index);
 
 		template<uint32_t rp_type>
 		void create_render_pass_impl(VkRenderPass* rp);
@@ -231,9 +294,9 @@ namespace rcq
 
 		monotonic_buffer_device_memory* find_device_local_memory(uint32_t mem_type_index)
 		{
-			if (((1 << MEMORY_TYPE_DL0) & mem_type_index) != 0)
+			if (((1 << m_base.memory_types[MEMORY_TYPE_DL0]) & mem_type_index) != 0)
 				return &m_dl0_memory;
-			if (((1 << MEMORY_TYPE_DL1) & mem_type_index) != 0)
+			if (((1 << m_base.memory_types[MEMORY_TYPE_DL1]) & mem_type_index) != 0)
 				return &m_dl1_memory;
 			assert(false);
 			return nullptr;
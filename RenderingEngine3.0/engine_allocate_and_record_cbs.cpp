@@ -6,7 +6,6 @@
 #include "enum_res_image.h"
 
 #include "const_swap_chain_image_count.h"
-#include "const_swap_chain_image_extent.h"
 #include "const_bloom_image_size_factor.h"
 
 using namespace rcq;
@@ -28,7 +27,7 @@ void engine::allocate_and_record_cbs()
 	/////////////////////////////////////////////////////////
 	//allocate
 
-	//render cb
+	//render cbs
 	{
 		VkCommandBufferAllocateInfo alloc = {};
 		alloc.sType = VK_STRUCTURE_TYPE_COMMAND_BUFFER_ALLOCATE_INFO;
@@ -36,7 +35,9 @@ void engine::allocate_and_record_cbs()
 		alloc.commandPool = m_cpools[CPOOL_GRAPHICS];
 		alloc.level = VK_COMMAND_BUFFER_LEVEL_PRIMARY;
 
+		assert(vkAllocateCommandBuffers(m_base.device, &alloc, &m_cbs[CB_RES_DATA_COPY]) == VK_SUCCESS);
 		assert(vkAllocateCommandBuffers(m_base.device, &alloc, &m_cbs[CB_RENDER]) == VK_SUCCESS);
+		assert(vkAllocateCommandBuffers(m_base.device, &alloc, &m_cbs[CB_RENDER_WATER]) == VK_SUCCESS);
 
 	}
 
@@ -86,19 +87,22 @@ void engine::allocate_and_record_cbs()
 		begin.sType = VK_STRUCTURE_TYPE_COMMAND_BUFFER_BEGIN_INFO;
 		begin.flags = VK_COMMAND_BUFFER_USAGE_SIMULTANEOUS_USE_BIT;
 		assert(vkBeginCommandBuffer(m_present_cbs[i], &begin) == VK_SUCCESS);
+		m_gpu_profiler.reset(m_present_cbs[i], GPU_TIMER_POSTPROCESSING);
+		m_gpu_profiler.begin(m_present_cbs[i], GPU_TIMER_POSTPROCESSING);
 
 		VkRenderPassBeginInfo pass = {};
 		pass.sType = VK_STRUCTURE_TYPE_RENDER_PASS_BEGIN_INFO;
 		pass.clearValueCount = 0;
 		pass.framebuffer = m_postprocessing_fbs[i];
 		pass.renderPass = m_rps[RP_POSTPROCESSING];
-		pass.renderArea.extent = SWAP_CHAIN_IMAGE_EXTENT;
+		pass.renderArea.extent = m_base.extent;
 		pass.renderArea.offset = { 0,0 };
 
 		vkCmdBeginRenderPass(m_present_cbs[i], &pass, VK_SUBPASS_CONTENTS_INLINE);
 		m_gps[GP_POSTPROCESSING].bind(m_present_cbs[i]);
 		vkCmdDraw(m_present_cbs[i], 4, 1, 0, 0);
 		vkCmdEndRenderPass(m_present_cbs[i]);
+		m_gpu_profiler.end(m_present_cbs[i], GPU_TIMER_POSTPROCESSING);
 
 		assert(vkEndCommandBuffer(m_present_cbs[i]) == VK_SUCCESS);
 	}
@@ -109,9 +113,11 @@ void engine::allocate_and_record_cbs()
 		begin.sType = VK_STRUCTURE_TYPE_COMMAND_BUFFER_BEGIN_INFO;
 		begin.flags = VK_COMMAND_BUFFER_USAGE_SIMULTANEOUS_USE_BIT;
 		assert(vkBeginCommandBuffer(m_cbs[CB_BLOOM], &begin) == VK_SUCCESS);
+		m_gpu_profiler.reset(m_cbs[CB_BLOOM], GPU_TIMER_BLOOM);
+		m_gpu_profiler.begin(m_cbs[CB_BLOOM], GPU_TIMER_BLOOM);
 
-		glm::ivec2 size = { SWAP_CHAIN_IMAGE_EXTENT.width / BLOOM_IMAGE_SIZE_FACTOR,
-			SWAP_CHAIN_IMAGE_EXTENT.height / BLOOM_IMAGE_SIZE_FACTOR };
+		glm::ivec2 size = { static_cast<int32_t>(m_base.extent.width / BLOOM_IMAGE_SIZE_FACTOR),
+			static_cast<int32_t>(m_base.extent.height / BLOOM_IMAGE_SIZE_FACTOR) };
 
 		m_cps[CP_BLOOM].bind(m_cbs[CB_BLOOM], VK_PIPELINE_BIND_POINT_COMPUTE);
 		uint32_t step = 0;
@@ -158,6 +164,7 @@ void engine::allocate_and_record_cbs()
 			vkCmdPipelineBarrier(m_cbs[CB_BLOOM], VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT, VK_PIPELINE_STAGE_FRAGMENT_SHADER_BIT,
 				0, 0, nullptr, 0, nullptr, 1, &b);
 		}
+		m_gpu_profiler.end(m_cbs[CB_BLOOM], GPU_TIMER_BLOOM);
 		assert(vkEndCommandBuffer(m_cbs[CB_BLOOM]) == VK_SUCCESS);
 	}
 }
\ No newline at end of file
@@ -0,0 +1,61 @@
+#include "engine.h"
+
+using namespace rcq;
+
+//transient attachments get lazily allocated memory if the device has it, images the driver wants alone get a dedicated allocation,
+//the others are suballocated from the device local memories
+void engine::bind_image_memory(res_image& im, VkImageUsageFlags usage)
+{
+	VkMemoryRequirements mr;
+	bool dedicated = false;
+	if (m_base.dedicated_allocation)
+	{
+		VkImageMemoryRequirementsInfo2KHR info = {};
+		info.sType = VK_STRUCTURE_TYPE_IMAGE_MEMORY_REQUIREMENTS_INFO_2_KHR;
+		info.image = im.image;
+
+		VkMemoryDedicatedRequirementsKHR dedicated_mr = {};
+		dedicated_mr.sType = VK_STRUCTURE_TYPE_MEMORY_DEDICATED_REQUIREMENTS_KHR;
+
+		VkMemoryRequirements2KHR mr2 = {};
+		mr2.sType = VK_STRUCTURE_TYPE_MEMORY_REQUIREMENTS_2_KHR;
+		mr2.pNext = &dedicated_mr;
+
+		m_get_image_memory_requirements2(m_base.device, &info, &mr2);
+		mr = mr2.memoryRequirements;
+		dedicated = dedicated_mr.prefersDedicatedAllocation == VK_TRUE || dedicated_mr.requiresDedicatedAllocation == VK_TRUE;
+	}
+	else
+		vkGetImageMemoryRequirements(m_base.device, im.image, &mr);
+
+	//without a lazily allocated type the lazy role is the dl1 type
+	uint32_t lazy_type = m_base.memory_types[MEMORY_TYPE_LAZY];
+	bool lazy = (usage & VK_IMAGE_USAGE_TRANSIENT_ATTACHMENT_BIT) != 0 && lazy_type != m_base.memory_types[MEMORY_TYPE_DL1] &&
+		((1 << lazy_type) & mr.memoryTypeBits) != 0;
+
+	if (!lazy && !dedicated)
+	{
+		im.memory = find_device_local_memory(mr.memoryTypeBits);
+		uint64_t offset = im.memory->allocate(mr.size, mr.alignment);
+		vkBindImageMemory(m_base.device, im.image, im.memory->handle(), offset);
+		return;
+	}
+
+	//the lazy type is checked against the requirements above, the others are tried as in find_device_local_memory
+	uint32_t type = lazy_type;
+	if (!lazy)
+	{
+		type = m_base.memory_types[MEMORY_TYPE_DL0];
+		if (((1 << type) & mr.memoryTypeBits) == 0)
+			type = m_base.memory_types[MEMORY_TYPE_DL1];
+	}
+	assert(((1 << type) & mr.memoryTypeBits) != 0);
+
+	im.memory = nullptr;
+	im.dedicated_memory.init(m_base.device, type, &m_vk_alloc);
+	if (dedicated)
+		im.dedicated_memory.allocate_dedicated(mr.size, im.image);
+	else
+		im.dedicated_memory.allocate(mr.size);
+	vkBindImageMemory(m_base.device, im.image, im.dedicated_memory.handle(), 0);
+}
\ No newline at end of file
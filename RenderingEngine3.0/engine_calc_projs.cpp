@@ -27,6 +27,8 @@ constexpr T componentwise_min(const T& v, const T& w)
 
 void engine::calc_projs()
 {
+	RCQ_TRACE_SCOPE("engine::calc_projs");
+
 	glm::vec3 light_dir = static_cast<glm::mat3>(m_render_settings.view)*m_render_settings.light_dir;
 	glm::mat4 light = glm::lookAtLH(glm::vec3(0.f), light_dir, glm::vec3(0.f, 1.f, 0.f));
 	std::array<std::array<glm::vec3, 4>, FRUSTUM_SPLIT_COUNT + 1> frustum_points;
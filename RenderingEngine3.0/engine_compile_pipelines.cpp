@@ -0,0 +1,79 @@
+#include "engine.h"
+
+using namespace rcq;
+
+void engine::start_pipeline_compilation()
+{
+	m_pipelines_ready = false;
+	m_running_pipeline_compile_threads.store(PIPELINE_COMPILE_THREAD_COUNT);
+
+	for (uint32_t i = 0; i < PIPELINE_COMPILE_THREAD_COUNT; ++i)
+	{
+		m_pipeline_compile_threads[i] = std::thread([this, i]()
+		{
+			compile_pipelines(i);
+		});
+	}
+}
+
+void engine::compile_pipelines(uint32_t thread_index)
+{
+	RCQ_TRACE_THREAD_NAME("pipeline compile");
+	RCQ_TRACE_SCOPE("engine::compile_pipelines");
+
+	//every pipeline is independent, so each thread compiles a contiguous range of the graphics pipelines
+	//and a contiguous range of the compute pipelines, the latter assigned in reverse order to balance the load
+	{
+		uint32_t begin = (GP_COUNT * thread_index) / PIPELINE_COMPILE_THREAD_COUNT;
+		uint32_t end = (GP_COUNT * (thread_index + 1)) / PIPELINE_COMPILE_THREAD_COUNT;
+
+		if (begin != end)
+		{
+			VkPipeline gps[GP_COUNT];
+			assert(vkCreateGraphicsPipelines(m_base.device, m_pipeline_cache, end - begin, m_gp_create_infos + begin,
+				m_pipeline_vk_alloc, gps) == VK_SUCCESS);
+
+			for (uint32_t i = begin; i < end; ++i)
+				m_gps[i].ppl = gps[i - begin];
+		}
+	}
+
+	{
+		uint32_t reversed_index = PIPELINE_COMPILE_THREAD_COUNT - 1 - thread_index;
+		uint32_t begin = (CP_COUNT * reversed_index) / PIPELINE_COMPILE_THREAD_COUNT;
+		uint32_t end = (CP_COUNT * (reversed_index + 1)) / PIPELINE_COMPILE_THREAD_COUNT;
+
+		if (begin != end)
+		{
+			VkPipeline cps[CP_COUNT];
+			assert(vkCreateComputePipelines(m_base.device, m_pipeline_cache, end - begin, m_cp_create_infos + begin,
+				m_pipeline_vk_alloc, cps) == VK_SUCCESS);
+
+			for (uint32_t i = begin; i < end; ++i)
+				m_cps[i].ppl = cps[i - begin];
+		}
+	}
+
+	//the last thread to finish stops the timer
+	if (m_running_pipeline_compile_threads.fetch_sub(1) == 1)
+		m_pipeline_creation_timer.stop();
+}
+
+void engine::finish_pipeline_creation()
+{
+	for (auto& t : m_pipeline_compile_threads)
+		t.join();
+
+	//destroy shader modules
+	for (uint32_t i = 0; i < m_gp_shader_count; ++i)
+		vkDestroyShaderModule(m_base.device, m_gp_shaders[i].module, m_vk_alloc);
+	for (uint32_t i = 0; i < CP_COUNT; ++i)
+		vkDestroyShaderModule(m_base.device, m_cp_create_infos[i].stage.module, m_vk_alloc);
+
+	report_pipeline_creation_time(m_pipeline_creation_timer.get());
+
+	//command buffers bind the pipelines, so they can only be recorded now
+	allocate_and_record_cbs();
+
+	m_pipelines_ready = true;
+}
\ No newline at end of file
@@ -6,7 +6,6 @@
 
 #include "const_environment_map_size.h"
 #include "const_dir_shadow_map_size.h"
-#include "const_swap_chain_image_extent.h"
 
 using namespace rcq;
 
@@ -67,8 +66,8 @@ void engine::create_framebuffers()
 		fb.sType = VK_STRUCTURE_TYPE_FRAMEBUFFER_CREATE_INFO;
 		fb.attachmentCount = ATT::ATT_COUNT;
 		fb.pAttachments = atts;
-		fb.height = SWAP_CHAIN_IMAGE_EXTENT.height;
-		fb.width = SWAP_CHAIN_IMAGE_EXTENT.width;
+		fb.height = m_base.extent.height;
+		fb.width = m_base.extent.width;
 		fb.layers = 1;
 		fb.renderPass = m_rps[RP_GBUFFER_ASSEMBLER];
 
@@ -86,8 +85,8 @@ void engine::create_framebuffers()
 		fb.sType = VK_STRUCTURE_TYPE_FRAMEBUFFER_CREATE_INFO;
 		fb.attachmentCount = ATT::ATT_COUNT;
 		fb.pAttachments = atts;
-		fb.height = SWAP_CHAIN_IMAGE_EXTENT.height;
-		fb.width = SWAP_CHAIN_IMAGE_EXTENT.width;
+		fb.height = m_base.extent.height;
+		fb.width = m_base.extent.width;
 		fb.layers = 1;
 		fb.renderPass = m_rps[RP_SSAO_MAP_GEN];
 
@@ -108,8 +107,8 @@ void engine::create_framebuffers()
 		fb.sType = VK_STRUCTURE_TYPE_FRAMEBUFFER_CREATE_INFO;
 		fb.attachmentCount = ATT::ATT_COUNT;
 		fb.pAttachments = atts;
-		fb.height = SWAP_CHAIN_IMAGE_EXTENT.height;
-		fb.width = SWAP_CHAIN_IMAGE_EXTENT.width;
+		fb.height = m_base.extent.height;
+		fb.width = m_base.extent.width;
 		fb.layers = 1;
 		fb.renderPass = m_rps[RP_PREIMAGE_ASSEMBLER];
 
@@ -128,8 +127,8 @@ void engine::create_framebuffers()
 		fb.sType = VK_STRUCTURE_TYPE_FRAMEBUFFER_CREATE_INFO;
 		fb.attachmentCount = ATT::ATT_COUNT;
 		fb.pAttachments = atts;
-		fb.height = SWAP_CHAIN_IMAGE_EXTENT.height;
-		fb.width = SWAP_CHAIN_IMAGE_EXTENT.width;
+		fb.height = m_base.extent.height;
+		fb.width = m_base.extent.width;
 		fb.layers = 1;
 		fb.renderPass = m_rps[RP_REFRACTION_IMAGE_GEN];
 
@@ -148,8 +147,8 @@ void engine::create_framebuffers()
 		fb.sType = VK_STRUCTURE_TYPE_FRAMEBUFFER_CREATE_INFO;
 		fb.attachmentCount = ATT::ATT_COUNT;
 		fb.pAttachments = atts;
-		fb.height = SWAP_CHAIN_IMAGE_EXTENT.height;
-		fb.width = SWAP_CHAIN_IMAGE_EXTENT.width;
+		fb.height = m_base.extent.height;
+		fb.width = m_base.extent.width;
 		fb.layers = 1;
 		fb.renderPass = m_rps[RP_WATER_DRAWER];
 
@@ -166,8 +165,8 @@ void engine::create_framebuffers()
 		fb.sType = VK_STRUCTURE_TYPE_FRAMEBUFFER_CREATE_INFO;
 		fb.attachmentCount = ATT::ATT_COUNT;
 		fb.pAttachments = atts;
-		fb.height = SWAP_CHAIN_IMAGE_EXTENT.height;
-		fb.width = SWAP_CHAIN_IMAGE_EXTENT.width;
+		fb.height = m_base.extent.height;
+		fb.width = m_base.extent.width;
 		fb.layers = 1;
 		fb.renderPass = m_rps[RP_POSTPROCESSING];
 
@@ -1,6 +1,7 @@
 #include "engine.h"
 
 #include "os_memory.h"
+#include "memory_registry.h"
 
 #include "utility.h"
 
@@ -14,15 +15,29 @@ void engine::create_memory_resources_and_containers()
 
 	m_vk_alloc.init(&m_host_memory);
 
-	m_vk_dl0_memory.init(m_base.device, MEMORY_TYPE_DL0, &m_vk_alloc);
-	m_vk_dl1_memory.init(m_base.device, MEMORY_TYPE_DL1, &m_vk_alloc);
+	//pipelines and the pipeline cache are created on the pipeline compile threads
+	m_pipeline_host_memory.init(64 * 1024 * 1024, MAX_ALIGNMENT, &OS_MEMORY);
+	m_synchronized_pipeline_host_memory.init(&m_pipeline_host_memory);
+	m_pipeline_vk_alloc.init(&m_synchronized_pipeline_host_memory);
+
+	m_vk_dl0_memory.init(m_base.device, m_base.memory_types[MEMORY_TYPE_DL0], &m_vk_alloc);
+	m_vk_dl1_memory.init(m_base.device, m_base.memory_types[MEMORY_TYPE_DL1], &m_vk_alloc);
 	m_dl0_memory.init(512 * 1024 * 1024, /*MAX_ALIGNMENT*/1024, &m_vk_dl0_memory, &m_host_memory);
 	m_dl1_memory.init(512 * 1024 * 1024, /*MAX_ALIGNMENT*/1024, &m_vk_dl1_memory, &m_host_memory);
 
-	m_vk_mappable_memory.init(m_base.device, MEMORY_TYPE_HVC, &m_vk_alloc);
+	m_vk_mappable_memory.init(m_base.device, m_base.memory_types[MEMORY_TYPE_HVC], &m_vk_alloc);
 
 	m_mappable_memory.init(1024 * 1024, /*MAX_ALIGNMENT*/1024, &m_vk_mappable_memory, &m_host_memory);
 
+	memory_registry::add("engine", "host_memory", &m_host_memory);
+	memory_registry::add("engine", "pipeline_host_memory", &m_pipeline_host_memory);
+	memory_registry::add("engine", "vk_dl0_memory", &m_vk_dl0_memory);
+	memory_registry::add("engine", "dl0_memory", &m_dl0_memory);
+	memory_registry::add("engine", "vk_dl1_memory", &m_vk_dl1_memory);
+	memory_registry::add("engine", "dl1_memory", &m_dl1_memory);
+	memory_registry::add("engine", "vk_mappable_memory", &m_vk_mappable_memory);
+	memory_registry::add("engine", "mappable_memory", &m_mappable_memory);
+
 	m_opaque_objects.init(64, &m_host_memory);
 	m_opaque_objects_changed = true;
 }
\ No newline at end of file
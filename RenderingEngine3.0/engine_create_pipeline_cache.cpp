@@ -0,0 +1,112 @@
+#include "engine.h"
+
+#include "vector.h"
+
+#include "const_pipeline_cache_filename.h"
+
+#include <fstream>
+#include <iostream>
+
+using namespace rcq;
+
+//the file starts with this header, followed by the data returned by vkGetPipelineCacheData
+struct pipeline_cache_file_header
+{
+	uint64_t data_size;
+	float cold_pipeline_creation_time;
+};
+
+static bool is_pipeline_cache_data_compatible(const char* data, size_t size, VkPhysicalDevice physical_device)
+{
+	//header layout: length, version, vendor id, device id, uuid
+	static constexpr size_t header_size = 4 * sizeof(uint32_t) + VK_UUID_SIZE;
+	if (size < header_size)
+		return false;
+
+	uint32_t header[4];
+	memcpy(header, data, sizeof(header));
+
+	VkPhysicalDeviceProperties props;
+	vkGetPhysicalDeviceProperties(physical_device, &props);
+
+	return header[0] >= header_size &&
+		header[1] == VK_PIPELINE_CACHE_HEADER_VERSION_ONE &&
+		header[2] == props.vendorID &&
+		header[3] == props.deviceID &&
+		memcmp(data + 4 * sizeof(uint32_t), props.pipelineCacheUUID, VK_UUID_SIZE) == 0;
+}
+
+void engine::create_pipeline_cache()
+{
+	m_pipeline_cache_loaded = false;
+	m_cold_pipeline_creation_time = 0.f;
+
+	vector<char> data(&m_host_memory);
+
+	//try to load previous cache
+	{
+		std::ifstream file(PIPELINE_CACHE_FILENAME, std::ios::ate | std::ios::binary);
+		if (file.is_open())
+		{
+			uint64_t file_size = static_cast<uint64_t>(file.tellg());
+			file.seekg(0);
+
+			pipeline_cache_file_header header;
+			file.read(reinterpret_cast<char*>(&header), sizeof(header));
+			if (file && header.data_size == file_size - sizeof(header))
+			{
+				data.resize(header.data_size);
+				file.read(data.data(), header.data_size);
+				if (file && is_pipeline_cache_data_compatible(data.data(), data.size(), m_base.physical_device))
+				{
+					m_pipeline_cache_loaded = true;
+					m_cold_pipeline_creation_time = header.cold_pipeline_creation_time;
+				}
+			}
+			file.close();
+		}
+	}
+
+	VkPipelineCacheCreateInfo create_info = {};
+	create_info.sType = VK_STRUCTURE_TYPE_PIPELINE_CACHE_CREATE_INFO;
+	create_info.initialDataSize = m_pipeline_cache_loaded ? data.size() : 0;
+	create_info.pInitialData = m_pipeline_cache_loaded ? data.data() : nullptr;
+
+	assert(vkCreatePipelineCache(m_base.device, &create_info, m_pipeline_vk_alloc, &m_pipeline_cache) == VK_SUCCESS);
+}
+
+void engine::report_pipeline_creation_time(float creation_time)
+{
+	if (m_pipeline_cache_loaded)
+	{
+		std::cout << "pipeline creation: " << creation_time * 1000.f << " ms with cache, " <<
+			m_cold_pipeline_creation_time * 1000.f << " ms without, saved " <<
+			(m_cold_pipeline_creation_time - creation_time) * 1000.f << " ms\n";
+	}
+	else
+	{
+		m_cold_pipeline_creation_time = creation_time;
+		std::cout << "pipeline creation: " << creation_time * 1000.f << " ms, no valid pipeline cache found\n";
+	}
+}
+
+void engine::save_pipeline_cache()
+{
+	size_t size;
+	assert(vkGetPipelineCacheData(m_base.device, m_pipeline_cache, &size, nullptr) == VK_SUCCESS);
+
+	vector<char> data(&m_host_memory, size);
+	assert(vkGetPipelineCacheData(m_base.device, m_pipeline_cache, &size, data.data()) == VK_SUCCESS);
+
+	std::ofstream file(PIPELINE_CACHE_FILENAME, std::ios::binary | std::ios::trunc);
+	if (!file.is_open())
+		return;
+
+	pipeline_cache_file_header header;
+	header.data_size = size;
+	header.cold_pipeline_creation_time = m_cold_pipeline_creation_time;
+
+	file.write(reinterpret_cast<const char*>(&header), sizeof(header));
+	file.write(data.data(), size);
+	file.close();
+}
\ No newline at end of file
@@ -10,6 +10,22 @@ void engine::create_render_pass_impl(VkRenderPass* rp)
 	assert(vkCreateRenderPass(m_base.device, &rp_create_info<rp_type>::create_info, m_vk_alloc, rp) == VK_SUCCESS);
 }
 
+//in headless mode the final image is read back instead of presented
+template<>
+void engine::create_render_pass_impl<RP_POSTPROCESSING>(VkRenderPass* rp)
+{
+	using info = rp_create_info<RP_POSTPROCESSING>;
+
+	auto atts = info::atts;
+	if (m_base.headless)
+		atts[info::ATT_SWAP_CHAIN_IMAGE].finalLayout = VK_IMAGE_LAYOUT_TRANSFER_SRC_OPTIMAL;
+
+	VkRenderPassCreateInfo create_info = info::create_info;
+	create_info.pAttachments = atts.data();
+
+	assert(vkCreateRenderPass(m_base.device, &create_info, m_vk_alloc, rp) == VK_SUCCESS);
+}
+
 template<uint32_t... rp_types>
 void engine::create_render_passes_impl(std::index_sequence<rp_types...>)
 {
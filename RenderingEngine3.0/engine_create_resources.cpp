@@ -2,13 +2,15 @@
 
 #include "const_dir_shadow_map_size.h"
 #include "const_environment_map_size.h"
-#include "const_swap_chain_image_extent.h"
 #include "const_bloom_image_size_factor.h"
 
 namespace rcq
 {
 	void engine::create_buffers_and_images()
 	{
+		m_get_image_memory_requirements2 = m_base.dedicated_allocation ? reinterpret_cast<PFN_vkGetImageMemoryRequirements2KHR>(
+			vkGetDeviceProcAddr(m_base.device, "vkGetImageMemoryRequirements2KHR")) : nullptr;
+
 		VkPhysicalDeviceProperties props;
 		vkGetPhysicalDeviceProperties(m_base.physical_device, &props);
 		size_t ub_alignment = static_cast<size_t>(props.limits.minUniformBufferOffsetAlignment);
@@ -67,18 +69,12 @@ namespace rcq
 			image.samples = VK_SAMPLE_COUNT_1_BIT;
 			image.sharingMode = VK_SHARING_MODE_EXCLUSIVE;
 			image.tiling = VK_IMAGE_TILING_OPTIMAL;
-			image.usage = VK_IMAGE_USAGE_DEPTH_STENCIL_ATTACHMENT_BIT;
+			image.usage = VK_IMAGE_USAGE_DEPTH_STENCIL_ATTACHMENT_BIT | VK_IMAGE_USAGE_TRANSIENT_ATTACHMENT_BIT;
 
 			assert(vkCreateImage(m_base.device, &image, m_vk_alloc, &m_res_image[RES_IMAGE_ENVIRONMENT_MAP_GEN_DEPTHSTENCIL].image)
 				== VK_SUCCESS);
 
-			VkMemoryRequirements mr;
-			vkGetImageMemoryRequirements(m_base.device, m_res_image[RES_IMAGE_ENVIRONMENT_MAP_GEN_DEPTHSTENCIL].image, &mr);
-			auto memory = find_device_local_memory(mr.memoryTypeBits);
-			m_res_image[RES_IMAGE_ENVIRONMENT_MAP_GEN_DEPTHSTENCIL].memory = memory;
-			uint64_t offset = memory->allocate(mr.size, mr.alignment);
-			vkBindImageMemory(m_base.device, m_res_image[RES_IMAGE_ENVIRONMENT_MAP_GEN_DEPTHSTENCIL].image, memory->handle(),
-				offset);
+			bind_image_memory(m_res_image[RES_IMAGE_ENVIRONMENT_MAP_GEN_DEPTHSTENCIL], image.usage);
 
 			VkImageViewCreateInfo view = {};
 			view.sType = VK_STRUCTURE_TYPE_IMAGE_VIEW_CREATE_INFO;
@@ -116,13 +112,7 @@ namespace rcq
 			assert(vkCreateImage(m_base.device, &image, m_vk_alloc, &m_res_image[RES_IMAGE_ENVIRONMENT_MAP].image)
 				== VK_SUCCESS);
 
-			VkMemoryRequirements mr;
-			vkGetImageMemoryRequirements(m_base.device, m_res_image[RES_IMAGE_ENVIRONMENT_MAP].image, &mr);
-			auto memory = find_device_local_memory(mr.memoryTypeBits);
-			m_res_image[RES_IMAGE_ENVIRONMENT_MAP].memory = memory;
-			uint64_t offset = memory->allocate(mr.size, mr.alignment);
-			vkBindImageMemory(m_base.device, m_res_image[RES_IMAGE_ENVIRONMENT_MAP].image, memory->handle(),
-				offset);
+			bind_image_memory(m_res_image[RES_IMAGE_ENVIRONMENT_MAP], image.usage);
 
 			VkImageViewCreateInfo view = {};
 			view.sType = VK_STRUCTURE_TYPE_IMAGE_VIEW_CREATE_INFO;
@@ -145,8 +135,8 @@ namespace rcq
 			image.sType = VK_STRUCTURE_TYPE_IMAGE_CREATE_INFO;
 			image.arrayLayers = 1;
 			image.extent.depth = 1;
-			image.extent.height = SWAP_CHAIN_IMAGE_EXTENT.height;
-			image.extent.width = SWAP_CHAIN_IMAGE_EXTENT.width;
+			image.extent.height = m_base.extent.height;
+			image.extent.width = m_base.extent.width;
 			image.format = VK_FORMAT_R32G32B32A32_SFLOAT;
 			image.imageType = VK_IMAGE_TYPE_2D;
 			image.initialLayout = VK_IMAGE_LAYOUT_UNDEFINED;
@@ -159,13 +149,7 @@ namespace rcq
 			assert(vkCreateImage(m_base.device, &image, m_vk_alloc, &m_res_image[RES_IMAGE_GB_POS_ROUGHNESS].image)
 				== VK_SUCCESS);
 
-			VkMemoryRequirements mr;
-			vkGetImageMemoryRequirements(m_base.device, m_res_image[RES_IMAGE_GB_POS_ROUGHNESS].image, &mr);
-			auto memory = find_device_local_memory(mr.memoryTypeBits);
-			m_res_image[RES_IMAGE_GB_POS_ROUGHNESS].memory = memory;
-			uint64_t offset = memory->allocate(mr.size, mr.alignment);
-			vkBindImageMemory(m_base.device, m_res_image[RES_IMAGE_GB_POS_ROUGHNESS].image, memory->handle(),
-				offset);
+			bind_image_memory(m_res_image[RES_IMAGE_GB_POS_ROUGHNESS], image.usage);
 
 			VkImageViewCreateInfo view = {};
 			view.sType = VK_STRUCTURE_TYPE_IMAGE_VIEW_CREATE_INFO;
@@ -188,8 +172,8 @@ namespace rcq
 			image.sType = VK_STRUCTURE_TYPE_IMAGE_CREATE_INFO;
 			image.arrayLayers = 1;
 			image.extent.depth = 1;
-			image.extent.height = SWAP_CHAIN_IMAGE_EXTENT.height;
-			image.extent.width = SWAP_CHAIN_IMAGE_EXTENT.width;
+			image.extent.height = m_base.extent.height;
+			image.extent.width = m_base.extent.width;
 			image.format = VK_FORMAT_R32G32B32A32_SFLOAT;
 			image.imageType = VK_IMAGE_TYPE_2D;
 			image.initialLayout = VK_IMAGE_LAYOUT_UNDEFINED;
@@ -202,13 +186,7 @@ namespace rcq
 			assert(vkCreateImage(m_base.device, &image, m_vk_alloc, &m_res_image[RES_IMAGE_GB_BASECOLOR_SSAO].image)
 				== VK_SUCCESS);
 
-			VkMemoryRequirements mr;
-			vkGetImageMemoryRequirements(m_base.device, m_res_image[RES_IMAGE_GB_BASECOLOR_SSAO].image, &mr);
-			auto memory = find_device_local_memory(mr.memoryTypeBits);
-			m_res_image[RES_IMAGE_GB_BASECOLOR_SSAO].memory = memory;
-			uint64_t offset = memory->allocate(mr.size, mr.alignment);
-			vkBindImageMemory(m_base.device, m_res_image[RES_IMAGE_GB_BASECOLOR_SSAO].image, memory->handle(),
-				offset);
+			bind_image_memory(m_res_image[RES_IMAGE_GB_BASECOLOR_SSAO], image.usage);
 
 			VkImageViewCreateInfo view = {};
 			view.sType = VK_STRUCTURE_TYPE_IMAGE_VIEW_CREATE_INFO;
@@ -231,8 +209,8 @@ namespace rcq
 			image.sType = VK_STRUCTURE_TYPE_IMAGE_CREATE_INFO;
 			image.arrayLayers = 1;
 			image.extent.depth = 1;
-			image.extent.height = SWAP_CHAIN_IMAGE_EXTENT.height;
-			image.extent.width = SWAP_CHAIN_IMAGE_EXTENT.width;
+			image.extent.height = m_base.extent.height;
+			image.extent.width = m_base.extent.width;
 			image.format = VK_FORMAT_R32G32B32A32_SFLOAT;
 			image.imageType = VK_IMAGE_TYPE_2D;
 			image.initialLayout = VK_IMAGE_LAYOUT_UNDEFINED;
@@ -245,13 +223,7 @@ namespace rcq
 			assert(vkCreateImage(m_base.device, &image, m_vk_alloc, &m_res_image[RES_IMAGE_GB_METALNESS_SSDS].image)
 				== VK_SUCCESS);
 
-			VkMemoryRequirements mr;
-			vkGetImageMemoryRequirements(m_base.device, m_res_image[RES_IMAGE_GB_METALNESS_SSDS].image, &mr);
-			auto memory = find_device_local_memory(mr.memoryTypeBits);
-			m_res_image[RES_IMAGE_GB_METALNESS_SSDS].memory = memory;
-			uint64_t offset = memory->allocate(mr.size, mr.alignment);
-			vkBindImageMemory(m_base.device, m_res_image[RES_IMAGE_GB_METALNESS_SSDS].image, memory->handle(),
-				offset);
+			bind_image_memory(m_res_image[RES_IMAGE_GB_METALNESS_SSDS], image.usage);
 
 			VkImageViewCreateInfo view = {};
 			view.sType = VK_STRUCTURE_TYPE_IMAGE_VIEW_CREATE_INFO;
@@ -274,8 +246,8 @@ namespace rcq
 			image.sType = VK_STRUCTURE_TYPE_IMAGE_CREATE_INFO;
 			image.arrayLayers = 1;
 			image.extent.depth = 1;
-			image.extent.height = SWAP_CHAIN_IMAGE_EXTENT.height;
-			image.extent.width = SWAP_CHAIN_IMAGE_EXTENT.width;
+			image.extent.height = m_base.extent.height;
+			image.extent.width = m_base.extent.width;
 			image.format = VK_FORMAT_R32G32B32A32_SFLOAT;
 			image.imageType = VK_IMAGE_TYPE_2D;
 			image.initialLayout = VK_IMAGE_LAYOUT_UNDEFINED;
@@ -288,13 +260,7 @@ namespace rcq
 			assert(vkCreateImage(m_base.device, &image, m_vk_alloc, &m_res_image[RES_IMAGE_GB_NORMAL_AO].image)
 				== VK_SUCCESS);
 
-			VkMemoryRequirements mr;
-			vkGetImageMemoryRequirements(m_base.device, m_res_image[RES_IMAGE_GB_NORMAL_AO].image, &mr);
-			auto memory = find_device_local_memory(mr.memoryTypeBits);
-			m_res_image[RES_IMAGE_GB_NORMAL_AO].memory = memory;
-			uint64_t offset = memory->allocate(mr.size, mr.alignment);
-			vkBindImageMemory(m_base.device, m_res_image[RES_IMAGE_GB_NORMAL_AO].image, memory->handle(),
-				offset);
+			bind_image_memory(m_res_image[RES_IMAGE_GB_NORMAL_AO], image.usage);
 
 			VkImageViewCreateInfo view = {};
 			view.sType = VK_STRUCTURE_TYPE_IMAGE_VIEW_CREATE_INFO;
@@ -317,8 +283,8 @@ namespace rcq
 			image.sType = VK_STRUCTURE_TYPE_IMAGE_CREATE_INFO;
 			image.arrayLayers = 1;
 			image.extent.depth = 1;
-			image.extent.height = SWAP_CHAIN_IMAGE_EXTENT.height;
-			image.extent.width = SWAP_CHAIN_IMAGE_EXTENT.width;
+			image.extent.height = m_base.extent.height;
+			image.extent.width = m_base.extent.width;
 			image.format = VK_FORMAT_R32G32B32A32_SFLOAT;
 			image.imageType = VK_IMAGE_TYPE_2D;
 			image.initialLayout = VK_IMAGE_LAYOUT_UNDEFINED;
@@ -332,13 +298,7 @@ namespace rcq
 			assert(vkCreateImage(m_base.device, &image, m_vk_alloc, &m_res_image[RES_IMAGE_PREIMAGE].image)
 				== VK_SUCCESS);
 
-			VkMemoryRequirements mr;
-			vkGetImageMemoryRequirements(m_base.device, m_res_image[RES_IMAGE_PREIMAGE].image, &mr);
-			auto memory = find_device_local_memory(mr.memoryTypeBits);
-			m_res_image[RES_IMAGE_PREIMAGE].memory = memory;
-			uint64_t offset = memory->allocate(mr.size, mr.alignment);
-			vkBindImageMemory(m_base.device, m_res_image[RES_IMAGE_PREIMAGE].image, memory->handle(),
-				offset);
+			bind_image_memory(m_res_image[RES_IMAGE_PREIMAGE], image.usage);
 
 			VkImageViewCreateInfo view = {};
 			view.sType = VK_STRUCTURE_TYPE_IMAGE_VIEW_CREATE_INFO;
@@ -360,8 +320,8 @@ namespace rcq
 			image.sType = VK_STRUCTURE_TYPE_IMAGE_CREATE_INFO;
 			image.arrayLayers = 1;
 			image.extent.depth = 1;
-			image.extent.height = SWAP_CHAIN_IMAGE_EXTENT.height;
-			image.extent.width = SWAP_CHAIN_IMAGE_EXTENT.width;
+			image.extent.height = m_base.extent.height;
+			image.extent.width = m_base.extent.width;
 			image.format = VK_FORMAT_D32_SFLOAT_S8_UINT;
 			image.imageType = VK_IMAGE_TYPE_2D;
 			image.initialLayout = VK_IMAGE_LAYOUT_UNDEFINED;
@@ -374,13 +334,7 @@ namespace rcq
 			assert(vkCreateImage(m_base.device, &image, m_vk_alloc, &m_res_image[RES_IMAGE_GB_DEPTH].image)
 				== VK_SUCCESS);
 
-			VkMemoryRequirements mr;
-			vkGetImageMemoryRequirements(m_base.device, m_res_image[RES_IMAGE_GB_DEPTH].image, &mr);
-			auto memory = find_device_local_memory(mr.memoryTypeBits);
-			m_res_image[RES_IMAGE_GB_DEPTH].memory = memory;
-			uint64_t offset = memory->allocate(mr.size, mr.alignment);
-			vkBindImageMemory(m_base.device, m_res_image[RES_IMAGE_GB_DEPTH].image, memory->handle(),
-				offset);
+			bind_image_memory(m_res_image[RES_IMAGE_GB_DEPTH], image.usage);
 
 			VkImageViewCreateInfo view = {};
 			view.sType = VK_STRUCTURE_TYPE_IMAGE_VIEW_CREATE_INFO;
@@ -417,13 +371,7 @@ namespace rcq
 			assert(vkCreateImage(m_base.device, &image, m_vk_alloc, &m_res_image[RES_IMAGE_DIR_SHADOW_MAP].image)
 				== VK_SUCCESS);
 
-			VkMemoryRequirements mr;
-			vkGetImageMemoryRequirements(m_base.device, m_res_image[RES_IMAGE_DIR_SHADOW_MAP].image, &mr);
-			auto memory = find_device_local_memory(mr.memoryTypeBits);
-			m_res_image[RES_IMAGE_DIR_SHADOW_MAP].memory = memory;
-			uint64_t offset = memory->allocate(mr.size, mr.alignment);
-			vkBindImageMemory(m_base.device, m_res_image[RES_IMAGE_DIR_SHADOW_MAP].image, memory->handle(),
-				offset);
+			bind_image_memory(m_res_image[RES_IMAGE_DIR_SHADOW_MAP], image.usage);
 
 			VkImageViewCreateInfo view = {};
 			view.sType = VK_STRUCTURE_TYPE_IMAGE_VIEW_CREATE_INFO;
@@ -445,8 +393,8 @@ namespace rcq
 			VkImageCreateInfo image = {};
 			image.sType = VK_STRUCTURE_TYPE_IMAGE_CREATE_INFO;
 			image.arrayLayers = 1;
-			image.extent.width = SWAP_CHAIN_IMAGE_EXTENT.width;
-			image.extent.height = SWAP_CHAIN_IMAGE_EXTENT.height;
+			image.extent.width = m_base.extent.width;
+			image.extent.height = m_base.extent.height;
 			image.extent.depth = 1;
 			image.format = VK_FORMAT_R32G32B32A32_SFLOAT;
 			image.imageType = VK_IMAGE_TYPE_2D;
@@ -459,13 +407,7 @@ namespace rcq
 
 			assert(vkCreateImage(m_base.device, &image, m_vk_alloc, &m_res_image[RES_IMAGE_PREV_IMAGE].image) == VK_SUCCESS);
 
-			VkMemoryRequirements mr;
-			vkGetImageMemoryRequirements(m_base.device, m_res_image[RES_IMAGE_PREV_IMAGE].image, &mr);
-			auto memory = find_device_local_memory(mr.memoryTypeBits);
-			m_res_image[RES_IMAGE_PREV_IMAGE].memory = memory;
-			uint64_t offset = memory->allocate(mr.size, mr.alignment);
-			vkBindImageMemory(m_base.device, m_res_image[RES_IMAGE_PREV_IMAGE].image, memory->handle(),
-				offset);
+			bind_image_memory(m_res_image[RES_IMAGE_PREV_IMAGE], image.usage);
 
 			VkImageViewCreateInfo view = {};
 			view.sType = VK_STRUCTURE_TYPE_IMAGE_VIEW_CREATE_INFO;
@@ -486,8 +428,8 @@ namespace rcq
 			VkImageCreateInfo image = {};
 			image.sType = VK_STRUCTURE_TYPE_IMAGE_CREATE_INFO;
 			image.arrayLayers = 1;
-			image.extent.width = SWAP_CHAIN_IMAGE_EXTENT.width;
-			image.extent.height = SWAP_CHAIN_IMAGE_EXTENT.height;
+			image.extent.width = m_base.extent.width;
+			image.extent.height = m_base.extent.height;
 			image.extent.depth = 1;
 			image.format = VK_FORMAT_R32G32B32A32_SFLOAT;
 			image.imageType = VK_IMAGE_TYPE_2D;
@@ -500,13 +442,7 @@ namespace rcq
 
 			assert(vkCreateImage(m_base.device, &image, m_vk_alloc, &m_res_image[RES_IMAGE_REFRACTION_IMAGE].image) == VK_SUCCESS);
 
-			VkMemoryRequirements mr;
-			vkGetImageMemoryRequirements(m_base.device, m_res_image[RES_IMAGE_REFRACTION_IMAGE].image, &mr);
-			auto memory = find_device_local_memory(mr.memoryTypeBits);
-			m_res_image[RES_IMAGE_REFRACTION_IMAGE].memory = memory;
-			uint64_t offset = memory->allocate(mr.size, mr.alignment);
-			vkBindImageMemory(m_base.device, m_res_image[RES_IMAGE_REFRACTION_IMAGE].image, memory->handle(),
-				offset);
+			bind_image_memory(m_res_image[RES_IMAGE_REFRACTION_IMAGE], image.usage);
 
 			VkImageViewCreateInfo view = {};
 			view.sType = VK_STRUCTURE_TYPE_IMAGE_VIEW_CREATE_INFO;
@@ -528,8 +464,8 @@ namespace rcq
 			image.sType = VK_STRUCTURE_TYPE_IMAGE_CREATE_INFO;
 			image.arrayLayers = 1;
 			image.arrayLayers = 1;
-			image.extent.width = SWAP_CHAIN_IMAGE_EXTENT.width;
-			image.extent.height = SWAP_CHAIN_IMAGE_EXTENT.height;
+			image.extent.width = m_base.extent.width;
+			image.extent.height = m_base.extent.height;
 			image.extent.depth = 1;
 			image.format = VK_FORMAT_R32_SINT;
 			image.imageType = VK_IMAGE_TYPE_2D;
@@ -542,13 +478,7 @@ namespace rcq
 
 			assert(vkCreateImage(m_base.device, &image, m_vk_alloc, &m_res_image[RES_IMAGE_SSR_RAY_CASTING_COORDS].image) == VK_SUCCESS);
 
-			VkMemoryRequirements mr;
-			vkGetImageMemoryRequirements(m_base.device, m_res_image[RES_IMAGE_SSR_RAY_CASTING_COORDS].image, &mr);
-			auto memory = find_device_local_memory(mr.memoryTypeBits);
-			m_res_image[RES_IMAGE_SSR_RAY_CASTING_COORDS].memory = memory;
-			uint64_t offset = memory->allocate(mr.size, mr.alignment);
-			vkBindImageMemory(m_base.device, m_res_image[RES_IMAGE_SSR_RAY_CASTING_COORDS].image, memory->handle(),
-				offset);
+			bind_image_memory(m_res_image[RES_IMAGE_SSR_RAY_CASTING_COORDS], image.usage);
 
 			VkImageViewCreateInfo view = {};
 			view.sType = VK_STRUCTURE_TYPE_IMAGE_VIEW_CREATE_INFO;
@@ -570,8 +500,8 @@ namespace rcq
 			image.sType = VK_STRUCTURE_TYPE_IMAGE_CREATE_INFO;
 			image.arrayLayers = 1;
 			image.extent.depth = 1;
-			image.extent.height = SWAP_CHAIN_IMAGE_EXTENT.height;
-			image.extent.width = SWAP_CHAIN_IMAGE_EXTENT.width;
+			image.extent.height = m_base.extent.height;
+			image.extent.width = m_base.extent.width;
 			image.format = VK_FORMAT_D32_SFLOAT;
 			image.imageType = VK_IMAGE_TYPE_2D;
 			image.initialLayout = VK_IMAGE_LAYOUT_UNDEFINED;
@@ -584,13 +514,7 @@ namespace rcq
 			assert(vkCreateImage(m_base.device, &image, m_vk_alloc, &m_res_image[RES_IMAGE_SS_DIR_SHADOW_MAP].image)
 				== VK_SUCCESS);
 
-			VkMemoryRequirements mr;
-			vkGetImageMemoryRequirements(m_base.device, m_res_image[RES_IMAGE_SS_DIR_SHADOW_MAP].image, &mr);
-			auto memory = find_device_local_memory(mr.memoryTypeBits);
-			m_res_image[RES_IMAGE_SS_DIR_SHADOW_MAP].memory = memory;
-			uint64_t offset = memory->allocate(mr.size, mr.alignment);
-			vkBindImageMemory(m_base.device, m_res_image[RES_IMAGE_SS_DIR_SHADOW_MAP].image, memory->handle(),
-				offset);
+			bind_image_memory(m_res_image[RES_IMAGE_SS_DIR_SHADOW_MAP], image.usage);
 
 			VkImageViewCreateInfo view = {};
 			view.sType = VK_STRUCTURE_TYPE_IMAGE_VIEW_CREATE_INFO;
@@ -613,8 +537,8 @@ namespace rcq
 			image.sType = VK_STRUCTURE_TYPE_IMAGE_CREATE_INFO;
 			image.arrayLayers = 1;
 			image.extent.depth = 1;
-			image.extent.height = SWAP_CHAIN_IMAGE_EXTENT.height;
-			image.extent.width = SWAP_CHAIN_IMAGE_EXTENT.width;
+			image.extent.height = m_base.extent.height;
+			image.extent.width = m_base.extent.width;
 			image.format = VK_FORMAT_D32_SFLOAT;
 			image.imageType = VK_IMAGE_TYPE_2D;
 			image.initialLayout = VK_IMAGE_LAYOUT_UNDEFINED;
@@ -627,12 +551,7 @@ namespace rcq
 			assert(vkCreateImage(m_base.device, &image, m_vk_alloc, &m_res_image[RES_IMAGE_SSAO_MAP].image)
 				== VK_SUCCESS);
 
-			VkMemoryRequirements mr;
-			vkGetImageMemoryRequirements(m_base.device, m_res_image[RES_IMAGE_SSAO_MAP].image, &mr);
-			auto memory = find_device_local_memory(mr.memoryTypeBits);
-			uint64_t offset = memory->allocate(mr.size, mr.alignment);
-			vkBindImageMemory(m_base.device, m_res_image[RES_IMAGE_SSAO_MAP].image, memory->handle(),
-				offset);
+			bind_image_memory(m_res_image[RES_IMAGE_SSAO_MAP], image.usage);
 
 			VkImageViewCreateInfo view = {};
 			view.sType = VK_STRUCTURE_TYPE_IMAGE_VIEW_CREATE_INFO;
@@ -654,8 +573,8 @@ namespace rcq
 			VkImageCreateInfo im = {};
 			im.sType = VK_STRUCTURE_TYPE_IMAGE_CREATE_INFO;
 			im.arrayLayers = 2;
-			im.extent.width = SWAP_CHAIN_IMAGE_EXTENT.width / BLOOM_IMAGE_SIZE_FACTOR;
-			im.extent.height = SWAP_CHAIN_IMAGE_EXTENT.height / BLOOM_IMAGE_SIZE_FACTOR;
+			im.extent.width = m_base.extent.width / BLOOM_IMAGE_SIZE_FACTOR;
+			im.extent.height = m_base.extent.height / BLOOM_IMAGE_SIZE_FACTOR;
 			im.extent.depth = 1;
 			im.format = VK_FORMAT_R32G32B32A32_SFLOAT;
 			im.imageType = VK_IMAGE_TYPE_2D;
@@ -668,12 +587,7 @@ namespace rcq
 
 			assert(vkCreateImage(m_base.device, &im, m_vk_alloc, &m_res_image[RES_IMAGE_BLOOM_BLUR].image) == VK_SUCCESS);
 
-			VkMemoryRequirements mr;
-			vkGetImageMemoryRequirements(m_base.device, m_res_image[RES_IMAGE_BLOOM_BLUR].image, &mr);
-			auto memory = find_device_local_memory(mr.memoryTypeBits);
-			uint64_t offset = memory->allocate(mr.size, mr.alignment);
-			vkBindImageMemory(m_base.device, m_res_image[RES_IMAGE_BLOOM_BLUR].image, memory->handle(),
-				offset);
+			bind_image_memory(m_res_image[RES_IMAGE_BLOOM_BLUR], im.usage);
 
 			VkImageViewCreateInfo view = {};
 			view.sType = VK_STRUCTURE_TYPE_IMAGE_VIEW_CREATE_INFO;
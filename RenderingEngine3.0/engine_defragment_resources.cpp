@@ -0,0 +1,47 @@
+#include "engine.h"
+
+#include "resource_manager.h"
+
+#include "const_defragmentation_byte_budget.h"
+
+using namespace rcq;
+
+//called between two frames, the renderables keep copies of the handles of the moved resources
+void engine::defragment_resources()
+{
+	auto& relocations = resource_manager::instance()->defragment(DEFRAGMENTATION_BYTE_BUDGET);
+	if (relocations.empty())
+		return;
+
+	m_opaque_objects.for_each([&relocations](renderable<REND_TYPE_OPAQUE_OBJECT>& obj)
+	{
+		for (auto& r : relocations)
+		{
+			switch (r.res->res_type)
+			{
+			case RES_TYPE_MESH:
+			{
+				auto mesh = reinterpret_cast<resource<RES_TYPE_MESH>*>(r.res->data);
+				if (obj.mesh_vb == reinterpret_cast<resource<RES_TYPE_MESH>*>(r.old->data)->vb)
+				{
+					obj.mesh_vb = mesh->vb;
+					obj.mesh_ib = mesh->ib;
+					obj.mesh_veb = mesh->veb;
+				}
+				break;
+			}
+			case RES_TYPE_MAT_OPAQUE:
+				if (obj.mat_opaque_ds == reinterpret_cast<resource<RES_TYPE_MAT_OPAQUE>*>(r.old->data)->ds)
+					obj.mat_opaque_ds = reinterpret_cast<resource<RES_TYPE_MAT_OPAQUE>*>(r.res->data)->ds;
+				break;
+			case RES_TYPE_TR:
+				if (obj.tr_ds == reinterpret_cast<resource<RES_TYPE_TR>*>(r.old->data)->ds)
+					obj.tr_ds = reinterpret_cast<resource<RES_TYPE_TR>*>(r.res->data)->ds;
+				break;
+			}
+		}
+	});
+
+	m_opaque_objects_changed = true;
+	resource_manager::instance()->retire_relocations();
+}
\ No newline at end of file
@@ -2,11 +2,11 @@
 
 #include "rps.h"
 #include "terrain_manager.h"
+#include "resource_manager.h"
 
 #include "enum_res_image.h"
 
 #include "const_dir_shadow_map_size.h"
-#include "const_swap_chain_image_extent.h"
 #include "const_bloom_image_size_factor.h"
 #include "const_environment_map_size.h"
 
@@ -14,6 +14,8 @@ using namespace rcq;
 
 void engine::record_and_submit()
 {
+	RCQ_TRACE_SCOPE("engine::record_and_submit");
+
 	/*if (record_mask[RENDERABLE_TYPE_SKYBOX] && !m_renderables[RENDERABLE_TYPE_SKYBOX].empty())
 	{
 	auto cb = m_secondary_cbs[SECONDARY_CB_SKYBOX_EM];
@@ -50,6 +52,9 @@ void engine::record_and_submit()
 
 	vkWaitForFences(m_base.device, 1, &m_fences[FENCE_RENDER_FINISHED], VK_TRUE, std::numeric_limits<uint64_t>::max());
 	vkResetFences(m_base.device, 1, &m_fences[FENCE_RENDER_FINISHED]);
+	resource_manager::instance()->frame_completed();
+	defragment_resources();
+	m_gpu_profiler.read_results();
 	vkResetEvent(m_base.device, m_events[EVENT_WATER_READY]);
 
 	if (m_opaque_objects.size() != 0)
@@ -71,6 +76,7 @@ void engine::record_and_submit()
 			begin.pInheritanceInfo = &inharitance;
 
 			assert(vkBeginCommandBuffer(cb, &begin) == VK_SUCCESS);
+			m_gpu_profiler.begin_statistics(cb, DRAW_CATEGORY_DIR_SHADOW);
 
 			vkCmdBindPipeline(cb, VK_PIPELINE_BIND_POINT_BEGIN_RANGE, m_gps[GP_DIR_SHADOW_MAP_GEN].ppl);
 			vkCmdBindDescriptorSets(cb, VK_PIPELINE_BIND_POINT_GRAPHICS, m_gps[GP_DIR_SHADOW_MAP_GEN].pl,
@@ -86,6 +92,7 @@ void engine::record_and_submit()
 				vkCmdDrawIndexed(cb, obj.mesh_index_size, 1, 0, 0, 0);
 			});
 
+			m_gpu_profiler.end_statistics(cb, DRAW_CATEGORY_DIR_SHADOW);
 			assert(vkEndCommandBuffer(cb) == VK_SUCCESS);
 		}
 
@@ -109,6 +116,7 @@ void engine::record_and_submit()
 			begin.pInheritanceInfo = &inharitance;
 
 			assert(vkBeginCommandBuffer(cb, &begin) == VK_SUCCESS);
+			m_gpu_profiler.begin_statistics(cb, DRAW_CATEGORY_OPAQUE_OBJECTS);
 
 			vkCmdBindPipeline(cb, VK_PIPELINE_BIND_POINT_BEGIN_RANGE, m_gps[GP_OPAQUE_OBJ_DRAWER].ppl);
 			vkCmdBindDescriptorSets(cb, VK_PIPELINE_BIND_POINT_GRAPHICS, m_gps[GP_OPAQUE_OBJ_DRAWER].pl,
@@ -130,27 +138,11 @@ void engine::record_and_submit()
 				vkCmdDrawIndexed(cb, obj.mesh_index_size, 1, 0, 0, 0);
 			});
 
+			m_gpu_profiler.end_statistics(cb, DRAW_CATEGORY_OPAQUE_OBJECTS);
 			assert(vkEndCommandBuffer(cb) == VK_SUCCESS);
 		}
 	}
 
-	//manage terrain request and water fft
-	if (m_terrain_valid)
-	{
-		terrain_manager::instance()->poll_results();
-		vkWaitForFences(m_base.device, 1, &m_fences[FENCE_COMPUTE_FINISHED], VK_TRUE, std::numeric_limits<uint64_t>::max());
-		vkResetFences(m_base.device, 1, &m_fences[FENCE_COMPUTE_FINISHED]);
-		terrain_manager::instance()->poll_requests();
-
-		VkCommandBuffer cbs[2] = { m_cbs[CB_TERRAIN_REQUEST], m_cbs[CB_WATER_FFT] };
-		VkSubmitInfo submit = {};
-		submit.sType = VK_STRUCTURE_TYPE_SUBMIT_INFO;
-		submit.commandBufferCount = 2;
-		submit.pCommandBuffers = cbs;
-
-		vkQueueSubmit(m_base.queues[QUEUE_COMPUTE], 1, &submit, m_fences[FENCE_COMPUTE_FINISHED]);
-	}
-
 	if (m_opaque_objects.size() != 0)
 	{
 		auto cb = m_secondary_cbs[SECONDARY_CB_MAT_EM];
@@ -191,14 +183,13 @@ void engine::record_and_submit()
 		assert(vkEndCommandBuffer(cb) == VK_SUCCESS);
 	}
 
-	//record primary cb
+	//record res data copy cb, the compute cbs read the copied data too
 	{
-		auto cb = m_cbs[CB_RENDER];
-		//vkResetCommandBuffer(cb, VK_COMMAND_BUFFER_RESET_RELEASE_RESOURCES_BIT);
+		auto cb = m_cbs[CB_RES_DATA_COPY];
 
 		VkCommandBufferBeginInfo cb_begin = {};
 		cb_begin.sType = VK_STRUCTURE_TYPE_COMMAND_BUFFER_BEGIN_INFO;
-		cb_begin.flags = VK_COMMAND_BUFFER_USAGE_ONE_TIME_SUBMIT_BIT | VK_COMMAND_BUFFER_USAGE_SIMULTANEOUS_USE_BIT;
+		cb_begin.flags = VK_COMMAND_BUFFER_USAGE_ONE_TIME_SUBMIT_BIT;
 
 		assert(vkBeginCommandBuffer(cb, &cb_begin) == VK_SUCCESS);
 
@@ -225,6 +216,96 @@ void engine::record_and_submit()
 				1, &barrier, 0, nullptr);
 		}
 
+		assert(vkEndCommandBuffer(cb) == VK_SUCCESS);
+	}
+
+	//the compute cbs are submitted before recording the render cb, so they overlap with it on the gpu
+	bool water_fft = m_water_valid;
+	bool terrain_request = false;
+	if (m_terrain_valid)
+		terrain_manager::instance()->poll_results();
+	if (m_terrain_valid && vkGetFenceStatus(m_base.device, m_fences[FENCE_COMPUTE_FINISHED]) == VK_SUCCESS)
+	{
+		//the previous requests are read back only when they are ready, the cpu never waits for them
+		vkResetFences(m_base.device, 1, &m_fences[FENCE_COMPUTE_FINISHED]);
+		terrain_manager::instance()->poll_requests(m_render_settings);
+		terrain_request = true;
+	}
+	bool compute = water_fft || terrain_request;
+
+	//timers written in the cbs of this frame
+	uint32_t gpu_timer_mask = (1 << GPU_TIMER_ENVIRONMENT_MAP_GEN) | (1 << GPU_TIMER_GBUFFER_ASSEMBLER) | 
+		(1 << GPU_TIMER_SSAO_GEN) | (1 << GPU_TIMER_PREIMAGE_ASSEMBLER) | (1 << GPU_TIMER_SSR_RAY_CASTING) |
+		(1 << GPU_TIMER_SKY_DRAWER) | (1 << GPU_TIMER_REFRACTION_IMAGE_GEN) | (1 << GPU_TIMER_WATER_DRAWER) |
+		(1 << GPU_TIMER_BLOOM) | (1 << GPU_TIMER_POSTPROCESSING);
+	if (terrain_request)
+		gpu_timer_mask |= 1 << GPU_TIMER_TERRAIN_REQUEST;
+	if (water_fft)
+		gpu_timer_mask |= 1 << GPU_TIMER_WATER_FFT;
+	if (m_opaque_objects.size() != 0)
+		gpu_timer_mask |= 1 << GPU_TIMER_DIR_SHADOW_MAP_GEN;
+
+	//draw categories with pipeline statistics in this frame
+	uint32_t draw_category_mask = 0;
+	if (m_opaque_objects.size() != 0)
+		draw_category_mask |= (1 << DRAW_CATEGORY_OPAQUE_OBJECTS) | (1 << DRAW_CATEGORY_DIR_SHADOW);
+	if (m_terrain_valid)
+		draw_category_mask |= 1 << DRAW_CATEGORY_TERRAIN;
+	if (m_water_valid)
+		draw_category_mask |= 1 << DRAW_CATEGORY_WATER;
+
+	//submit res data copy
+	{
+		VkSubmitInfo submit = {};
+		submit.sType = VK_STRUCTURE_TYPE_SUBMIT_INFO;
+		submit.commandBufferCount = 1;
+		submit.pCommandBuffers = &m_cbs[CB_RES_DATA_COPY];
+		submit.pSignalSemaphores = &m_semaphores[SEMAPHORE_RES_DATA_COPIED];
+		submit.signalSemaphoreCount = compute ? 1 : 0;
+
+		std::lock_guard<std::mutex> lock(*m_base.queue_mutexes[QUEUE_RENDER]);
+		assert(vkQueueSubmit(m_base.queues[QUEUE_RENDER], 1, &submit, VK_NULL_HANDLE) == VK_SUCCESS);
+	}
+
+	//submit terrain request and water fft
+	if (compute)
+	{
+		VkCommandBuffer cbs[2];
+		uint32_t cb_count = 0;
+		if (terrain_request)
+			cbs[cb_count++] = m_cbs[CB_TERRAIN_REQUEST];
+		if (water_fft)
+			cbs[cb_count++] = m_cbs[CB_WATER_FFT];
+
+		VkSubmitInfo submit = {};
+		submit.sType = VK_STRUCTURE_TYPE_SUBMIT_INFO;
+		submit.commandBufferCount = cb_count;
+		submit.pCommandBuffers = cbs;
+		submit.waitSemaphoreCount = 1;
+		submit.pWaitSemaphores = &m_semaphores[SEMAPHORE_RES_DATA_COPIED];
+		VkPipelineStageFlags wait = VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT;
+		submit.pWaitDstStageMask = &wait;
+		submit.pSignalSemaphores = &m_semaphores[SEMAPHORE_WATER_FFT_FINISHED];
+		submit.signalSemaphoreCount = water_fft ? 1 : 0;
+
+		std::lock_guard<std::mutex> lock(*m_base.queue_mutexes[QUEUE_COMPUTE]);
+		assert(vkQueueSubmit(m_base.queues[QUEUE_COMPUTE], 1, &submit,
+			terrain_request ? m_fences[FENCE_COMPUTE_FINISHED] : VK_NULL_HANDLE) == VK_SUCCESS);
+	}
+
+	//record primary cb
+	{
+		auto cb = m_cbs[CB_RENDER];
+		//vkResetCommandBuffer(cb, VK_COMMAND_BUFFER_RESET_RELEASE_RESOURCES_BIT);
+
+		VkCommandBufferBeginInfo cb_begin = {};
+		cb_begin.sType = VK_STRUCTURE_TYPE_COMMAND_BUFFER_BEGIN_INFO;
+		cb_begin.flags = VK_COMMAND_BUFFER_USAGE_ONE_TIME_SUBMIT_BIT | VK_COMMAND_BUFFER_USAGE_SIMULTANEOUS_USE_BIT;
+
+		assert(vkBeginCommandBuffer(cb, &cb_begin) == VK_SUCCESS);
+		m_gpu_profiler.reset(cb, GPU_TIMER_ENVIRONMENT_MAP_GEN, GPU_TIMER_WATER_DRAWER - GPU_TIMER_ENVIRONMENT_MAP_GEN);
+		m_gpu_profiler.reset_statistics(cb, DRAW_CATEGORY_OPAQUE_OBJECTS, DRAW_CATEGORY_WATER);
+
 		//environment map gen
 		{
 			using ATT = rp_create_info<RP_ENVIRONMENT_MAP_GEN>::ATT;
@@ -244,10 +325,12 @@ void engine::record_and_submit()
 			begin.renderArea.extent.height = ENVIRONMENT_MAP_SIZE;
 			begin.renderArea.offset = { 0,0 };
 
+			m_gpu_profiler.begin(cb, GPU_TIMER_ENVIRONMENT_MAP_GEN);
 			vkCmdBeginRenderPass(cb, &begin, VK_SUBPASS_CONTENTS_SECONDARY_COMMAND_BUFFERS);
 			vkCmdExecuteCommands(cb, 1, &m_secondary_cbs[SECONDARY_CB_MAT_EM]);
 			//vkCmdExecuteCommands(cb, 1, &m_secondary_cbs[SECONDARY_CB_SKYBOX_EM]);
 			vkCmdEndRenderPass(cb);
+			m_gpu_profiler.end(cb, GPU_TIMER_ENVIRONMENT_MAP_GEN);
 
 			VkImageMemoryBarrier b = {};
 			b.sType = VK_STRUCTURE_TYPE_IMAGE_MEMORY_BARRIER;
@@ -287,9 +370,11 @@ void engine::record_and_submit()
 			begin.renderArea.extent.height = DIR_SHADOW_MAP_SIZE;
 			begin.renderArea.offset = { 0,0 };
 
+			m_gpu_profiler.begin(cb, GPU_TIMER_DIR_SHADOW_MAP_GEN);
 			vkCmdBeginRenderPass(cb, &begin, VK_SUBPASS_CONTENTS_SECONDARY_COMMAND_BUFFERS);
 			vkCmdExecuteCommands(cb, 1, &m_secondary_cbs[SECONDARY_CB_DIR_SHADOW_GEN]);
 			vkCmdEndRenderPass(cb);
+			m_gpu_profiler.end(cb, GPU_TIMER_DIR_SHADOW_MAP_GEN);
 
 			VkImageMemoryBarrier b = {};
 			b.sType = VK_STRUCTURE_TYPE_IMAGE_MEMORY_BARRIER;
@@ -324,9 +409,10 @@ void engine::record_and_submit()
 
 			begin.clearValueCount = ATT::ATT_COUNT;
 			begin.pClearValues = clears;
-			begin.renderArea.extent = SWAP_CHAIN_IMAGE_EXTENT;
+			begin.renderArea.extent = m_base.extent;
 			begin.renderArea.offset = { 0,0 };
 
+			m_gpu_profiler.begin(cb, GPU_TIMER_GBUFFER_ASSEMBLER);
 			vkCmdBeginRenderPass(cb, &begin, VK_SUBPASS_CONTENTS_SECONDARY_COMMAND_BUFFERS);
 			if (m_opaque_objects.size() != 0)
 				vkCmdExecuteCommands(cb, 1, &m_secondary_cbs[SECONDARY_CB_MAT_OPAQUE]);
@@ -341,6 +427,7 @@ void engine::record_and_submit()
 			vkCmdDraw(cb, 4, 1, 0, 0);
 
 			vkCmdEndRenderPass(cb);
+			m_gpu_profiler.end(cb, GPU_TIMER_GBUFFER_ASSEMBLER);
 		}
 
 		//barrier for ssds map
@@ -442,13 +529,15 @@ void engine::record_and_submit()
 			begin.sType = VK_STRUCTURE_TYPE_RENDER_PASS_BEGIN_INFO;
 			begin.framebuffer = m_fbs[FB_SSAO_MAP_GEN];
 			begin.renderPass = m_rps[RP_SSAO_MAP_GEN];
-			begin.renderArea.extent = SWAP_CHAIN_IMAGE_EXTENT;
+			begin.renderArea.extent = m_base.extent;
 			begin.renderArea.offset = { 0,0 };
 
+			m_gpu_profiler.begin(cb, GPU_TIMER_SSAO_GEN);
 			vkCmdBeginRenderPass(cb, &begin, VK_SUBPASS_CONTENTS_INLINE);
 			m_gps[GP_SSAO_GEN].bind(cb);
 			vkCmdDraw(cb, 4, 1, 0, 0);
 			vkCmdEndRenderPass(cb);
+			m_gpu_profiler.end(cb, GPU_TIMER_SSAO_GEN);
 		}
 
 		//barrier for ssao map
@@ -478,9 +567,10 @@ void engine::record_and_submit()
 			begin.sType = VK_STRUCTURE_TYPE_RENDER_PASS_BEGIN_INFO;
 			begin.framebuffer = m_fbs[FB_PREIMAGE_ASSEMBLER];
 			begin.renderPass = m_rps[RP_PREIMAGE_ASSEMBLER];
-			begin.renderArea.extent = SWAP_CHAIN_IMAGE_EXTENT;
+			begin.renderArea.extent = m_base.extent;
 			begin.renderArea.offset = { 0,0 };
 
+			m_gpu_profiler.begin(cb, GPU_TIMER_PREIMAGE_ASSEMBLER);
 			vkCmdBeginRenderPass(cb, &begin, VK_SUBPASS_CONTENTS_INLINE);
 			m_gps[GP_SS_DIR_SHADOW_MAP_BLUR].bind(cb);
 			vkCmdDraw(cb, 4, 1, 0, 0);
@@ -489,9 +579,12 @@ void engine::record_and_submit()
 			m_gps[GP_SSAO_BLUR].bind(cb);
 			vkCmdDraw(cb, 4, 1, 0, 0);
 
+			//the subpasses of ssr and the sky are timed inside the pass as well
 			vkCmdNextSubpass(cb, VK_SUBPASS_CONTENTS_INLINE);
+			m_gpu_profiler.begin(cb, GPU_TIMER_SSR_RAY_CASTING);
 			m_gps[GP_SSR_RAY_CASTING].bind(cb);
-			vkCmdDraw(cb, SWAP_CHAIN_IMAGE_EXTENT.width, SWAP_CHAIN_IMAGE_EXTENT.height, 0, 0);
+			vkCmdDraw(cb, m_base.extent.width, m_base.extent.height, 0, 0);
+			m_gpu_profiler.end(cb, GPU_TIMER_SSR_RAY_CASTING);
 
 			vkCmdNextSubpass(cb, VK_SUBPASS_CONTENTS_INLINE);
 			m_gps[GP_IMAGE_ASSEMBLER].bind(cb);
@@ -503,6 +596,7 @@ void engine::record_and_submit()
 			vkCmdDraw(cb, 4, 1, 0, 0);
 
 			vkCmdNextSubpass(cb, VK_SUBPASS_CONTENTS_INLINE);
+			m_gpu_profiler.begin(cb, GPU_TIMER_SKY_DRAWER);
 			m_gps[GP_SKY_DRAWER].bind(cb);
 			if (m_sky_valid)
 			{
@@ -519,8 +613,10 @@ void engine::record_and_submit()
 					1, 1, &m_sky.ds, 0, nullptr);
 				vkCmdDraw(cb, 18, 1, 0, 0);
 			}
+			m_gpu_profiler.end(cb, GPU_TIMER_SKY_DRAWER);
 
 			vkCmdEndRenderPass(cb);
+			m_gpu_profiler.end(cb, GPU_TIMER_PREIMAGE_ASSEMBLER);
 		}
 
 		//barrier for preimage
@@ -555,14 +651,16 @@ void engine::record_and_submit()
 			clears[ATT::ATT_REFRACTION_IMAGE].color = { 0.f, 0.f, 0.f, 0.f };
 			begin.pClearValues = clears;
 			begin.framebuffer = m_fbs[FB_REFRACTION_IMAGE_GEN];
-			begin.renderArea.extent = SWAP_CHAIN_IMAGE_EXTENT;
+			begin.renderArea.extent = m_base.extent;
 			begin.renderArea.offset = { 0,0 };
 			begin.renderPass = m_rps[RP_REFRACTION_IMAGE_GEN];
 
+			m_gpu_profiler.begin(cb, GPU_TIMER_REFRACTION_IMAGE_GEN);
 			vkCmdBeginRenderPass(cb, &begin, VK_SUBPASS_CONTENTS_INLINE);
 			m_gps[GP_REFRACTION_IMAGE_GEN].bind(cb);
 			vkCmdDraw(cb, 4, 1, 0, 0);
 			vkCmdEndRenderPass(cb);
+			m_gpu_profiler.end(cb, GPU_TIMER_REFRACTION_IMAGE_GEN);
 		}
 
 		//barrier for refraction image
@@ -586,30 +684,49 @@ void engine::record_and_submit()
 				0, 0, nullptr, 0, nullptr, 1, &b);
 		}
 
+		assert(vkEndCommandBuffer(cb) == VK_SUCCESS);
+	}
+
+	//record water cb, only this part of the frame waits for the water fft
+	{
+		auto cb = m_cbs[CB_RENDER_WATER];
+
+		VkCommandBufferBeginInfo cb_begin = {};
+		cb_begin.sType = VK_STRUCTURE_TYPE_COMMAND_BUFFER_BEGIN_INFO;
+		cb_begin.flags = VK_COMMAND_BUFFER_USAGE_ONE_TIME_SUBMIT_BIT;
+
+		assert(vkBeginCommandBuffer(cb, &cb_begin) == VK_SUCCESS);
+		m_gpu_profiler.reset(cb, GPU_TIMER_WATER_DRAWER);
+		m_gpu_profiler.reset_statistics(cb, DRAW_CATEGORY_WATER);
+
 		//water
 		{
 			VkRenderPassBeginInfo begin = {};
 			begin.sType = VK_STRUCTURE_TYPE_RENDER_PASS_BEGIN_INFO;
 			begin.framebuffer = m_fbs[FB_WATER_DRAWER];
-			begin.renderArea.extent = SWAP_CHAIN_IMAGE_EXTENT;
+			begin.renderArea.extent = m_base.extent;
 			begin.renderArea.offset = { 0,0 };
 			begin.renderPass = m_rps[RP_WATER_DRAWER];
 
+			m_gpu_profiler.begin(cb, GPU_TIMER_WATER_DRAWER);
 			vkCmdBeginRenderPass(cb, &begin, VK_SUBPASS_CONTENTS_INLINE);
 
 			m_gps[GP_WATER_DRAWER].bind(cb);
 
 			if (m_water_valid)
 			{
+				m_gpu_profiler.begin_statistics(cb, DRAW_CATEGORY_WATER);
 				vkCmdBindDescriptorSets(cb, VK_PIPELINE_BIND_POINT_GRAPHICS, m_gps[GP_WATER_DRAWER].pl,
 					1, 1, &m_water.ds, 0, nullptr);
 				vkCmdBindDescriptorSets(cb, VK_PIPELINE_BIND_POINT_GRAPHICS, m_gps[GP_WATER_DRAWER].pl,
 					2, 1, &m_sky.ds, 0, nullptr);
 
 				vkCmdDraw(cb, m_water_tiles_count.x * 4, m_water_tiles_count.y, 0, 0);
+				m_gpu_profiler.end_statistics(cb, DRAW_CATEGORY_WATER);
 			}
 
 			vkCmdEndRenderPass(cb);
+			m_gpu_profiler.end(cb, GPU_TIMER_WATER_DRAWER);
 		}
 
 		//barrier for preimage
@@ -657,8 +774,8 @@ void engine::record_and_submit()
 			VkImageBlit blit = {};
 			blit.srcOffsets[0] = { 0, 0, 0 };
 			blit.srcOffsets[1] = {
-				static_cast<int32_t>(SWAP_CHAIN_IMAGE_EXTENT.width),
-				static_cast<int32_t>(SWAP_CHAIN_IMAGE_EXTENT.height), 1 };
+				static_cast<int32_t>(m_base.extent.width),
+				static_cast<int32_t>(m_base.extent.height), 1 };
 			blit.srcSubresource.aspectMask = VK_IMAGE_ASPECT_COLOR_BIT;
 			blit.srcSubresource.baseArrayLayer = 0;
 			blit.srcSubresource.layerCount = 1;
@@ -666,8 +783,8 @@ void engine::record_and_submit()
 
 			blit.dstOffsets[0] = { 0, 0, 0 };
 			blit.dstOffsets[1] = {
-				static_cast<int32_t>(SWAP_CHAIN_IMAGE_EXTENT.width / BLOOM_IMAGE_SIZE_FACTOR),
-				static_cast<int32_t>(SWAP_CHAIN_IMAGE_EXTENT.height / BLOOM_IMAGE_SIZE_FACTOR), 1 };
+				static_cast<int32_t>(m_base.extent.width / BLOOM_IMAGE_SIZE_FACTOR),
+				static_cast<int32_t>(m_base.extent.height / BLOOM_IMAGE_SIZE_FACTOR), 1 };
 			blit.dstSubresource.aspectMask = VK_IMAGE_ASPECT_COLOR_BIT;
 			blit.dstSubresource.baseArrayLayer = 0;
 			blit.dstSubresource.layerCount = 1;
@@ -721,25 +838,36 @@ void engine::record_and_submit()
 		assert(vkEndCommandBuffer(cb) == VK_SUCCESS);
 	}
 
+	//the offscreen images of headless mode are used round robin, they are free once the render fence signals
 	uint32_t image_index;
-	vkAcquireNextImageKHR(m_base.device, m_base.swapchain, std::numeric_limits<uint64_t>::max(), 
-		m_semaphores[SEMAPHORE_IMAGE_AVAILABLE], VK_NULL_HANDLE, &image_index);
-
-	//submit render_buffer
+	if (m_base.headless)
+		image_index = (m_image_index + 1) % SWAP_CHAIN_IMAGE_COUNT;
+	else
+		vkAcquireNextImageKHR(m_base.device, m_base.swapchain, std::numeric_limits<uint64_t>::max(),
+			m_semaphores[SEMAPHORE_IMAGE_AVAILABLE], VK_NULL_HANDLE, &image_index);
+	m_image_index = image_index;
+
+	//submit render and water cbs, only the water cb waits for the water fft
 	{
-		VkSubmitInfo submit = {};
-		submit.sType = VK_STRUCTURE_TYPE_SUBMIT_INFO;
-		submit.commandBufferCount = 1;
-		submit.pCommandBuffers = &m_cbs[CB_RENDER];
+		VkSubmitInfo submits[2] = {};
+		submits[0].sType = VK_STRUCTURE_TYPE_SUBMIT_INFO;
+		submits[0].commandBufferCount = 1;
+		submits[0].pCommandBuffers = &m_cbs[CB_RENDER];
+
+		submits[1].sType = VK_STRUCTURE_TYPE_SUBMIT_INFO;
+		submits[1].commandBufferCount = 1;
+		submits[1].pCommandBuffers = &m_cbs[CB_RENDER_WATER];
+		submits[1].waitSemaphoreCount = water_fft ? 1 : 0;
+		submits[1].pWaitSemaphores = &m_semaphores[SEMAPHORE_WATER_FFT_FINISHED];
+		VkPipelineStageFlags wait = VK_PIPELINE_STAGE_TESSELLATION_EVALUATION_SHADER_BIT;
+		submits[1].pWaitDstStageMask = &wait;
 		VkSemaphore signal_s[2] = { m_semaphores[SEMAPHORE_RENDER_FINISHED],
 			m_semaphores[SEMAPHORE_PREIMAGE_READY] };
-		submit.pSignalSemaphores = signal_s;
-		submit.signalSemaphoreCount = 2;
+		submits[1].pSignalSemaphores = signal_s;
+		submits[1].signalSemaphoreCount = 2;
 
-		vkWaitForFences(m_base.device, 1, &m_fences[FENCE_COMPUTE_FINISHED], VK_TRUE, std::numeric_limits<uint64_t>::max());
-		//vkSetEvent(m_base.device, m_water_tex_ready_e);
-
-		assert(vkQueueSubmit(m_base.queues[QUEUE_RENDER], 1, &submit, VK_NULL_HANDLE) == VK_SUCCESS);
+		std::lock_guard<std::mutex> lock(*m_base.queue_mutexes[QUEUE_RENDER]);
+		assert(vkQueueSubmit(m_base.queues[QUEUE_RENDER], 2, submits, VK_NULL_HANDLE) == VK_SUCCESS);
 	}
 
 	//submit bloom blur
@@ -755,6 +883,7 @@ void engine::record_and_submit()
 		VkPipelineStageFlags wait = VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT;
 		submit.pWaitDstStageMask = &wait;
 
+		std::lock_guard<std::mutex> lock(*m_base.queue_mutexes[QUEUE_COMPUTE]);
 		assert(vkQueueSubmit(m_base.queues[QUEUE_COMPUTE], 1, &submit, VK_NULL_HANDLE) == VK_SUCCESS);
 	}
 
@@ -765,28 +894,33 @@ void engine::record_and_submit()
 		submit.commandBufferCount = 1;
 		submit.pCommandBuffers = &m_present_cbs[image_index];
 
+		//there is nothing to acquire and present in headless mode
 		VkSemaphore wait_ss[3] =
 		{ 
-			m_semaphores[SEMAPHORE_IMAGE_AVAILABLE], 
 			m_semaphores[SEMAPHORE_RENDER_FINISHED], 
-			m_semaphores[SEMAPHORE_BLOOM_READY] 
+			m_semaphores[SEMAPHORE_BLOOM_READY],
+			m_semaphores[SEMAPHORE_IMAGE_AVAILABLE]
 		};
 		submit.pWaitSemaphores = wait_ss;
-		submit.waitSemaphoreCount = 3;
+		submit.waitSemaphoreCount = m_base.headless ? 2 : 3;
 		VkPipelineStageFlags waits[3] = 
 		{
-			VK_PIPELINE_STAGE_COLOR_ATTACHMENT_OUTPUT_BIT,
 			VK_PIPELINE_STAGE_FRAGMENT_SHADER_BIT,
-			VK_PIPELINE_STAGE_FRAGMENT_SHADER_BIT
+			VK_PIPELINE_STAGE_FRAGMENT_SHADER_BIT,
+			VK_PIPELINE_STAGE_COLOR_ATTACHMENT_OUTPUT_BIT
 		};
 		submit.pWaitDstStageMask = waits;
 		submit.pSignalSemaphores = &m_present_ready_ss[image_index];
-		submit.signalSemaphoreCount = 1;
+		submit.signalSemaphoreCount = m_base.headless ? 0 : 1;
 
+		std::lock_guard<std::mutex> lock(*m_base.queue_mutexes[QUEUE_RENDER]);
 		assert(vkQueueSubmit(m_base.queues[QUEUE_RENDER], 1, &submit, m_fences[FENCE_RENDER_FINISHED]) == VK_SUCCESS);
+		resource_manager::instance()->frame_submitted();
+		m_gpu_profiler.frame_submitted(gpu_timer_mask, draw_category_mask);
 	}
 
 	//present swap chain image
+	if (!m_base.headless)
 	{
 		VkPresentInfoKHR present = {};
 		present.sType = VK_STRUCTURE_TYPE_PRESENT_INFO_KHR;
@@ -796,6 +930,7 @@ void engine::record_and_submit()
 		present.pWaitSemaphores = &m_present_ready_ss[image_index];
 		present.waitSemaphoreCount = 1;
 
+		std::lock_guard<std::mutex> lock(*m_base.queue_mutexes[QUEUE_PRESENT]);
 		assert(vkQueuePresentKHR(m_base.queues[QUEUE_PRESENT], &present) == VK_SUCCESS);
 	}
 }
\ No newline at end of file
@@ -0,0 +1,133 @@
+#include "engine.h"
+
+#include "enum_memory_type.h"
+
+#include <fstream>
+
+using namespace rcq;
+
+bool engine::save_frame(const char* filename)
+{
+	assert(m_base.headless);
+
+	//the image of the last frame is copied after everything finished on the render queue
+	{
+		std::lock_guard<std::mutex> lock(*m_base.queue_mutexes[QUEUE_RENDER]);
+		vkQueueWaitIdle(m_base.queues[QUEUE_RENDER]);
+	}
+
+	const uint32_t width = m_base.extent.width;
+	const uint32_t height = m_base.extent.height;
+	const VkDeviceSize size = VkDeviceSize(width)*VkDeviceSize(height) * 4;
+
+	//readback buffer
+	VkBuffer buffer;
+	VkDeviceMemory memory;
+	{
+		VkBufferCreateInfo b = {};
+		b.sType = VK_STRUCTURE_TYPE_BUFFER_CREATE_INFO;
+		b.sharingMode = VK_SHARING_MODE_EXCLUSIVE;
+		b.size = size;
+		b.usage = VK_BUFFER_USAGE_TRANSFER_DST_BIT;
+		assert(vkCreateBuffer(m_base.device, &b, m_vk_alloc, &buffer) == VK_SUCCESS);
+
+		VkMemoryRequirements mr;
+		vkGetBufferMemoryRequirements(m_base.device, buffer, &mr);
+
+		VkMemoryAllocateInfo alloc = {};
+		alloc.sType = VK_STRUCTURE_TYPE_MEMORY_ALLOCATE_INFO;
+		alloc.allocationSize = mr.size;
+		alloc.memoryTypeIndex = m_base.memory_types[MEMORY_TYPE_HVCC];
+		assert(vkAllocateMemory(m_base.device, &alloc, m_vk_alloc, &memory) == VK_SUCCESS);
+		vkBindBufferMemory(m_base.device, buffer, memory, 0);
+	}
+
+	//copy
+	{
+		VkCommandBufferAllocateInfo alloc = {};
+		alloc.sType = VK_STRUCTURE_TYPE_COMMAND_BUFFER_ALLOCATE_INFO;
+		alloc.commandBufferCount = 1;
+		alloc.commandPool = m_cpools[CPOOL_GRAPHICS];
+		alloc.level = VK_COMMAND_BUFFER_LEVEL_PRIMARY;
+		VkCommandBuffer cb;
+		assert(vkAllocateCommandBuffers(m_base.device, &alloc, &cb) == VK_SUCCESS);
+
+		VkCommandBufferBeginInfo begin = {};
+		begin.sType = VK_STRUCTURE_TYPE_COMMAND_BUFFER_BEGIN_INFO;
+		begin.flags = VK_COMMAND_BUFFER_USAGE_ONE_TIME_SUBMIT_BIT;
+		assert(vkBeginCommandBuffer(cb, &begin) == VK_SUCCESS);
+
+		//the postprocessing pass left the image in transfer src layout
+		VkImageMemoryBarrier b = {};
+		b.sType = VK_STRUCTURE_TYPE_IMAGE_MEMORY_BARRIER;
+		b.image = m_base.swapchain_images[m_image_index];
+		b.oldLayout = VK_IMAGE_LAYOUT_TRANSFER_SRC_OPTIMAL;
+		b.newLayout = VK_IMAGE_LAYOUT_TRANSFER_SRC_OPTIMAL;
+		b.srcAccessMask = VK_ACCESS_COLOR_ATTACHMENT_WRITE_BIT;
+		b.dstAccessMask = VK_ACCESS_TRANSFER_READ_BIT;
+		b.srcQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
+		b.dstQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
+		b.subresourceRange.aspectMask = VK_IMAGE_ASPECT_COLOR_BIT;
+		b.subresourceRange.baseArrayLayer = 0;
+		b.subresourceRange.baseMipLevel = 0;
+		b.subresourceRange.layerCount = 1;
+		b.subresourceRange.levelCount = 1;
+		vkCmdPipelineBarrier(cb, VK_PIPELINE_STAGE_COLOR_ATTACHMENT_OUTPUT_BIT, VK_PIPELINE_STAGE_TRANSFER_BIT,
+			0, 0, nullptr, 0, nullptr, 1, &b);
+
+		VkBufferImageCopy region = {};
+		region.imageSubresource.aspectMask = VK_IMAGE_ASPECT_COLOR_BIT;
+		region.imageSubresource.baseArrayLayer = 0;
+		region.imageSubresource.layerCount = 1;
+		region.imageSubresource.mipLevel = 0;
+		region.imageExtent = { width, height, 1 };
+		vkCmdCopyImageToBuffer(cb, m_base.swapchain_images[m_image_index], VK_IMAGE_LAYOUT_TRANSFER_SRC_OPTIMAL,
+			buffer, 1, &region);
+
+		VkMemoryBarrier host = {};
+		host.sType = VK_STRUCTURE_TYPE_MEMORY_BARRIER;
+		host.srcAccessMask = VK_ACCESS_TRANSFER_WRITE_BIT;
+		host.dstAccessMask = VK_ACCESS_HOST_READ_BIT;
+		vkCmdPipelineBarrier(cb, VK_PIPELINE_STAGE_TRANSFER_BIT, VK_PIPELINE_STAGE_HOST_BIT,
+			0, 1, &host, 0, nullptr, 0, nullptr);
+
+		assert(vkEndCommandBuffer(cb) == VK_SUCCESS);
+
+		VkSubmitInfo submit = {};
+		submit.sType = VK_STRUCTURE_TYPE_SUBMIT_INFO;
+		submit.commandBufferCount = 1;
+		submit.pCommandBuffers = &cb;
+		{
+			std::lock_guard<std::mutex> lock(*m_base.queue_mutexes[QUEUE_RENDER]);
+			assert(vkQueueSubmit(m_base.queues[QUEUE_RENDER], 1, &submit, VK_NULL_HANDLE) == VK_SUCCESS);
+			vkQueueWaitIdle(m_base.queues[QUEUE_RENDER]);
+		}
+
+		vkFreeCommandBuffers(m_base.device, m_cpools[CPOOL_GRAPHICS], 1, &cb);
+	}
+
+	//the image is bgra, ppm is rgb
+	bool success = false;
+	std::ofstream file(filename, std::ios::binary | std::ios::trunc);
+	if (file.is_open())
+	{
+		void* data;
+		vkMapMemory(m_base.device, memory, 0, size, 0, &data);
+		auto texels = reinterpret_cast<const char*>(data);
+
+		file << "P6\n" << width << ' ' << height << "\n255\n";
+		for (VkDeviceSize i = 0; i < size; i += 4)
+		{
+			char rgb[3] = { texels[i + 2], texels[i + 1], texels[i] };
+			file.write(rgb, 3);
+		}
+
+		vkUnmapMemory(m_base.device, memory);
+		success = file.good();
+	}
+
+	vkDestroyBuffer(m_base.device, buffer, m_vk_alloc);
+	vkFreeMemory(m_base.device, memory, m_vk_alloc);
+
+	return success;
+}
\ No newline at end of file
@@ -12,11 +12,17 @@ using namespace rcq;
 
 void engine::set_terrain(base_resource* terrain, base_resource** opaque_materials)
 {
+	assert(m_base.enabled_features.sparseBinding);
+
+	if (!m_pipelines_ready)
+		finish_pipeline_creation();
+
 	bool types_valid = terrain->res_type == RES_TYPE_TERRAIN;
 	for (uint32_t i = 0; i < 4; ++i)
 	{
 		types_valid = types_valid && ((*opaque_materials)->res_type == RES_TYPE_MAT_OPAQUE);
 		while (!(*opaque_materials)->ready_bit.load());
+		(*opaque_materials)->pinned = true; //the terrain drawer cb keeps the descriptor sets
 		++opaque_materials;
 	}
 	assert(types_valid);
@@ -43,6 +49,8 @@ void engine::set_terrain(base_resource* terrain, base_resource** opaque_material
 		begin.flags = 0;
 
 		assert(vkBeginCommandBuffer(cb, &begin) == VK_SUCCESS);
+		m_gpu_profiler.reset(cb, GPU_TIMER_TERRAIN_REQUEST);
+		m_gpu_profiler.begin(cb, GPU_TIMER_TERRAIN_REQUEST);
 
 		m_cps[CP_TERRAIN_TILE_REQUEST].bind(cb, VK_PIPELINE_BIND_POINT_COMPUTE);
 		vkCmdBindDescriptorSets(cb, VK_PIPELINE_BIND_POINT_COMPUTE, m_cps[CP_TERRAIN_TILE_REQUEST].pl,
@@ -51,6 +59,7 @@ void engine::set_terrain(base_resource* terrain, base_resource** opaque_material
 		glm::uvec2 group_count = t->tile_count;
 		vkCmdDispatch(cb, group_count.x, group_count.y, 1);
 
+		m_gpu_profiler.end(cb, GPU_TIMER_TERRAIN_REQUEST);
 		assert(vkEndCommandBuffer(cb) == VK_SUCCESS);
 	}
 
@@ -70,6 +79,7 @@ void engine::set_terrain(base_resource* terrain, base_resource** opaque_material
 		begin.flags = VK_COMMAND_BUFFER_USAGE_RENDER_PASS_CONTINUE_BIT | VK_COMMAND_BUFFER_USAGE_SIMULTANEOUS_USE_BIT;
 
 		assert(vkBeginCommandBuffer(cb, &begin) == VK_SUCCESS);
+		m_gpu_profiler.begin_statistics(cb, DRAW_CATEGORY_TERRAIN);
 		m_gps[GP_TERRAIN_DRAWER].bind(cb);
 		vkCmdBindDescriptorSets(cb, VK_PIPELINE_BIND_POINT_BEGIN_RANGE, m_gps[GP_TERRAIN_DRAWER].pl,
 			1, 1, &m_terrain.ds, 0, nullptr);
@@ -79,6 +89,7 @@ void engine::set_terrain(base_resource* terrain, base_resource** opaque_material
 		vkCmdDraw(cb, 4 * t->tile_count.x,
 			t->tile_count.y, 0, 0);
 
+		m_gpu_profiler.end_statistics(cb, DRAW_CATEGORY_TERRAIN);
 		assert(vkEndCommandBuffer(cb) == VK_SUCCESS);
 	}
 
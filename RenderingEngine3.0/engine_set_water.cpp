@@ -10,6 +10,9 @@ void engine::set_water(base_resource* water)
 	assert(water->res_type == RES_TYPE_WATER);
 	while (!water->ready_bit.load());
 
+	if (!m_pipelines_ready)
+		finish_pipeline_creation();
+
 	auto w = reinterpret_cast<resource<RES_TYPE_WATER>*>(water->data);
 
 	m_water.ds = w->ds;
@@ -23,6 +26,8 @@ void engine::set_water(base_resource* water)
 	b.sType = VK_STRUCTURE_TYPE_COMMAND_BUFFER_BEGIN_INFO;
 
 	assert(vkBeginCommandBuffer(cb, &b) == VK_SUCCESS);
+	m_gpu_profiler.reset(cb, GPU_TIMER_WATER_FFT);
+	m_gpu_profiler.begin(cb, GPU_TIMER_WATER_FFT);
 
 	//acquire barrier
 	{
@@ -51,7 +56,7 @@ void engine::set_water(base_resource* water)
 
 	uint32_t fft_axis = 0;
 	vkCmdPushConstants(cb, m_cps[CP_WATER_FFT].pl, VK_SHADER_STAGE_COMPUTE_BIT, 0, sizeof(uint32_t), &fft_axis);
-	vkCmdDispatch(cb, 1, 1024, 1);
+	vkCmdDispatch(cb, 1, w->grid_size, 1);
 
 	//memory barrier
 	{
@@ -74,7 +79,7 @@ void engine::set_water(base_resource* water)
 
 	fft_axis = 1;
 	vkCmdPushConstants(cb, m_cps[CP_WATER_FFT].pl, VK_SHADER_STAGE_COMPUTE_BIT, 0, sizeof(uint32_t), &fft_axis);
-	vkCmdDispatch(cb, 1, 1024, 1);
+	vkCmdDispatch(cb, 1, w->grid_size, 1);
 
 	//release barrier
 	{
@@ -97,6 +102,7 @@ void engine::set_water(base_resource* water)
 			0, 0, nullptr, 0, nullptr, 1, &b);
 	}
 
+	m_gpu_profiler.end(cb, GPU_TIMER_WATER_FFT);
 	assert(vkEndCommandBuffer(cb) == VK_SUCCESS);
 
 	m_water_valid = true;
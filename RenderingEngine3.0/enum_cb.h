@@ -6,7 +6,9 @@ namespace rcq
 {
 	enum CB : uint32_t
 	{
+		CB_RES_DATA_COPY,
 		CB_RENDER,
+		CB_RENDER_WATER,
 		CB_TERRAIN_REQUEST,
 		CB_WATER_FFT,
 		CB_BLOOM,
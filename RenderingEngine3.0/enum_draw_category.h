@@ -0,0 +1,16 @@
+#pragma once
+
+#include <stdint.h>
+
+namespace rcq
+{
+	//draws with their own pipeline statistics query, the ones recorded in the render cb come first
+	enum DRAW_CATEGORY : uint32_t
+	{
+		DRAW_CATEGORY_OPAQUE_OBJECTS,
+		DRAW_CATEGORY_DIR_SHADOW,
+		DRAW_CATEGORY_TERRAIN,
+		DRAW_CATEGORY_WATER,
+		DRAW_CATEGORY_COUNT
+	};
+}
\ No newline at end of file
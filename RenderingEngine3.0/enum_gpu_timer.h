@@ -0,0 +1,25 @@
+#pragma once
+
+#include <stdint.h>
+
+namespace rcq
+{
+	//grouped by the command buffer the timestamps are written in
+	enum GPU_TIMER : uint32_t
+	{
+		GPU_TIMER_TERRAIN_REQUEST,
+		GPU_TIMER_WATER_FFT,
+		GPU_TIMER_ENVIRONMENT_MAP_GEN,
+		GPU_TIMER_DIR_SHADOW_MAP_GEN,
+		GPU_TIMER_GBUFFER_ASSEMBLER,
+		GPU_TIMER_SSAO_GEN,
+		GPU_TIMER_PREIMAGE_ASSEMBLER,
+		GPU_TIMER_SSR_RAY_CASTING,
+		GPU_TIMER_SKY_DRAWER,
+		GPU_TIMER_REFRACTION_IMAGE_GEN,
+		GPU_TIMER_WATER_DRAWER,
+		GPU_TIMER_BLOOM,
+		GPU_TIMER_POSTPROCESSING,
+		GPU_TIMER_COUNT
+	};
+}
\ No newline at end of file
@@ -4,11 +4,14 @@
 
 namespace rcq
 {
-	enum MEMORY_TYPE : uint32_t //for Geforce GTX950m 
+	//roles of the memory types, base_info::memory_types has the type index picked for each on the device
+	enum MEMORY_TYPE : uint32_t
 	{
-		MEMORY_TYPE_DL0=7, //device local, mainly for buffers
-		MEMORY_TYPE_DL1=8, //device local, mainly for images
-		MEMORY_TYPE_HVC=9, //host visible, coherent
-		MEMORY_TYPE_HVCC=10 //host visible, coherent, cached
+		MEMORY_TYPE_DL0, //device local, mainly for buffers
+		MEMORY_TYPE_DL1, //device local, mainly for images
+		MEMORY_TYPE_HVC, //host visible, coherent
+		MEMORY_TYPE_HVCC, //host visible, coherent, cached if the device has such a type
+		MEMORY_TYPE_LAZY, //device local, lazily allocated if the device has such a type, for transient attachments
+		MEMORY_TYPE_COUNT
 	};
 }
\ No newline at end of file
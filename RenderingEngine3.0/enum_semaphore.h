@@ -10,6 +10,8 @@ namespace rcq
 		SEMAPHORE_BLOOM_READY,
 		SEMAPHORE_IMAGE_AVAILABLE,
 		SEMAPHORE_RENDER_FINISHED,
+		SEMAPHORE_RES_DATA_COPIED,
+		SEMAPHORE_WATER_FFT_FINISHED,
 		SEMAPHORE_COUNT
 	};
 }
\ No newline at end of file
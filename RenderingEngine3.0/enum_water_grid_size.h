@@ -0,0 +1,13 @@
+#pragma once
+
+#include <stdint.h>
+
+namespace rcq
+{
+	enum WATER_GRID_SIZE : uint32_t
+	{
+		WATER_GRID_SIZE_256 = 256,
+		WATER_GRID_SIZE_512 = 512,
+		WATER_GRID_SIZE_1024 = 1024
+	};
+}
\ No newline at end of file
@@ -47,6 +47,9 @@ namespace rcq
 			m_end->prev_free = b;
 			m_end->prev_res = m_begin;
 			m_end->free = false;
+
+			m_accounting.upstream_allocated(size);
+			account_free_blocks();
 		}
 
 		void init(VkDeviceSize size, VkDeviceSize alignment, device_memory* upstream,
@@ -83,6 +86,9 @@ namespace rcq
 			m_end->prev_free = b;
 			m_end->prev_res = m_begin;
 			m_end->free = false;
+
+			m_accounting.upstream_allocated(size);
+			account_free_blocks();
 		}
 
 		void reset()
@@ -107,6 +113,21 @@ namespace rcq
 		{}
 
 		VkDeviceSize allocate(VkDeviceSize size, VkDeviceSize alignment) override
+		{
+			return allocate(size, alignment, nullptr);
+		}
+
+		//owner tags the allocation, the defragmentation finds the resources to move by it
+		VkDeviceSize allocate(VkDeviceSize size, VkDeviceSize alignment, const void* owner)
+		{
+			VkDeviceSize p;
+			bool fits = try_allocate(size, alignment, owner, p);
+			assert(fits);
+			return p;
+		}
+
+		//best fit, returns false if no free block is large enough
+		bool try_allocate(VkDeviceSize size, VkDeviceSize alignment, const void* owner, VkDeviceSize& p)
 		{
 			assert(alignment <= m_max_alignment);
 
@@ -136,9 +157,110 @@ namespace rcq
 				b = b->next_free;
 			}
 
-			assert(choosen_block != nullptr);
+			if (choosen_block == nullptr)
+				return false;
+
+			use_block(choosen_block, aligned_end, owner);
+			p = aligned_begin;
+			return true;
+		}
+
+		//the lowest free range that ends below limit, returns limit if there is none
+		VkDeviceSize allocate_below(VkDeviceSize size, VkDeviceSize alignment, VkDeviceSize limit, const void* owner)
+		{
+			assert(alignment <= m_max_alignment);
+
+			alignment = alignment < alignof(block) ? alignof(block) : alignment;
+			size = align(size, alignof(block));
+
+			for (block* b = m_begin->next; b != m_end && b->begin < limit; b = b->next)
+			{
+				if (!b->free)
+					continue;
+
+				VkDeviceSize aligned_begin = align(b->begin, alignment);
+				VkDeviceSize aligned_end = aligned_begin + size;
+				if (aligned_end <= b->end && aligned_end <= limit)
+				{
+					use_block(b, aligned_end, owner);
+					return aligned_begin;
+				}
+			}
+			return limit;
+		}
+
+		//the begin of the lowest free range, max if nothing is free
+		VkDeviceSize lowest_free() const
+		{
+			VkDeviceSize lowest = std::numeric_limits<VkDeviceSize>::max();
+			for (block* b = m_begin->next_free; b != m_end; b = b->next_free)
+				lowest = b->begin < lowest ? b->begin : lowest;
+			return lowest;
+		}
+
+		//the owners of the allocations above limit from the highest address down, returns false if f stopped the walk
+		template<typename Callable>
+		bool for_each_owner_above(VkDeviceSize limit, Callable&& f)
+		{
+			for (block* b = m_end->prev; b != m_begin && b->begin > limit; b = b->prev)
+			{
+				if (!b->free && b->owner != nullptr && !f(b->owner))
+					return false;
+			}
+			return true;
+		}
+
+		//nothing is allocated, the whole range is one free block
+		bool unused() const
+		{
+			return m_begin->next->free && m_begin->next->next == m_end;
+		}
+
+		void deallocate(VkDeviceSize p)
+		{
+			block* dealloc_block=m_begin->next_res;
+			while (!(dealloc_block->begin <= p && p < dealloc_block->end))
+				dealloc_block = dealloc_block->next_res;
+
+			free_block(dealloc_block);
+			account_free_blocks();
+		}
+
+		//offsets must be sorted, the blocks are found with one walk in address order
+		void deallocate(const VkDeviceSize* offsets, size_t count)
+		{
+			block* b = m_begin->next;
+			for (size_t i = 0; i < count; ++i)
+			{
+				while (!(b->begin <= offsets[i] && offsets[i] < b->end))
+					b = b->next;
+				b = free_block(b);
+			}
+			account_free_blocks();
+		}
+
+	private:
+		struct block
+		{
+			VkDeviceSize begin;
+			VkDeviceSize end;
+			block* prev;
+			block* next;
+			block* prev_free;
+			block* next_free;
+			block* prev_res;
+			block* next_res;
+			const void* owner;
+			bool free;
+		};
+
+		//the free block holds the allocation up to aligned_end, the rest is split off if it is large enough
+		void use_block(block* choosen_block, VkDeviceSize aligned_end, const void* owner)
+		{
+			VkDeviceSize remaining = choosen_block->end - aligned_end;
 
 			choosen_block->free = false;
+			choosen_block->owner = owner;
 			choosen_block->prev_free->next_free = choosen_block->next_free;
 			choosen_block->next_free->prev_free = choosen_block->prev_free;
 
@@ -176,21 +298,21 @@ namespace rcq
 				choosen_block->end = aligned_end;
 			}
 
-
-			return aligned_begin;
+			m_accounting.allocated(choosen_block->end - choosen_block->begin);
+			account_free_blocks();
 		}
 
-		void deallocate(VkDeviceSize p)
+		//returns the free block that contains the range of dealloc_block after coalescing
+		block* free_block(block* dealloc_block)
 		{
-			block* dealloc_block=m_begin->next_res;
-			while (!(dealloc_block->begin <= p && p < dealloc_block->end))
-				dealloc_block = dealloc_block->next_res;
+			m_accounting.deallocated(dealloc_block->end - dealloc_block->begin);
 
 			dealloc_block->next_res->prev_res = dealloc_block->prev_res;
 			dealloc_block->prev_res->next_res = dealloc_block->next_res;
 
 			if (dealloc_block->next->free && dealloc_block->prev->free)
 			{
+				block* merged = dealloc_block->prev;
 				dealloc_block->prev->next = dealloc_block->next->next;
 				dealloc_block->prev->next->prev = dealloc_block->prev;
 				dealloc_block->prev->end = dealloc_block->next->end;
@@ -200,24 +322,29 @@ namespace rcq
 
 				dealloc_block->next->next = m_end->next;
 				m_end->next = dealloc_block;
+				return merged;
 			}
 			else if (dealloc_block->next->free)
 			{
+				block* merged = dealloc_block->next;
 				dealloc_block->next->prev = dealloc_block->prev;
 				dealloc_block->prev->next = dealloc_block->next;
 				dealloc_block->next->begin = dealloc_block->begin;
 
 				dealloc_block->next = m_end->next;
 				m_end->next = dealloc_block;
+				return merged;
 			}
 			else if (dealloc_block->prev->free)
 			{
+				block* merged = dealloc_block->prev;
 				dealloc_block->prev->next = dealloc_block->next;
 				dealloc_block->next->prev = dealloc_block->prev;
 				dealloc_block->prev->end = dealloc_block->end;
 
 				dealloc_block->next = m_end->next;
 				m_end->next = dealloc_block;
+				return merged;
 			}
 			else
 			{
@@ -226,22 +353,25 @@ namespace rcq
 				dealloc_block->prev_free = m_begin;
 				dealloc_block->next_free->prev_free = dealloc_block;
 				dealloc_block->prev_free->next_free = dealloc_block;
+				return dealloc_block;
 			}
 		}
 
-	private:
-		struct block
+		//walks the free list, only if the stats are kept
+		void account_free_blocks()
 		{
-			VkDeviceSize begin;
-			VkDeviceSize end;
-			block* prev;
-			block* next;
-			block* prev_free;
-			block* next_free;
-			block* prev_res;
-			block* next_res;
-			bool free;
-		};
+#ifdef RCQ_MEMORY_STATS
+			VkDeviceSize largest = 0;
+			VkDeviceSize free = 0;
+			for (block* b = m_begin->next_free; b != m_end; b = b->next_free)
+			{
+				VkDeviceSize size = b->end - b->begin;
+				largest = size > largest ? size : largest;
+				free += size;
+			}
+			m_accounting.free_blocks(largest, free);
+#endif
+		}
 
 		block* m_begin;
 		block* m_end;
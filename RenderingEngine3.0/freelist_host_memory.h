@@ -40,6 +40,9 @@ namespace rcq
 			m_end->prev = b;
 			m_begin->next_free = b;
 			m_end->prev_free = b;
+
+			m_accounting.upstream_allocated(size);
+			account_free_blocks();
 		}
 
 		void init(size_t size, size_t max_alignment, host_memory* upstream)
@@ -69,6 +72,9 @@ namespace rcq
 			m_end->prev = b;
 			m_begin->next_free = b;
 			m_end->prev_free = b;
+
+			m_accounting.upstream_allocated(size);
+			account_free_blocks();
 		}
 
 		void reset()
@@ -146,6 +152,8 @@ namespace rcq
 				choosen_block->end = aligned_end;
 			}
 
+			m_accounting.allocated(choosen_block->end - aligned_begin);
+			account_free_blocks();
 
 			return aligned_begin;
 		}
@@ -153,6 +161,7 @@ namespace rcq
 		void deallocate(size_t p) override
 		{
 			block* dealloc_block = reinterpret_cast<block*>(p - sizeof(block));
+			m_accounting.deallocated(dealloc_block->end - p);
 
 			if (dealloc_block->next->free && dealloc_block->prev->free)
 			{
@@ -183,6 +192,8 @@ namespace rcq
 				dealloc_block->next_free->prev_free = dealloc_block;
 				dealloc_block->prev_free->next_free = dealloc_block;
 			}
+
+			account_free_blocks();
 		}
 
 	private:
@@ -197,6 +208,23 @@ namespace rcq
 			bool free;
 
 		};
+
+		//walks the free list, only if the stats are kept
+		void account_free_blocks()
+		{
+#ifdef RCQ_MEMORY_STATS
+			size_t largest = 0;
+			size_t free = 0;
+			for (block* b = m_begin->next_free; b != m_end; b = b->next_free)
+			{
+				size_t size = b->end - b->begin - sizeof(block);
+				largest = size > largest ? size : largest;
+				free += size;
+			}
+			m_accounting.free_blocks(largest, free);
+#endif
+		}
+
 		block* m_begin;
 		block* m_end;
 	};
@@ -0,0 +1,20 @@
+#include "futex.h"
+
+#define NOMINMAX
+#define WIN32_LEAN_AND_MEAN
+#include <Windows.h>
+
+#pragma comment(lib, "Synchronization.lib")
+
+using namespace rcq;
+
+void rcq::futex_wait(const std::atomic<uint32_t>* address, uint32_t expected)
+{
+	static_assert(sizeof(std::atomic<uint32_t>) == sizeof(uint32_t));
+	WaitOnAddress(const_cast<std::atomic<uint32_t>*>(address), &expected, sizeof(uint32_t), INFINITE);
+}
+
+void rcq::futex_wake_all(const std::atomic<uint32_t>* address)
+{
+	WakeByAddressAll(const_cast<std::atomic<uint32_t>*>(address));
+}
\ No newline at end of file
@@ -0,0 +1,12 @@
+#pragma once
+
+#include <atomic>
+#include <stdint.h>
+
+namespace rcq
+{
+	//blocks while the value at address equals expected, it may return spuriously
+	void futex_wait(const std::atomic<uint32_t>* address, uint32_t expected);
+
+	void futex_wake_all(const std::atomic<uint32_t>* address);
+}
\ No newline at end of file
@@ -1,6 +1,9 @@
 #pragma once
 
 #include "gp_create_info.h"
+#include "shader_code.h"
+#include "shaders/dir_shadow_map_gen/vert.h"
+#include "shaders/dir_shadow_map_gen/geom.h"
 #include "vertex.h"
 #include "const_dir_shadow_map_size.h"
 
@@ -97,10 +100,10 @@ namespace rcq
 			1,
 			&scissor
 		};
-		static constexpr std::array<const char*, 2> shader_filenames =
+		static constexpr std::array<shader_code, 2> shader_codes =
 		{
-			"shaders/dir_shadow_map_gen/vert.spv",
-			"shaders/dir_shadow_map_gen/geom.spv"
+			shader_code{ spirv_dir_shadow_map_gen_vert, sizeof(spirv_dir_shadow_map_gen_vert) },
+			shader_code{ spirv_dir_shadow_map_gen_geom, sizeof(spirv_dir_shadow_map_gen_geom) }
 		};
 		static constexpr std::array<VkShaderStageFlagBits, 2> shader_flags =
 		{
@@ -1,6 +1,10 @@
 #pragma once
 
 #include "gp_create_info.h"
+#include "shader_code.h"
+#include "shaders/environment_map_gen/environment_map_gen_mat/vert.h"
+#include "shaders/environment_map_gen/environment_map_gen_mat/geom.h"
+#include "shaders/environment_map_gen/environment_map_gen_mat/frag.h"
 #include "vertex.h"
 #include "const_environment_map_size.h"
 
@@ -119,11 +123,11 @@ namespace rcq
 			1,
 			&scissor
 		};
-		static constexpr std::array<const char*, 3> shader_filenames =
+		static constexpr std::array<shader_code, 3> shader_codes =
 		{
-			"shaders/environment_map_gen/environment_map_gen_mat/vert.spv",
-			"shaders/environment_map_gen/environment_map_gen_mat/geom.spv",
-			"shaders/environment_map_gen/environment_map_gen_mat/frag.spv"
+			shader_code{ spirv_environment_map_gen_mat_vert, sizeof(spirv_environment_map_gen_mat_vert) },
+			shader_code{ spirv_environment_map_gen_mat_geom, sizeof(spirv_environment_map_gen_mat_geom) },
+			shader_code{ spirv_environment_map_gen_mat_frag, sizeof(spirv_environment_map_gen_mat_frag) }
 		};
 		static constexpr std::array<VkShaderStageFlagBits, 3> shader_flags =
 		{
@@ -1,6 +1,9 @@
 #pragma once
 
 #include "gp_create_info.h"
+#include "shader_code.h"
+#include "shaders/refraction_map_gen/vert.h"
+#include "shaders/refraction_map_gen/frag.h"
 #include <array>
 #include "const_swap_chain_image_extent.h"
 
@@ -133,12 +136,12 @@ namespace rcq
 			1,
 			&scissor
 		};
-		static constexpr std::array<const char*, 2> shader_filenames =
+		static constexpr std::array<shader_code, 2> shader_codes =
 		{
-			"shaders/refraction_map_gen/vert.spv",
-			"shaders/refraction_map_gen/frag.spv"
+			shader_code{ spirv_refraction_map_gen_vert, sizeof(spirv_refraction_map_gen_vert) },
+			shader_code{ spirv_refraction_map_gen_frag, sizeof(spirv_refraction_map_gen_frag) }
 		};
-		static constexpr std::array<VkShaderStageFlagBits, 3> shader_flags =
+		static constexpr std::array<VkShaderStageFlagBits, 2> shader_flags =
 		{
 			VK_SHADER_STAGE_VERTEX_BIT,
 			VK_SHADER_STAGE_FRAGMENT_BIT
@@ -1,6 +1,10 @@
 #pragma once
 
 #include "gp_create_info.h"
+#include "shader_code.h"
+#include "shaders/sky/vert.h"
+#include "shaders/sky/geom.h"
+#include "shaders/sky/frag.h"
 #include <array>
 #include "const_swap_chain_image_extent.h"
 
@@ -117,11 +121,11 @@ namespace rcq
 			1,
 			&scissor
 		};
-		static constexpr std::array<const char*, 3> shader_filenames =
+		static constexpr std::array<shader_code, 3> shader_codes =
 		{
-			"shaders/sky/vert.spv",
-			"shaders/sky/geom.spv",
-			"shaders/sky/frag.spv"
+			shader_code{ spirv_sky_vert, sizeof(spirv_sky_vert) },
+			shader_code{ spirv_sky_geom, sizeof(spirv_sky_geom) },
+			shader_code{ spirv_sky_frag, sizeof(spirv_sky_frag) }
 		};
 		static constexpr std::array<VkShaderStageFlagBits, 3> shader_flags =
 		{
@@ -1,6 +1,9 @@
 #pragma once
 
 #include "gp_create_info.h"
+#include "shader_code.h"
+#include "shaders/ss_dir_shadow_map_blur/vert.h"
+#include "shaders/ss_dir_shadow_map_blur/frag.h"
 #include <array>
 #include "const_swap_chain_image_extent.h"
 
@@ -104,10 +107,10 @@ namespace rcq
 			1,
 			&scissor
 		};
-		static constexpr std::array<const char*, 2> shader_filenames =
+		static constexpr std::array<shader_code, 2> shader_codes =
 		{
-			"shaders/ss_dir_shadow_map_blur/vert.spv",
-			"shaders/ss_dir_shadow_map_blur/frag.spv"
+			shader_code{ spirv_ss_dir_shadow_map_blur_vert, sizeof(spirv_ss_dir_shadow_map_blur_vert) },
+			shader_code{ spirv_ss_dir_shadow_map_blur_frag, sizeof(spirv_ss_dir_shadow_map_blur_frag) }
 		};
 		static constexpr std::array<VkShaderStageFlagBits, 2> shader_flags =
 		{
@@ -1,6 +1,9 @@
 #pragma once
 
 #include "gp_create_info.h"
+#include "shader_code.h"
+#include "shaders/ssao_gen/vert.h"
+#include "shaders/ssao_gen/frag.h"
 #include <array>
 #include "const_swap_chain_image_extent.h"
 
@@ -96,10 +99,10 @@ namespace rcq
 			1,
 			&scissor
 		};
-		static constexpr std::array<const char*, 2> shader_filenames =
+		static constexpr std::array<shader_code, 2> shader_codes =
 		{
-			"shaders/ssao_gen/vert.spv",
-			"shaders/ssao_gen/frag.spv"
+			shader_code{ spirv_ssao_gen_vert, sizeof(spirv_ssao_gen_vert) },
+			shader_code{ spirv_ssao_gen_frag, sizeof(spirv_ssao_gen_frag) }
 		};
 		static constexpr std::array<VkShaderStageFlagBits, 2> shader_flags =
 		{
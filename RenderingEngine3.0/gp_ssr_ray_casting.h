@@ -1,6 +1,10 @@
 #pragma once
 
 #include "gp_create_info.h"
+#include "shader_code.h"
+#include "shaders/ssr_ray_casting/vert.h"
+#include "shaders/ssr_ray_casting/geom.h"
+#include "shaders/ssr_ray_casting/frag.h"
 #include <array>
 #include "const_swap_chain_image_extent.h"
 
@@ -95,11 +99,11 @@ namespace rcq
 			1,
 			&scissor
 		};
-		static constexpr std::array<const char*, 3> shader_filenames =
+		static constexpr std::array<shader_code, 3> shader_codes =
 		{
-			"shaders/ssr_ray_casting/vert.spv",
-			"shaders/ssr_ray_casting/geom.spv",
-			"shaders/ssr_ray_casting/frag.spv"
+			shader_code{ spirv_ssr_ray_casting_vert, sizeof(spirv_ssr_ray_casting_vert) },
+			shader_code{ spirv_ssr_ray_casting_geom, sizeof(spirv_ssr_ray_casting_geom) },
+			shader_code{ spirv_ssr_ray_casting_frag, sizeof(spirv_ssr_ray_casting_frag) }
 		};
 		static constexpr std::array<VkShaderStageFlagBits, 3> shader_flags =
 		{
@@ -1,6 +1,9 @@
 #pragma once
 
 #include "gp_create_info.h"
+#include "shader_code.h"
+#include "shaders/sun/vert.h"
+#include "shaders/sun/frag.h"
 #include <array>
 #include "const_swap_chain_image_extent.h"
 
@@ -117,10 +120,10 @@ namespace rcq
 			1,
 			&scissor
 		};
-		static constexpr std::array<const char*, 2> shader_filenames =
+		static constexpr std::array<shader_code, 2> shader_codes =
 		{
-			"shaders/sun/vert.spv",
-			"shaders/sun/frag.spv"
+			shader_code{ spirv_sun_vert, sizeof(spirv_sun_vert) },
+			shader_code{ spirv_sun_frag, sizeof(spirv_sun_frag) }
 		};
 		static constexpr std::array<VkShaderStageFlagBits, 2> shader_flags =
 		{
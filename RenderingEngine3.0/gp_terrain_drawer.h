@@ -1,6 +1,11 @@
 #pragma once
 
 #include "gp_create_info.h"
+#include "shader_code.h"
+#include "shaders/terrain/vert.h"
+#include "shaders/terrain/tesc.h"
+#include "shaders/terrain/tese.h"
+#include "shaders/terrain/frag.h"
 #include <array>
 #include "const_swap_chain_image_extent.h"
 
@@ -159,12 +164,12 @@ namespace rcq
 			1,
 			&scissor
 		};
-		static constexpr std::array<const char*, 4> shader_filenames =
+		static constexpr std::array<shader_code, 4> shader_codes =
 		{
-			"shaders/terrain/vert.spv",
-			"shaders/terrain/tesc.spv",
-			"shaders/terrain/tese.spv",
-			"shaders/terrain/frag.spv",
+			shader_code{ spirv_terrain_vert, sizeof(spirv_terrain_vert) },
+			shader_code{ spirv_terrain_tesc, sizeof(spirv_terrain_tesc) },
+			shader_code{ spirv_terrain_tese, sizeof(spirv_terrain_tese) },
+			shader_code{ spirv_terrain_frag, sizeof(spirv_terrain_frag) }
 		};
 		static constexpr std::array<VkShaderStageFlagBits, 4> shader_flags =
 		{
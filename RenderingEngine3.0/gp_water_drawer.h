@@ -1,6 +1,11 @@
 #pragma once
 
 #include "gp_create_info.h"
+#include "shader_code.h"
+#include "shaders/water_drawer/vert.h"
+#include "shaders/water_drawer/tesc.h"
+#include "shaders/water_drawer/tese.h"
+#include "shaders/water_drawer/frag.h"
 #include <array>
 #include "const_swap_chain_image_extent.h"
 
@@ -124,12 +129,12 @@ namespace rcq
 			1,
 			&scissor
 		};
-		static constexpr std::array<const char*, 4> shader_filenames =
+		static constexpr std::array<shader_code, 4> shader_codes =
 		{
-			"shaders/water_drawer/vert.spv",
-			"shaders/water_drawer/tesc.spv",
-			"shaders/water_drawer/tese.spv",
-			"shaders/water_drawer/frag.spv",
+			shader_code{ spirv_water_drawer_vert, sizeof(spirv_water_drawer_vert) },
+			shader_code{ spirv_water_drawer_tesc, sizeof(spirv_water_drawer_tesc) },
+			shader_code{ spirv_water_drawer_tese, sizeof(spirv_water_drawer_tese) },
+			shader_code{ spirv_water_drawer_frag, sizeof(spirv_water_drawer_frag) }
 		};
 		static constexpr std::array<VkShaderStageFlagBits, 4> shader_flags =
 		{
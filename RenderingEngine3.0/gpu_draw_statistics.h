@@ -0,0 +1,25 @@
+#pragma once
+
+#include "enum_draw_category.h"
+
+#include <stdint.h>
+
+namespace rcq
+{
+	//the members follow the order of the query results, which is the order of the statistic bits
+	struct pipeline_statistics
+	{
+		uint64_t vertex_shader_invocations;
+		uint64_t clipping_primitives;
+		uint64_t fragment_shader_invocations;
+		uint64_t tessellation_control_shader_patches;
+		uint64_t tessellation_evaluation_shader_invocations;
+	};
+
+	struct gpu_draw_statistics
+	{
+		uint64_t frame_index;
+		pipeline_statistics draw_categories[DRAW_CATEGORY_COUNT];
+		uint32_t valid_mask; //a bit for every DRAW_CATEGORY that was drawn and whose results were ready
+	};
+}
\ No newline at end of file
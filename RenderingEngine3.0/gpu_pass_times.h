@@ -0,0 +1,15 @@
+#pragma once
+
+#include "enum_gpu_timer.h"
+
+#include <stdint.h>
+
+namespace rcq
+{
+	struct gpu_pass_times
+	{
+		uint64_t frame_index;
+		float pass_times[GPU_TIMER_COUNT]; //ms, negative if the pass did not run or its result was not ready
+		float frame_time; //ms, from the first to the last timestamp of the frame
+	};
+}
\ No newline at end of file
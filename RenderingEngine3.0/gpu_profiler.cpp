@@ -0,0 +1,202 @@
+#include "gpu_profiler.h"
+
+#include <fstream>
+#include <string.h>
+#include <assert.h>
+
+using namespace rcq;
+
+static const char* const GPU_TIMER_NAMES[GPU_TIMER_COUNT] =
+{
+	"terrain_request",
+	"water_fft",
+	"environment_map_gen",
+	"dir_shadow_map_gen",
+	"gbuffer_assembler",
+	"ssao_gen",
+	"preimage_assembler",
+	"ssr_ray_casting",
+	"sky_drawer",
+	"refraction_image_gen",
+	"water_drawer",
+	"bloom",
+	"postprocessing"
+};
+
+const char* gpu_profiler::timer_name(GPU_TIMER timer)
+{
+	return GPU_TIMER_NAMES[timer];
+}
+
+void gpu_profiler::init(const base_info& base, const VkAllocationCallbacks* alloc)
+{
+	m_device = base.device;
+	m_submitted_timer_mask = 0;
+	m_submitted_draw_category_mask = 0;
+	m_frame_index = 0;
+	m_logged_frame_count = 0;
+	m_draw_statistics = {};
+
+	//the log starts with an empty frame, so last_frame is valid before the first results
+	m_log[GPU_PROFILER_LOG_FRAME_COUNT - 1].frame_index = 0;
+	for (auto& t : m_log[GPU_PROFILER_LOG_FRAME_COUNT - 1].pass_times)
+		t = -1.f;
+	m_log[GPU_PROFILER_LOG_FRAME_COUNT - 1].frame_time = -1.f;
+
+	VkPhysicalDeviceProperties props;
+	vkGetPhysicalDeviceProperties(base.physical_device, &props);
+	m_timestamp_period = props.limits.timestampPeriod;
+
+	uint32_t family_count;
+	vkGetPhysicalDeviceQueueFamilyProperties(base.physical_device, &family_count, nullptr);
+	VkQueueFamilyProperties families[16];
+	family_count = family_count < 16 ? family_count : 16;
+	vkGetPhysicalDeviceQueueFamilyProperties(base.physical_device, &family_count, families);
+
+	uint32_t valid_bits = base.queue_family_index < family_count ? families[base.queue_family_index].timestampValidBits : 0;
+	m_timestamp_mask = valid_bits >= 64 ? ~uint64_t(0) : (uint64_t(1) << valid_bits) - 1;
+
+	VkQueryPoolCreateInfo qp = {};
+	qp.sType = VK_STRUCTURE_TYPE_QUERY_POOL_CREATE_INFO;
+	qp.queryType = VK_QUERY_TYPE_TIMESTAMP;
+	qp.queryCount = 2 * GPU_TIMER_COUNT;
+	assert(vkCreateQueryPool(m_device, &qp, alloc, &m_qp) == VK_SUCCESS);
+
+	m_statistics_enabled = base.enabled_features.pipelineStatisticsQuery == VK_TRUE;
+	if (m_statistics_enabled)
+	{
+		VkQueryPoolCreateInfo qp = {};
+		qp.sType = VK_STRUCTURE_TYPE_QUERY_POOL_CREATE_INFO;
+		qp.queryType = VK_QUERY_TYPE_PIPELINE_STATISTICS;
+		qp.queryCount = DRAW_CATEGORY_COUNT;
+		qp.pipelineStatistics = 
+			VK_QUERY_PIPELINE_STATISTIC_VERTEX_SHADER_INVOCATIONS_BIT |
+			VK_QUERY_PIPELINE_STATISTIC_CLIPPING_PRIMITIVES_BIT |
+			VK_QUERY_PIPELINE_STATISTIC_FRAGMENT_SHADER_INVOCATIONS_BIT |
+			VK_QUERY_PIPELINE_STATISTIC_TESSELLATION_CONTROL_SHADER_PATCHES_BIT |
+			VK_QUERY_PIPELINE_STATISTIC_TESSELLATION_EVALUATION_SHADER_INVOCATIONS_BIT;
+		assert(vkCreateQueryPool(m_device, &qp, alloc, &m_statistics_qp) == VK_SUCCESS);
+	}
+}
+
+void gpu_profiler::destroy(const VkAllocationCallbacks* alloc)
+{
+	vkDestroyQueryPool(m_device, m_qp, alloc);
+	if (m_statistics_enabled)
+		vkDestroyQueryPool(m_device, m_statistics_qp, alloc);
+}
+
+void gpu_profiler::read_results()
+{
+	if (m_statistics_enabled && m_submitted_draw_category_mask != 0)
+		read_statistics();
+
+	if (m_submitted_timer_mask == 0)
+		return;
+
+	gpu_pass_times& times = m_log[m_logged_frame_count % GPU_PROFILER_LOG_FRAME_COUNT];
+	times.frame_index = m_frame_index++;
+
+	uint64_t first = ~uint64_t(0);
+	uint64_t last = 0;
+	for (uint32_t i = 0; i < GPU_TIMER_COUNT; ++i)
+	{
+		times.pass_times[i] = -1.f;
+		if ((m_submitted_timer_mask & (1 << i)) == 0)
+			continue;
+
+		//only the queries written in the submitted cbs are read, they are never waited for
+		uint64_t results[4]; //begin, availability, end, availability
+		vkGetQueryPoolResults(m_device, m_qp, 2 * i, 2, sizeof(results), results, 2 * sizeof(uint64_t),
+			VK_QUERY_RESULT_64_BIT | VK_QUERY_RESULT_WITH_AVAILABILITY_BIT);
+		if (results[1] == 0 || results[3] == 0)
+			continue;
+
+		uint64_t begin = results[0] & m_timestamp_mask;
+		uint64_t end = results[2] & m_timestamp_mask;
+		times.pass_times[i] = static_cast<float>(((end - begin) & m_timestamp_mask) * m_timestamp_period * 1e-6);
+
+		first = begin < first ? begin : first;
+		last = end > last ? end : last;
+	}
+	times.frame_time = first <= last ? static_cast<float>((last - first) * m_timestamp_period * 1e-6) : -1.f;
+
+	m_submitted_timer_mask = 0;
+	++m_logged_frame_count;
+}
+
+void gpu_profiler::read_statistics()
+{
+	m_draw_statistics.frame_index = m_frame_index;
+	m_draw_statistics.valid_mask = 0;
+	for (uint32_t i = 0; i < DRAW_CATEGORY_COUNT; ++i)
+	{
+		if ((m_submitted_draw_category_mask & (1 << i)) == 0)
+			continue;
+
+		//the counters are followed by the availability
+		uint64_t results[sizeof(pipeline_statistics) / sizeof(uint64_t) + 1];
+		vkGetQueryPoolResults(m_device, m_statistics_qp, i, 1, sizeof(results), results, sizeof(results),
+			VK_QUERY_RESULT_64_BIT | VK_QUERY_RESULT_WITH_AVAILABILITY_BIT);
+		if (results[sizeof(pipeline_statistics) / sizeof(uint64_t)] == 0)
+			continue;
+
+		memcpy(&m_draw_statistics.draw_categories[i], results, sizeof(pipeline_statistics));
+		m_draw_statistics.valid_mask |= 1 << i;
+	}
+	m_submitted_draw_category_mask = 0;
+}
+
+bool gpu_profiler::save_log(const char* filename) const
+{
+	std::ofstream file(filename, std::ios::trunc);
+	if (!file.is_open())
+		return false;
+
+	size_t length = strlen(filename);
+	bool json = length >= 5 && strcmp(filename + length - 5, ".json") == 0;
+
+	uint64_t frame_count = m_logged_frame_count < GPU_PROFILER_LOG_FRAME_COUNT ? m_logged_frame_count : GPU_PROFILER_LOG_FRAME_COUNT;
+	uint64_t first_frame = m_logged_frame_count - frame_count;
+
+	if (json)
+	{
+		file << "{\n\t\"unit\": \"ms\",\n\t\"frames\": [";
+		for (uint64_t f = first_frame; f < m_logged_frame_count; ++f)
+		{
+			const gpu_pass_times& times = m_log[f % GPU_PROFILER_LOG_FRAME_COUNT];
+			file << (f == first_frame ? "\n" : ",\n") << "\t\t{ \"frame\": " << times.frame_index;
+			for (uint32_t i = 0; i < GPU_TIMER_COUNT; ++i)
+			{
+				if (times.pass_times[i] >= 0.f)
+					file << ", \"" << GPU_TIMER_NAMES[i] << "\": " << times.pass_times[i];
+			}
+			file << ", \"frame_time\": " << times.frame_time << " }";
+		}
+		file << "\n\t]\n}\n";
+	}
+	else
+	{
+		file << "frame";
+		for (auto name : GPU_TIMER_NAMES)
+			file << ',' << name;
+		file << ",frame_time\n";
+
+		//the passes that did not run are left empty
+		for (uint64_t f = first_frame; f < m_logged_frame_count; ++f)
+		{
+			const gpu_pass_times& times = m_log[f % GPU_PROFILER_LOG_FRAME_COUNT];
+			file << times.frame_index;
+			for (auto t : times.pass_times)
+			{
+				file << ',';
+				if (t >= 0.f)
+					file << t;
+			}
+			file << ',' << times.frame_time << '\n';
+		}
+	}
+
+	file.close();
+	return true;
+}
\ No newline at end of file
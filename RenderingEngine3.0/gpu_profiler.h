@@ -0,0 +1,106 @@
+#pragma once
+
+#include "vulkan.h"
+#include "base_info.h"
+#include "gpu_pass_times.h"
+#include "gpu_draw_statistics.h"
+
+#include "enum_gpu_timer.h"
+#include "enum_draw_category.h"
+#include "const_gpu_profiler_log_frame_count.h"
+
+namespace rcq
+{
+	//timestamp pairs around the passes and pipeline statistics around the draw categories, 
+	//the results of a frame are read after its fence is signaled
+	class gpu_profiler
+	{
+	public:
+		void init(const base_info& base, const VkAllocationCallbacks* alloc);
+		void destroy(const VkAllocationCallbacks* alloc);
+
+		//the queries of a timer are reset in the cb that writes them, outside of render passes
+		void reset(VkCommandBuffer cb, GPU_TIMER first_timer, uint32_t timer_count = 1)
+		{
+			if (m_timestamp_mask != 0)
+				vkCmdResetQueryPool(cb, m_qp, 2 * first_timer, 2 * timer_count);
+		}
+
+		void begin(VkCommandBuffer cb, GPU_TIMER timer)
+		{
+			if (m_timestamp_mask != 0)
+				vkCmdWriteTimestamp(cb, VK_PIPELINE_STAGE_TOP_OF_PIPE_BIT, m_qp, 2 * timer);
+		}
+
+		void end(VkCommandBuffer cb, GPU_TIMER timer)
+		{
+			if (m_timestamp_mask != 0)
+				vkCmdWriteTimestamp(cb, VK_PIPELINE_STAGE_BOTTOM_OF_PIPE_BIT, m_qp, 2 * timer + 1);
+		}
+
+		//the statistics queries are optional, they need the pipelineStatisticsQuery feature
+		void reset_statistics(VkCommandBuffer cb, DRAW_CATEGORY first_category, uint32_t category_count = 1)
+		{
+			if (m_statistics_enabled)
+				vkCmdResetQueryPool(cb, m_statistics_qp, first_category, category_count);
+		}
+
+		//may be called in secondary cbs, the query has to end in the same subpass
+		void begin_statistics(VkCommandBuffer cb, DRAW_CATEGORY category)
+		{
+			if (m_statistics_enabled)
+				vkCmdBeginQuery(cb, m_statistics_qp, category, 0);
+		}
+
+		void end_statistics(VkCommandBuffer cb, DRAW_CATEGORY category)
+		{
+			if (m_statistics_enabled)
+				vkCmdEndQuery(cb, m_statistics_qp, category);
+		}
+
+		//timers and draw categories of the submitted cbs, a bit for every GPU_TIMER and DRAW_CATEGORY
+		void frame_submitted(uint32_t timer_mask, uint32_t draw_category_mask)
+		{
+			m_submitted_timer_mask = timer_mask;
+			m_submitted_draw_category_mask = draw_category_mask;
+		}
+
+		//called after the fence of the submitted frame is signaled
+		void read_results();
+
+		const gpu_pass_times& last_frame() const
+		{
+			return m_log[(m_logged_frame_count + GPU_PROFILER_LOG_FRAME_COUNT - 1) % GPU_PROFILER_LOG_FRAME_COUNT];
+		}
+
+		const gpu_draw_statistics& last_draw_statistics() const
+		{
+			return m_draw_statistics;
+		}
+
+		//writes the logged frames, oldest first, as json if the filename ends with .json, as csv otherwise
+		bool save_log(const char* filename) const;
+
+		//the name of the timer in the logs
+		static const char* timer_name(GPU_TIMER timer);
+
+	private:
+		void read_statistics();
+
+		VkDevice m_device;
+		VkQueryPool m_qp;
+		uint64_t m_timestamp_mask; //valid bits of the timestamps, 0 if the queue family does not support them
+		float m_timestamp_period; //ns per tick
+
+		uint32_t m_submitted_timer_mask;
+		uint64_t m_frame_index;
+
+		VkQueryPool m_statistics_qp;
+		bool m_statistics_enabled;
+		uint32_t m_submitted_draw_category_mask;
+		gpu_draw_statistics m_draw_statistics;
+
+		gpu_pass_times m_log[GPU_PROFILER_LOG_FRAME_COUNT];
+		uint64_t m_logged_frame_count;
+	};
+}
\ No newline at end of file
@@ -1,5 +1,7 @@
 #pragma once
 
+#include "memory_accounting.h"
+
 namespace rcq
 {
 	class host_memory
@@ -32,6 +34,11 @@ namespace rcq
 			return m_upstream;
 		}
 
+		memory_stats stats() const
+		{
+			return m_accounting.stats();
+		}
+
 	protected:
 		void init(size_t max_alignment, host_memory* upstream)
 		{
@@ -41,5 +48,6 @@ namespace rcq
 
 		host_memory* m_upstream;
 		size_t m_max_alignment;
+		memory_accounting m_accounting;
 	};
 }
\ No newline at end of file
@@ -1,9 +1,58 @@
 #include "scene.h"
+#include "benchmark.h"
 
 #include <iostream>
+#include <stdlib.h>
+#include <string.h>
 
-int main()
+//rcq_engine --headless <width> <height> <frame count> <image.ppm>
+//the frames advance by a fixed time step, so the saved image only depends on the frame count
+static int run_headless(uint32_t width, uint32_t height, uint32_t frame_count, const char* image)
 {
+	constexpr float HEADLESS_FRAME_TIME = 1.f / 60.f;
+
+	rcq_user::init(width, height, true);
+
+	auto sc = new scene(nullptr, rcq_user::get_window_size());
+	for (uint32_t i = 0; i < frame_count; ++i)
+		sc->update(HEADLESS_FRAME_TIME);
+	bool saved = rcq_user::save_frame(image);
+	delete sc;
+
+	rcq_user::destroy();
+	return saved ? 0 : 1;
+}
+
+//rcq_engine --benchmark <description> <width> <height> <report.json>
+static int run_benchmark(const char* description, uint32_t width, uint32_t height, const char* report)
+{
+	benchmark b;
+	if (!b.load(description))
+		return 1;
+
+	rcq_user::init(width, height, true);
+
+	auto sc = new scene(nullptr, rcq_user::get_window_size());
+	b.run(*sc);
+	delete sc;
+
+	rcq_user::destroy();
+	return b.save_report(report) ? 0 : 1;
+}
+
+int main(int argc, char** argv)
+{
+	if (argc == 6 && strcmp(argv[1], "--benchmark") == 0)
+	{
+		return run_benchmark(argv[2], static_cast<uint32_t>(atoi(argv[3])), static_cast<uint32_t>(atoi(argv[4])), argv[5]);
+	}
+
+	if (argc == 6 && strcmp(argv[1], "--headless") == 0)
+	{
+		return run_headless(static_cast<uint32_t>(atoi(argv[2])), static_cast<uint32_t>(atoi(argv[3])),
+			static_cast<uint32_t>(atoi(argv[4])), argv[5]);
+	}
+
 	rcq_user::init();
 
 	GLFWwindow* window = rcq_user::get_window();
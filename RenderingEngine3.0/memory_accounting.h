@@ -0,0 +1,106 @@
+#pragma once
+
+#include "memory_stats.h"
+
+#include <atomic>
+
+namespace rcq
+{
+	//counters of a memory resource, they are only kept if RCQ_MEMORY_STATS is defined
+	//every thread using the resource updates them (the build and destroy threads share the device local memories),
+	//so the counts are atomic read-modify-writes. the free block snapshots are plain stores, any thread can read them
+	class memory_accounting
+	{
+	public:
+#ifdef RCQ_MEMORY_STATS
+		memory_accounting() :
+			m_capacity(0),
+			m_in_use(0),
+			m_peak(0),
+			m_allocation_count(0),
+			m_largest_free_block(0),
+			m_free(0),
+			m_budget(0)
+		{}
+
+		void allocated(uint64_t size)
+		{
+			uint64_t in_use = m_in_use.fetch_add(size, std::memory_order_relaxed) + size;
+			uint64_t peak = m_peak.load(std::memory_order_relaxed);
+			while (in_use > peak && !m_peak.compare_exchange_weak(peak, in_use, std::memory_order_relaxed));
+			m_allocation_count.fetch_add(1, std::memory_order_relaxed);
+		}
+
+		//count is the number of allocations freed together
+		void deallocated(uint64_t size, uint64_t count = 1)
+		{
+			m_in_use.fetch_sub(size, std::memory_order_relaxed);
+			m_allocation_count.fetch_sub(count, std::memory_order_relaxed);
+		}
+
+		void upstream_allocated(uint64_t size)
+		{
+			m_capacity.fetch_add(size, std::memory_order_relaxed);
+		}
+
+		void upstream_deallocated(uint64_t size)
+		{
+			m_capacity.fetch_sub(size, std::memory_order_relaxed);
+		}
+
+		//the resource released all of its allocations at once
+		void cleared()
+		{
+			m_in_use.store(0, std::memory_order_relaxed);
+			m_allocation_count.store(0, std::memory_order_relaxed);
+		}
+
+		void free_blocks(uint64_t largest, uint64_t free)
+		{
+			m_largest_free_block.store(largest, std::memory_order_relaxed);
+			m_free.store(free, std::memory_order_relaxed);
+		}
+
+		void set_budget(uint64_t budget)
+		{
+			m_budget.store(budget, std::memory_order_relaxed);
+		}
+
+		memory_stats stats() const
+		{
+			memory_stats s;
+			s.capacity = m_capacity.load(std::memory_order_relaxed);
+			s.in_use = m_in_use.load(std::memory_order_relaxed);
+			s.peak = m_peak.load(std::memory_order_relaxed);
+			s.allocation_count = m_allocation_count.load(std::memory_order_relaxed);
+			s.largest_free_block = m_largest_free_block.load(std::memory_order_relaxed);
+			uint64_t free = m_free.load(std::memory_order_relaxed);
+			s.fragmentation = free == 0 ? 0.f : 1.f - float(s.largest_free_block) / float(free);
+			s.budget = m_budget.load(std::memory_order_relaxed);
+			return s;
+		}
+
+	private:
+		std::atomic<uint64_t> m_capacity;
+		std::atomic<uint64_t> m_in_use;
+		std::atomic<uint64_t> m_peak;
+		std::atomic<uint64_t> m_allocation_count;
+		std::atomic<uint64_t> m_largest_free_block;
+		std::atomic<uint64_t> m_free;
+		std::atomic<uint64_t> m_budget;
+#else
+		void allocated(uint64_t) {}
+		void deallocated(uint64_t, uint64_t = 1) {}
+		void upstream_allocated(uint64_t) {}
+		void upstream_deallocated(uint64_t) {}
+		void cleared() {}
+		void free_blocks(uint64_t, uint64_t) {}
+		void set_budget(uint64_t) {}
+
+		memory_stats stats() const
+		{
+			return {};
+		}
+#endif
+	};
+}
\ No newline at end of file
@@ -0,0 +1,87 @@
+#include "memory_registry.h"
+
+#include <assert.h>
+#include <string.h>
+#include <fstream>
+#include <mutex>
+
+using namespace rcq;
+
+namespace
+{
+	struct entry
+	{
+		const char* owner;
+		const char* name;
+		host_memory* host;
+		device_memory* device;
+	};
+}
+
+static entry g_entries[MEMORY_REGISTRY_CAPACITY];
+static uint32_t g_entry_count = 0;
+static std::mutex g_mutex;
+
+static void add_entry(const char* owner, const char* name, host_memory* host, device_memory* device)
+{
+	std::lock_guard<std::mutex> lock(g_mutex);
+	assert(g_entry_count < MEMORY_REGISTRY_CAPACITY);
+	g_entries[g_entry_count++] = { owner, name, host, device };
+}
+
+void memory_registry::add(const char* owner, const char* name, host_memory* memory)
+{
+	add_entry(owner, name, memory, nullptr);
+}
+
+void memory_registry::add(const char* owner, const char* name, device_memory* memory)
+{
+	add_entry(owner, name, nullptr, memory);
+}
+
+void memory_registry::remove_owner(const char* owner)
+{
+	std::lock_guard<std::mutex> lock(g_mutex);
+	uint32_t kept_count = 0;
+	for (uint32_t i = 0; i < g_entry_count; ++i)
+	{
+		if (strcmp(g_entries[i].owner, owner) != 0)
+			g_entries[kept_count++] = g_entries[i];
+	}
+	g_entry_count = kept_count;
+}
+
+uint32_t memory_registry::collect(memory_report* reports, uint32_t max_count)
+{
+	std::lock_guard<std::mutex> lock(g_mutex);
+	for (uint32_t i = 0; i < g_entry_count && i < max_count; ++i)
+	{
+		const entry& e = g_entries[i];
+		reports[i].owner = e.owner;
+		reports[i].name = e.name;
+		reports[i].device = e.device != nullptr;
+		reports[i].stats = e.device != nullptr ? e.device->stats() : e.host->stats();
+	}
+	return g_entry_count;
+}
+
+bool memory_registry::save(const char* filename)
+{
+	std::ofstream file(filename, std::ios::trunc);
+	if (!file.is_open())
+		return false;
+
+	memory_report reports[MEMORY_REGISTRY_CAPACITY];
+	uint32_t count = collect(reports, MEMORY_REGISTRY_CAPACITY);
+
+	file << "owner,name,kind,capacity,in_use,peak,allocation_count,largest_free_block,fragmentation,budget\n";
+	for (uint32_t i = 0; i < count; ++i)
+	{
+		const memory_report& r = reports[i];
+		file << r.owner << ',' << r.name << ',' << (r.device ? "device" : "host") << ','
+			<< r.stats.capacity << ',' << r.stats.in_use << ',' << r.stats.peak << ','
+			<< r.stats.allocation_count << ',' << r.stats.largest_free_block << ','
+			<< r.stats.fragmentation << ',' << r.stats.budget << '\n';
+	}
+	return file.good();
+}
\ No newline at end of file
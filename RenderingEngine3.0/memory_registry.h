@@ -0,0 +1,27 @@
+#pragma once
+
+#include "host_memory.h"
+#include "device_memory.h"
+#include "memory_report.h"
+
+#include "const_memory_registry_capacity.h"
+
+#include <stdint.h>
+
+namespace rcq
+{
+	//the live memory resources with their owners, the stats are only kept if RCQ_MEMORY_STATS is defined
+	namespace memory_registry
+	{
+		//owner and name are string literals, the resource must live until its owner is removed
+		void add(const char* owner, const char* name, host_memory* memory);
+		void add(const char* owner, const char* name, device_memory* memory);
+		void remove_owner(const char* owner);
+
+		//fills at most max_count reports, returns the count of the live resources
+		uint32_t collect(memory_report* reports, uint32_t max_count);
+
+		//csv, one line per live resource
+		bool save(const char* filename);
+	}
+}
\ No newline at end of file
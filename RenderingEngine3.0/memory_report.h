@@ -0,0 +1,14 @@
+#pragma once
+
+#include "memory_stats.h"
+
+namespace rcq
+{
+	struct memory_report
+	{
+		const char* owner;
+		const char* name;
+		bool device; //device_memory offsets or host_memory addresses
+		memory_stats stats;
+	};
+}
\ No newline at end of file
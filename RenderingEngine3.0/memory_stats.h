@@ -0,0 +1,18 @@
+#pragma once
+
+#include <stdint.h>
+
+namespace rcq
+{
+	//all zero if the engine was built without RCQ_MEMORY_STATS
+	struct memory_stats
+	{
+		uint64_t capacity; //bytes taken from the upstream
+		uint64_t in_use; //bytes of the live allocations, with their padding
+		uint64_t peak; //maximum of in_use
+		uint64_t allocation_count; //live allocations
+		uint64_t largest_free_block;
+		float fragmentation; //1 - largest_free_block/free bytes, 0 if nothing is free
+		uint64_t budget; //bytes of the memory heap the resource takes its capacity from, 0 if it is not bounded by a heap
+	};
+}
\ No newline at end of file
@@ -22,6 +22,8 @@ namespace rcq
 		{
 			*m_chunks.push_back() = m_upstream->allocate(m_chunk_size, m_max_alignment);
 			m_next = *m_chunks.last();
+			m_accounting.upstream_allocated(m_chunk_size);
+			m_accounting.free_blocks(m_chunk_size, m_chunk_size);
 		}
 
 		void init(VkDeviceSize chunk_size, VkDeviceSize alignment, device_memory* upstream,
@@ -33,6 +35,8 @@ namespace rcq
 
 			*m_chunks.push_back() = m_upstream->allocate(m_chunk_size, m_max_alignment);
 			m_next = *m_chunks.last();
+			m_accounting.upstream_allocated(m_chunk_size);
+			m_accounting.free_blocks(m_chunk_size, m_chunk_size);
 		}
 
 		void reset()
@@ -48,8 +52,12 @@ namespace rcq
 			{
 				for (size_t i = 1; i < m_chunks.size(); ++i)
 					m_upstream->deallocate(m_chunks[i]);
+				m_accounting.upstream_deallocated((m_chunks.size() - 1)*m_chunk_size);
 				m_chunks.resize(1);
 				m_next = *m_chunks.last();
+
+				m_accounting.cleared();
+				m_accounting.free_blocks(m_chunk_size, m_chunk_size);
 			}
 		}
 
@@ -66,11 +74,14 @@ namespace rcq
 			if (aligned_next + size <= *m_chunks.last() + m_chunk_size)
 			{
 				m_next = aligned_next + size;
+				account_allocation(size);
 				return aligned_next;
 			}
 
 			*m_chunks.push_back() = m_upstream->allocate(m_chunk_size, m_max_alignment);
 			m_next = *m_chunks.last() + size;
+			m_accounting.upstream_allocated(m_chunk_size);
+			account_allocation(size);
 
 			return *m_chunks.last();
 		}
@@ -78,6 +89,14 @@ namespace rcq
 		void deallocate(VkDeviceSize p) override {}
 
 	private:
+		//only the rest of the last chunk can be allocated
+		void account_allocation(VkDeviceSize size)
+		{
+			m_accounting.allocated(size);
+			VkDeviceSize free = *m_chunks.last() + m_chunk_size - m_next;
+			m_accounting.free_blocks(free, free);
+		}
+
 		VkDeviceSize m_chunk_size;
 		vector<VkDeviceSize> m_chunks;
 		VkDeviceSize m_next;
@@ -18,6 +18,7 @@ namespace rcq
 			assert(m_max_alignment <= m_upstream->max_alignment());
 			m_begin = m_upstream->allocate(m_next_chunk_size, m_max_alignment);
 			m_end = m_begin + m_next_chunk_size;
+			m_accounting.upstream_allocated(m_next_chunk_size);
 			m_next_chunk_size <<= 1;
 			m_first_chunk = reinterpret_cast<chunk*>(m_begin);
 			m_last_chunk = m_first_chunk;
@@ -33,6 +34,7 @@ namespace rcq
 			assert(m_max_alignment <= m_upstream->max_alignment());
 			m_begin = m_upstream->allocate(m_next_chunk_size, m_max_alignment);
 			m_end = m_begin + m_next_chunk_size;
+			m_accounting.upstream_allocated(m_next_chunk_size);
 			m_next_chunk_size <<= 1;
 			m_first_chunk = reinterpret_cast<chunk*>(m_begin);
 			m_last_chunk = m_first_chunk;
@@ -69,15 +71,18 @@ namespace rcq
 				m_last_chunk = m_last_chunk->next;
 				m_last_chunk->next = nullptr;
 				m_end = m_begin + m_next_chunk_size;
+				m_accounting.upstream_allocated(m_next_chunk_size);
 				size_t ret = align(m_begin+sizeof(chunk), alignment);
 				m_begin = ret+size;
 				m_next_chunk_size <<= 1;
+				account_allocation(size);
 				return ret;
 			}
 			else
 			{
 				size_t ret = m_begin;
 				m_begin += size;
+				account_allocation(size);
 				return ret;
 			}
 		}
@@ -85,6 +90,13 @@ namespace rcq
 		void deallocate(size_t p) override {}
 
 	private:
+		//only the rest of the last chunk can be allocated
+		void account_allocation(size_t size)
+		{
+			m_accounting.allocated(size);
+			m_accounting.free_blocks(m_end - m_begin, m_end - m_begin);
+		}
+
 		struct chunk
 		{
 			chunk* next;
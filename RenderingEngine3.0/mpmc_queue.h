@@ -0,0 +1,250 @@
+#pragma once
+
+#include "host_memory.h"
+#include "futex.h"
+
+#include <atomic>
+#include <new>
+#include <assert.h>
+#include <stdint.h>
+#include <type_traits>
+
+namespace rcq
+{
+	//bounded multi-producer multi-consumer queue, every cell has a sequence number telling whose turn it is (Vyukov)
+	template<typename T>
+	class mpmc_queue
+	{
+		//the values are copied in and out of raw cells, they are never constructed or destroyed
+		static_assert(std::is_trivially_copyable<T>::value, "mpmc_queue needs a trivially copyable type");
+
+	public:
+		mpmc_queue() {}
+
+		mpmc_queue(host_memory* memory, size_t capacity)
+		{
+			init(memory, capacity);
+		}
+
+		void init(host_memory* memory, size_t capacity)
+		{
+			assert(capacity >= 2 && (capacity & (capacity - 1)) == 0);
+
+			m_memory = memory;
+			m_mask = capacity - 1;
+			m_cells = reinterpret_cast<cell*>(m_memory->allocate(capacity * sizeof(cell), alignof(cell)));
+			for (size_t i = 0; i < capacity; ++i)
+				new(&m_cells[i].sequence) std::atomic<size_t>(i);
+
+			m_enqueue_pos.store(0, std::memory_order_relaxed);
+			m_dequeue_pos.store(0, std::memory_order_relaxed);
+			m_epoch.store(0, std::memory_order_relaxed);
+			m_waiter_count.store(0, std::memory_order_relaxed);
+		}
+
+		mpmc_queue(const mpmc_queue&) = delete;
+		mpmc_queue(mpmc_queue&&) = delete;
+		mpmc_queue& operator=(const mpmc_queue&) = delete;
+		mpmc_queue& operator=(mpmc_queue&&) = delete;
+
+		~mpmc_queue()
+		{
+			reset();
+		}
+
+		void reset()
+		{
+			if (m_cells != nullptr)
+			{
+				m_memory->deallocate(reinterpret_cast<size_t>(m_cells));
+				m_cells = nullptr;
+			}
+		}
+
+		size_t capacity()
+		{
+			return m_mask + 1;
+		}
+
+		//the cell is reserved, its data is written by the caller and handed to the consumers with publish
+		T* claim()
+		{
+			size_t pos;
+			if (claim_cells(1, pos) == 0)
+				return nullptr;
+			return &m_cells[pos & m_mask].data;
+		}
+
+		void publish(T* data)
+		{
+			size_t index = (reinterpret_cast<char*>(data) - reinterpret_cast<char*>(m_cells)) / sizeof(cell);
+			auto& sequence = m_cells[index].sequence;
+			sequence.store(sequence.load(std::memory_order_relaxed) + 1, std::memory_order_release);
+			signal();
+		}
+
+		bool try_push(const T& value)
+		{
+			return try_push(&value, 1) == 1;
+		}
+
+		//pushes the longest prefix of values that fits, the positions are claimed with one cas
+		size_t try_push(const T* values, size_t count)
+		{
+			size_t pos;
+			size_t claimed_count = claim_cells(count, pos);
+			for (size_t i = 0; i < claimed_count; ++i)
+			{
+				cell& c = m_cells[(pos + i) & m_mask];
+				c.data = values[i];
+				c.sequence.store(pos + i + 1, std::memory_order_release);
+			}
+			if (claimed_count != 0)
+				signal();
+			return claimed_count;
+		}
+
+		bool try_pop(T& value)
+		{
+			return try_pop(&value, 1) == 1;
+		}
+
+		//pops at most max_count values in order, the positions are claimed with one cas
+		size_t try_pop(T* values, size_t max_count)
+		{
+			size_t pos = m_dequeue_pos.load(std::memory_order_relaxed);
+			size_t count;
+			while (true)
+			{
+				count = 0;
+				while (count < max_count)
+				{
+					size_t seq = m_cells[(pos + count) & m_mask].sequence.load(std::memory_order_acquire);
+					if (seq != pos + count + 1)
+						break;
+					++count;
+				}
+
+				if (count == 0)
+				{
+					size_t seq = m_cells[pos & m_mask].sequence.load(std::memory_order_acquire);
+					intptr_t diff = static_cast<intptr_t>(seq) - static_cast<intptr_t>(pos + 1);
+					if (diff < 0)
+						return 0; //empty
+					pos = m_dequeue_pos.load(std::memory_order_relaxed);
+					continue;
+				}
+
+				if (m_dequeue_pos.compare_exchange_weak(pos, pos + count, std::memory_order_relaxed))
+					break;
+			}
+
+			for (size_t i = 0; i < count; ++i)
+			{
+				cell& c = m_cells[(pos + i) & m_mask];
+				values[i] = c.data;
+				c.sequence.store(pos + i + m_mask + 1, std::memory_order_release);
+			}
+			return count;
+		}
+
+		//blocks on a futex while the queue is empty, returns false only if it is empty and should_end is set
+		bool pop_wait(T& value, const std::atomic_bool& should_end)
+		{
+			while (true)
+			{
+				//a short spin catches the values pushed right after the queue ran empty without a syscall
+				for (uint32_t i = 0; i < spin_count; ++i)
+				{
+					if (try_pop(value))
+						return true;
+				}
+				if (should_end.load())
+					return false;
+
+				//the producers wake the queue only if they see a waiter, so the queue is checked again after registering
+				m_waiter_count.fetch_add(1);
+				std::atomic_thread_fence(std::memory_order_seq_cst);
+				uint32_t epoch = m_epoch.load();
+				bool popped = try_pop(value);
+				if (!popped && !should_end.load())
+					futex_wait(&m_epoch, epoch);
+				m_waiter_count.fetch_sub(1);
+
+				if (popped)
+					return true;
+			}
+		}
+
+		//wakes the waiting consumers, e.g. after setting should_end
+		void notify_all()
+		{
+			m_epoch.fetch_add(1);
+			futex_wake_all(&m_epoch);
+		}
+
+		bool empty()
+		{
+			size_t pos = m_dequeue_pos.load(std::memory_order_relaxed);
+			return m_cells[pos & m_mask].sequence.load(std::memory_order_acquire) != pos + 1;
+		}
+
+	private:
+		struct cell
+		{
+			std::atomic<size_t> sequence;
+			T data;
+		};
+
+		//claims the longest run of free cells up to count, returns its length
+		size_t claim_cells(size_t count, size_t& pos)
+		{
+			pos = m_enqueue_pos.load(std::memory_order_relaxed);
+			size_t free_count;
+			while (true)
+			{
+				free_count = 0;
+				while (free_count < count)
+				{
+					size_t seq = m_cells[(pos + free_count) & m_mask].sequence.load(std::memory_order_acquire);
+					if (seq != pos + free_count)
+						break;
+					++free_count;
+				}
+
+				if (free_count == 0)
+				{
+					size_t seq = m_cells[pos & m_mask].sequence.load(std::memory_order_acquire);
+					intptr_t diff = static_cast<intptr_t>(seq) - static_cast<intptr_t>(pos);
+					if (diff < 0)
+						return 0; //full
+					pos = m_enqueue_pos.load(std::memory_order_relaxed);
+					continue;
+				}
+
+				if (m_enqueue_pos.compare_exchange_weak(pos, pos + free_count, std::memory_order_relaxed))
+					break;
+			}
+			return free_count;
+		}
+
+		void signal()
+		{
+			std::atomic_thread_fence(std::memory_order_seq_cst);
+			if (m_waiter_count.load(std::memory_order_relaxed) != 0)
+				notify_all();
+		}
+
+		static const size_t cache_line_size = 64;
+		static const uint32_t spin_count = 256;
+
+		cell* m_cells = nullptr;
+		size_t m_mask;
+		host_memory* m_memory;
+
+		alignas(cache_line_size) std::atomic<size_t> m_enqueue_pos;
+		alignas(cache_line_size) std::atomic<size_t> m_dequeue_pos;
+		alignas(cache_line_size) std::atomic<uint32_t> m_epoch;
+		std::atomic<uint32_t> m_waiter_count;
+	};
+}
\ No newline at end of file
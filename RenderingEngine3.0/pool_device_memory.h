@@ -58,11 +58,13 @@ namespace rcq
 			{
 				VkDeviceSize ret = *m_free_blocks.top();
 				m_free_blocks.pop();
+				account_allocation();
 				return ret;
 			}
 			else
 			{
 				VkDeviceSize block = m_upstream->allocate(m_next_chunk_size, m_block_alignment);
+				m_accounting.upstream_allocated(m_next_chunk_size);
 				*m_chunks.push() = block;
 				VkDeviceSize end = block + m_next_chunk_size;
 				block += m_block_size;
@@ -72,6 +74,7 @@ namespace rcq
 					*m_free_blocks.push() = block;
 					block += m_block_size;
 				}
+				account_allocation();
 				return *m_chunks.top();
 			}
 		}
@@ -79,9 +82,20 @@ namespace rcq
 		void deallocate(VkDeviceSize p) override
 		{
 			*m_free_blocks.push() = p;
+
+			m_accounting.deallocated(m_block_size);
+			m_accounting.free_blocks(m_block_size, m_block_size);
 		}
 
 	private:
+		//any free block fits any request, so the pool is never fragmented
+		void account_allocation()
+		{
+			m_accounting.allocated(m_block_size);
+			VkDeviceSize free = m_free_blocks.empty() ? 0 : m_block_size;
+			m_accounting.free_blocks(free, free);
+		}
+
 		VkDeviceSize m_block_size;
 		VkDeviceSize m_block_alignment;
 		stack<VkDeviceSize> m_chunks;
@@ -52,10 +52,12 @@ namespace rcq
 			{
 				size_t ret = reinterpret_cast<size_t>(m_free_blocks);
 				m_free_blocks = m_free_blocks->next;
+				account_allocation();
 				return ret;
 			}
 
 			size_t new_data = m_upstream->allocate(m_next_chunk_size+sizeof(chunk), m_max_alignment);
+			m_accounting.upstream_allocated(m_next_chunk_size + sizeof(chunk));
 			chunk* new_chunk = reinterpret_cast<chunk*>(new_data);
 			new_chunk->next = m_chunks;
 			m_chunks = new_chunk;
@@ -74,6 +76,7 @@ namespace rcq
 
 			m_next_chunk_size <<= 1;
 
+			account_allocation();
 			return ret;
 		}
 
@@ -82,9 +85,20 @@ namespace rcq
 			block* b = reinterpret_cast<block*>(p);
 			b->next = m_free_blocks;
 			m_free_blocks = b;
+
+			m_accounting.deallocated(m_block_size);
+			m_accounting.free_blocks(m_block_size, m_block_size);
 		}
 
 	private:
+		//any free block fits any request, so the pool is never fragmented
+		void account_allocation()
+		{
+			m_accounting.allocated(m_block_size);
+			size_t free = m_free_blocks != nullptr ? m_block_size : 0;
+			m_accounting.free_blocks(free, free);
+		}
+
 		constexpr size_t min_alignment()
 		{
 			return alignof(chunk) < alignof(block) ? alignof(block) : alignof(chunk);
@@ -0,0 +1,89 @@
+#include "raw_file.h"
+
+#define NOMINMAX
+#define WIN32_LEAN_AND_MEAN
+#include <Windows.h>
+
+#include <assert.h>
+
+using namespace rcq;
+
+namespace
+{
+	//the event of the overlapped reads, one per reading thread, so concurrent reads of a file do not share it
+	struct read_event
+	{
+		read_event() :
+			handle(CreateEventA(nullptr, TRUE, FALSE, nullptr))
+		{
+			assert(handle != nullptr);
+		}
+		~read_event()
+		{
+			CloseHandle(handle);
+		}
+
+		HANDLE handle;
+	};
+
+	thread_local read_event READ_EVENT;
+}
+
+bool raw_file::open(const char* filename)
+{
+	assert(m_handle == nullptr);
+
+	//overlapped handles do not serialize concurrent reads
+	HANDLE h = CreateFileA(filename, GENERIC_READ, FILE_SHARE_READ, nullptr, OPEN_EXISTING,
+		FILE_ATTRIBUTE_NORMAL | FILE_FLAG_OVERLAPPED, nullptr);
+	if (h == INVALID_HANDLE_VALUE)
+		return false;
+
+	m_handle = h;
+	return true;
+}
+
+void raw_file::close()
+{
+	if (m_handle != nullptr)
+	{
+		CloseHandle(m_handle);
+		m_handle = nullptr;
+	}
+}
+
+bool raw_file::read(void* dst, uint64_t size, uint64_t offset) const
+{
+	HANDLE event = READ_EVENT.handle;
+	char* p = reinterpret_cast<char*>(dst);
+
+	//ReadFile reads at most 4GB at once
+	while (size > 0)
+	{
+		DWORD chunk = size > 0x40000000ull ? 0x40000000u : static_cast<DWORD>(size);
+
+		OVERLAPPED ov = {};
+		ov.Offset = static_cast<DWORD>(offset);
+		ov.OffsetHigh = static_cast<DWORD>(offset >> 32);
+		ov.hEvent = event;
+
+		DWORD read_size = 0;
+		if (!ReadFile(m_handle, p, chunk, nullptr, &ov) && GetLastError() != ERROR_IO_PENDING)
+			return false;
+		if (!GetOverlappedResult(m_handle, &ov, &read_size, TRUE) || read_size != chunk)
+			return false;
+
+		p += chunk;
+		offset += chunk;
+		size -= chunk;
+	}
+
+	return true;
+}
+
+uint64_t raw_file::size() const
+{
+	LARGE_INTEGER s;
+	GetFileSizeEx(m_handle, &s);
+	return static_cast<uint64_t>(s.QuadPart);
+}
\ No newline at end of file
@@ -0,0 +1,33 @@
+#pragma once
+
+#include <stdint.h>
+
+namespace rcq
+{
+	//read only file with positional reads, several threads can read the same file at the same time
+	class raw_file
+	{
+	public:
+		raw_file() :
+			m_handle(nullptr)
+		{}
+		~raw_file()
+		{
+			close();
+		}
+		raw_file(const raw_file&) = delete;
+		raw_file(raw_file&&) = delete;
+		raw_file& operator=(const raw_file&) = delete;
+		raw_file& operator=(raw_file&&) = delete;
+
+		bool open(const char* filename);
+		void close();
+
+		//like pread, does not touch any shared file position, false if the read failed or hit the end of the file
+		bool read(void* dst, uint64_t size, uint64_t offset) const;
+		uint64_t size() const;
+
+	private:
+		void* m_handle;
+	};
+}
\ No newline at end of file
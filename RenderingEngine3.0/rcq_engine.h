@@ -4,10 +4,15 @@
 #include "resource_manager.h"
 #include "engine.h"
 #include "terrain_manager.h"
+#include "water_simulator.h"
 
 #include "timer.h"
+#include "memory_registry.h"
 
 #include "enum_tex_type_flag.h"
+#include "enum_water_grid_size.h"
+#include "enum_gpu_timer.h"
+#include "enum_draw_category.h"
 
 #include "const_swap_chain_image_extent.h"
 
@@ -57,10 +62,62 @@ namespace rcq_user
 		};
 	};
 
+	struct water_grid_size
+	{
+		enum : uint32_t
+		{
+			size_256 = rcq::WATER_GRID_SIZE_256,
+			size_512 = rcq::WATER_GRID_SIZE_512,
+			size_1024 = rcq::WATER_GRID_SIZE_1024
+		};
+	};
+
 	typedef rcq::render_settings render_settings;
 	typedef rcq::timer timer;
+	typedef rcq::water_simulator water_simulator;
+	typedef rcq::terrain_residency_stats terrain_residency_stats;
+	typedef rcq::gpu_pass_times gpu_pass_times;
+	typedef rcq::pipeline_statistics pipeline_statistics;
+	typedef rcq::gpu_draw_statistics gpu_draw_statistics;
+
+	//indices of gpu_pass_times::pass_times
+	struct gpu_pass
+	{
+		enum : uint32_t
+		{
+			terrain_request = rcq::GPU_TIMER_TERRAIN_REQUEST,
+			water_fft = rcq::GPU_TIMER_WATER_FFT,
+			environment_map_gen = rcq::GPU_TIMER_ENVIRONMENT_MAP_GEN,
+			dir_shadow_map_gen = rcq::GPU_TIMER_DIR_SHADOW_MAP_GEN,
+			gbuffer_assembler = rcq::GPU_TIMER_GBUFFER_ASSEMBLER,
+			ssao_gen = rcq::GPU_TIMER_SSAO_GEN,
+			preimage_assembler = rcq::GPU_TIMER_PREIMAGE_ASSEMBLER,
+			ssr_ray_casting = rcq::GPU_TIMER_SSR_RAY_CASTING,
+			sky_drawer = rcq::GPU_TIMER_SKY_DRAWER,
+			refraction_image_gen = rcq::GPU_TIMER_REFRACTION_IMAGE_GEN,
+			water_drawer = rcq::GPU_TIMER_WATER_DRAWER,
+			bloom = rcq::GPU_TIMER_BLOOM,
+			postprocessing = rcq::GPU_TIMER_POSTPROCESSING,
+			count = rcq::GPU_TIMER_COUNT
+		};
+	};
+
+	//indices of gpu_draw_statistics::draw_categories
+	struct draw_category
+	{
+		enum : uint32_t
+		{
+			opaque_objects = rcq::DRAW_CATEGORY_OPAQUE_OBJECTS,
+			dir_shadow = rcq::DRAW_CATEGORY_DIR_SHADOW,
+			terrain = rcq::DRAW_CATEGORY_TERRAIN,
+			water = rcq::DRAW_CATEGORY_WATER,
+			count = rcq::DRAW_CATEGORY_COUNT
+		};
+	};
 
-	inline void init()
+	//headless mode renders into offscreen images, there is no window to get and nothing is presented
+	inline void init(uint32_t width = rcq::SWAP_CHAIN_IMAGE_EXTENT.width, uint32_t height = rcq::SWAP_CHAIN_IMAGE_EXTENT.height,
+		bool headless = false)
 	{
 		rcq::base_create_info base_create = {};
 
@@ -68,6 +125,12 @@ namespace rcq_user
 		{
 			VK_KHR_SWAPCHAIN_EXTENSION_NAME
 		};
+		//dedicated allocations for the render targets the driver wants alone
+		const char* optional_device_extensions[] =
+		{
+			VK_KHR_GET_MEMORY_REQUIREMENTS_2_EXTENSION_NAME,
+			VK_KHR_DEDICATED_ALLOCATION_EXTENSION_NAME
+		};
 		const char* instance_extensions[]=
 		{
 			VK_EXT_DEBUG_REPORT_EXTENSION_NAME
@@ -79,19 +142,26 @@ namespace rcq_user
 
 		base_create.enable_validation_layers = true;
 		base_create.device_extensions = device_extensions;
-		base_create.device_extensions_count = 1;
+		base_create.device_extensions_count = headless ? 0 : 1;
+		base_create.optional_device_extensions = optional_device_extensions;
+		base_create.optional_device_extensions_count = 2;
 		base_create.instance_extensions = instance_extensions;
 		base_create.instance_extensions_count = 1;
 		base_create.validation_layers = validation_layers;
 		base_create.validation_layer_count = 1;
 		
 		base_create.window_name = "RCQ Engine";
+		base_create.extent = { width, height };
+		base_create.headless = headless;
 		base_create.device_features.samplerAnisotropy = VK_TRUE;
 		base_create.device_features.geometryShader = VK_TRUE;
 		base_create.device_features.tessellationShader = VK_TRUE;
 		base_create.device_features.depthBounds = VK_TRUE;
-		base_create.device_features.sparseBinding = VK_TRUE;
+		//the terrain needs sparse binding, headless mode runs without it and skips the terrain
+		base_create.device_features.sparseBinding = headless ? VK_FALSE : VK_TRUE;
+		base_create.optional_device_features.sparseBinding = VK_TRUE;
 		base_create.device_features.fillModeNonSolid = VK_TRUE;
+		base_create.optional_device_features.pipelineStatisticsQuery = VK_TRUE;
 
 		rcq::base::init(base_create);
 
@@ -150,6 +220,8 @@ namespace rcq_user
 		rcq::engine::instance()->render();
 	}
 
+	//*build_info has to be filled before the next build_resource call, the build starts at dispatch_resource_builds
+	//or earlier if the build queue is full
 	template<resource res>
 	inline void build_resource(resource_handle* handle, build_info<res>** build_info)
 	{
@@ -203,6 +275,45 @@ namespace rcq_user
 	{
 		rcq::engine::instance()->destroy_terrain();
 	}
+	//false if sparse binding is not enabled, only possible in headless mode, the terrain can not be built then
+	inline bool terrain_supported()
+	{
+		return rcq::base::instance()->get_info().enabled_features.sparseBinding == VK_TRUE;
+	}
+	inline terrain_residency_stats get_terrain_residency_stats()
+	{
+		return rcq::terrain_manager::instance()->get_residency_stats();
+	}
+	//the pass times of the last finished frame, they lag one frame behind the rendering
+	inline gpu_pass_times get_gpu_pass_times()
+	{
+		return rcq::engine::instance()->get_gpu_pass_times();
+	}
+	//the name of a gpu_pass in the profiler logs
+	inline const char* get_gpu_pass_name(uint32_t pass)
+	{
+		return rcq::gpu_profiler::timer_name(static_cast<rcq::GPU_TIMER>(pass));
+	}
+	//pipeline statistics of the last finished frame, valid_mask is 0 if the device has no pipelineStatisticsQuery
+	inline gpu_draw_statistics get_gpu_draw_statistics()
+	{
+		return rcq::engine::instance()->get_gpu_draw_statistics();
+	}
+	//csv or json (by the .json extension) dump of the last GPU_PROFILER_LOG_FRAME_COUNT frames
+	inline bool save_gpu_profiler_log(const char* filename)
+	{
+		return rcq::engine::instance()->save_gpu_profiler_log(filename);
+	}
+	//chrome://tracing json of the last TRACE_EVENT_COUNT scopes of every thread
+	inline bool save_trace(const char* filename)
+	{
+		return rcq::trace::save(filename);
+	}
+	//csv of the memory resources by owner, the stats are zero unless the engine is built with RCQ_MEMORY_STATS
+	inline bool save_memory_report(const char* filename)
+	{
+		return rcq::memory_registry::save(filename);
+	}
 
 	inline GLFWwindow* get_window()
 	{
@@ -211,6 +322,13 @@ namespace rcq_user
 
 	inline glm::vec2 get_window_size()
 	{
-		return { rcq::SWAP_CHAIN_IMAGE_EXTENT.width, rcq::SWAP_CHAIN_IMAGE_EXTENT.height };
+		auto& extent = rcq::base::instance()->get_info().extent;
+		return { extent.width, extent.height };
+	}
+
+	//binary ppm of the last frame, headless mode only
+	inline bool save_frame(const char* filename)
+	{
+		return rcq::engine::instance()->save_frame(filename);
 	}
 }
\ No newline at end of file
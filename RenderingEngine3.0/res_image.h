@@ -1,6 +1,8 @@
 #pragma once
 
 #include "vulkan.h"
+#include "vk_memory.h"
+#include "monotonic_buffer_device_memory.h"
 
 namespace rcq
 {
@@ -8,6 +10,7 @@ namespace rcq
 	{
 		VkImage image;
 		VkImageView view;
-		monotonic_buffer_device_memory* memory;
+		monotonic_buffer_device_memory* memory; //null if the image has a memory of its own
+		vk_memory dedicated_memory;
 	};
 }
\ No newline at end of file
@@ -1,5 +1,7 @@
 #include "resource_manager.h"
 
+#include "memory_registry.h"
+
 using namespace rcq;
 
 resource_manager* resource_manager::m_instance = nullptr;
@@ -12,9 +14,14 @@ resource_manager::resource_manager(const base_info& info) : m_base(info)
 	create_dp_pools();
 	create_staging_buffer();
 	create_build_fence();
+	create_defragment_cp_and_fence();
 
 	m_should_end_build = false;
 	m_should_end_destroy = false;
+	m_submitted_frame_count = 0;
+	m_defragment_submitted = false;
+	m_defragment_frame = 0;
+	m_deferred_destroy_count = 0;
 	m_build_thread = std::thread([this]()
 	{
 		build_loop();
@@ -29,27 +36,23 @@ resource_manager::resource_manager(const base_info& info) : m_base(info)
 
 resource_manager::~resource_manager()
 {
-	bool should_notify;
 	m_should_end_build.store(true);
+	m_build_queue.notify_all();
+	//a build waiting for device memory checks the flag under the memory mutex
 	{
-		std::unique_lock<std::mutex> lock(m_build_queue_mutex);
-		should_notify = m_build_queue.empty();
+		std::lock_guard<std::mutex> lock(m_memory_mutex);
 	}
-	if (should_notify)
-		m_build_queue_cv.notify_one();
+	m_memory_freed_cv.notify_all();
 	m_build_thread.join();
 
 	m_should_end_destroy.store(true);
-	{
-		std::unique_lock<std::mutex> lock(m_destroy_queue_mutex);
-		should_notify = m_destroy_queue.empty();
-	}
-	if (should_notify)
-		m_destroy_queue_cv.notify_one();
+	m_destroy_queue.notify_all();
 	m_destroy_thread.join();
 
 	vkDestroyCommandPool(m_base.device, m_build_cp, m_vk_alloc);
 	vkDestroyFence(m_base.device, m_build_f, m_vk_alloc);
+	vkDestroyCommandPool(m_base.device, m_defragment_cp, m_vk_alloc);
+	vkDestroyFence(m_base.device, m_defragment_f, m_vk_alloc);
 	vkDestroyBuffer(m_base.device, m_staging_buffer, m_vk_alloc);
 	for (auto& dsl : m_dsls)
 		vkDestroyDescriptorSetLayout(m_base.device, dsl, m_vk_alloc);
@@ -59,7 +62,16 @@ resource_manager::~resource_manager()
 
 	m_build_queue.reset();
 	m_destroy_queue.reset();
+	m_claimed_builds.reset();
+	m_pending_destroys.reset();
+	m_deferred_destroys.reset();
+	m_freed_dl0_offsets.reset();
+	m_freed_dl1_offsets.reset();
+	m_relocations.reset();
+	m_relocation_destroys.reset();
+	m_defragment_candidates.reset();
 	
+	memory_registry::remove_owner("resource_manager");
 	m_dl1_memory.reset();
 	m_dl0_memory.reset();
 
@@ -102,6 +114,7 @@ void resource_manager::end_build_cb(const VkSemaphore* wait_semaphores, const Vk
 	submit.pWaitSemaphores = wait_semaphores;
 
 	vkResetFences(m_base.device, 1, &m_build_f);
+	std::lock_guard<std::mutex> lock(*m_base.queue_mutexes[QUEUE_RESOURCE_BUILD]);
 	assert(vkQueueSubmit(m_base.queues[QUEUE_RESOURCE_BUILD], 1, &submit, m_build_f) == VK_SUCCESS);
 }
 
@@ -111,6 +124,21 @@ void resource_manager::wait_for_build_fence()
 	vkResetFences(m_base.device, 1, &m_build_f);
 }
 
+//if the device allocation limit refuses a new block, the build waits with the memory mutex released until the destroy thread
+//frees memory. returns false if the resource manager is destroyed meanwhile, the build is given up then
+bool resource_manager::allocate_device_memory(block_device_memory& memory, VkDeviceSize size, VkDeviceSize alignment,
+	const void* owner, VkDeviceSize& p)
+{
+	while (!memory.try_allocate(size, alignment, owner, p))
+	{
+		RCQ_TRACE_SCOPE("resource_manager::wait_for_device_memory");
+		if (m_should_end_build.load())
+			return false;
+		m_memory_freed_cv.wait(m_memory_mutex);
+	}
+	return true;
+}
+
 
 
 
@@ -243,3 +271,24 @@ void resource_manager::create_build_fence()
 	assert(vkCreateFence(m_base.device, &f, m_vk_alloc, &m_build_f) == VK_SUCCESS);
 }
 
+void resource_manager::create_defragment_cp_and_fence()
+{
+	VkCommandPoolCreateInfo cp = {};
+	cp.sType = VK_STRUCTURE_TYPE_COMMAND_POOL_CREATE_INFO;
+	cp.queueFamilyIndex = m_base.queue_family_index;
+	cp.flags = VK_COMMAND_POOL_CREATE_RESET_COMMAND_BUFFER_BIT | VK_COMMAND_POOL_CREATE_TRANSIENT_BIT;
+
+	assert(vkCreateCommandPool(m_base.device, &cp, m_vk_alloc, &m_defragment_cp) == VK_SUCCESS);
+
+	VkCommandBufferAllocateInfo cb = {};
+	cb.sType = VK_STRUCTURE_TYPE_COMMAND_BUFFER_ALLOCATE_INFO;
+	cb.commandBufferCount = 1;
+	cb.commandPool = m_defragment_cp;
+	cb.level = VK_COMMAND_BUFFER_LEVEL_PRIMARY;
+
+	assert(vkAllocateCommandBuffers(m_base.device, &cb, &m_defragment_cb) == VK_SUCCESS);
+
+	VkFenceCreateInfo f = {};
+	f.sType = VK_STRUCTURE_TYPE_FENCE_CREATE_INFO;
+	assert(vkCreateFence(m_base.device, &f, m_vk_alloc, &m_defragment_f) == VK_SUCCESS);
+}
\ No newline at end of file
@@ -1,6 +1,7 @@
 #pragma once
 
-#include "queue.h"
+#include "mpmc_queue.h"
+#include "vector.h"
 
 #include "dp_pool.h"
 #include "resources.h"
@@ -10,13 +11,17 @@
 #include "monotonic_buffer_device_memory.h"
 #include "vk_allocator.h"
 #include "vk_memory.h"
-#include "freelist_device_memory.h"
+#include "block_device_memory.h"
 #include "freelist_host_memory.h"
 
 #include "enum_dsl_type.h"
 #include "enum_memory_type.h"
 
+#include "trace.h"
+
 #include <mutex>
+#include <condition_variable>
+#include <thread>
 
 namespace rcq
 {
@@ -32,41 +37,57 @@ namespace rcq
 		void build_resource(base_resource** base_res, typename resource<res_type>::build_info** build_info)
 		{
 			*base_res = reinterpret_cast<base_resource*>(m_resource_pool.allocate(sizeof(base_resource), alignof(base_resource)));
-			base_resource_build_info* raw_build_info = m_build_queue.create_back();
+			//the build info is written in place, it is handed to the build thread by dispach_builds
+			//the caller has to fill it before the next build_resource call: if the queue is full,
+			//the earlier claims are handed over to make room, and it waits for the build thread
+			base_resource_build_info* raw_build_info;
+			while ((raw_build_info = m_build_queue.claim()) == nullptr)
+			{
+				dispach_builds();
+				std::this_thread::yield();
+			}
+			*m_claimed_builds.push_back() = raw_build_info;
 			raw_build_info->resource_type = res_type;
 			raw_build_info->base_res = *base_res;
 			*build_info = reinterpret_cast<typename resource<res_type>::build_info*>(raw_build_info->data);
 			(*base_res)->res_type = res_type;
 			(*base_res)->ready_bit = false;
+			(*base_res)->pinned = false;
 		}
 
 		void destroy_resource(base_resource* res)
 		{
-			*m_destroy_queue.create_back() = res;
+			m_pending_destroys.push_back()->res = res;
 		}
 
 		void dispach_builds()
 		{
-			bool should_notify;
-			{
-				std::unique_lock<std::mutex> lock(m_build_queue_mutex);
-				should_notify = m_build_queue.empty();
-				m_build_queue.commit();
-			}
-			if (should_notify)
-				m_build_queue_cv.notify_one();
+			for (auto info : m_claimed_builds)
+				m_build_queue.publish(info);
+			m_claimed_builds.clear();
 		}
 
+		//the resources are destroyed after every frame submitted so far is finished
 		void dispatch_destroys()
 		{
-			bool should_notify;
+			push_destroys(m_pending_destroys, m_submitted_frame_count);
+		}
+
+		//called by the engine after submitting a frame with the render finished fence
+		void frame_submitted()
+		{
+			++m_submitted_frame_count;
+		}
+
+		//called by the engine after waiting for the render finished fence, every submitted frame is finished
+		void frame_completed()
+		{
+			//the destroy thread only needs to know about it if it has something to retire, if the queue is full it learns next frame
+			if (m_deferred_destroy_count.load() != 0)
 			{
-				std::unique_lock<std::mutex> lock(m_destroy_queue_mutex);
-				should_notify = m_destroy_queue.empty();
-				m_destroy_queue.commit();
+				destroy_request frame_marker = { nullptr, m_submitted_frame_count };
+				m_destroy_queue.try_push(frame_marker);
 			}
-			if (should_notify)
-				m_destroy_queue_cv.notify_one();
 		}
 
 		VkDescriptorSetLayout get_dsl(DSL_TYPE dsl_type)
@@ -74,6 +95,28 @@ namespace rcq
 			return m_dsls[dsl_type];
 		}
 
+		//a moved resource keeps its base_resource, old is a copy with the handles it had before the move
+		struct relocation
+		{
+			base_resource* res;
+			base_resource* old;
+		};
+
+		//called by the engine between two frames, after waiting for the render finished fence
+		//moves resources down into the free ranges of the device local memories, at most byte_budget bytes are copied.
+		//the copies are submitted to the render queue and run before the next frame
+		const vector<relocation>& defragment(VkDeviceSize byte_budget);
+
+		//called by the engine after it replaced its copies of the old handles, the copies read the old resources
+		//until the next frame is finished, so they are destroyed after it
+		void retire_relocations()
+		{
+			for (auto& r : m_relocations)
+				*m_relocation_destroys.push_back() = { r.old, 0 };
+			m_relocations.clear();
+			push_destroys(m_relocation_destroys, m_submitted_frame_count + 1);
+		}
+
 	private:
 		//create functions
 		void create_dsls();
@@ -82,15 +125,58 @@ namespace rcq
 		void create_memory_resources_and_containers();
 		void create_staging_buffer();
 		void create_build_fence();
+		void create_defragment_cp_and_fence();
 
 		//thread loops
 		void build_loop();
 		void destroy_loop();
 
+		//deferred destruction, a request with null res tells the destroy thread which frames are finished
+		struct destroy_request
+		{
+			base_resource* res;
+			uint64_t frame;
+		};
+		void retire_destroys(uint64_t completed_frame_count);
+		void free_device_memory();
+
+		//stamps the requests with the frame count they wait for and hands them to the destroy thread
+		void push_destroys(vector<destroy_request>& requests, uint64_t frame)
+		{
+			for (auto& d : requests)
+				d.frame = frame;
+			m_deferred_destroy_count.fetch_add(requests.size());
+
+			size_t pushed_count = 0;
+			while (pushed_count != requests.size())
+			{
+				size_t count = m_destroy_queue.try_push(requests.data() + pushed_count, requests.size() - pushed_count);
+				if (count == 0)
+					std::this_thread::yield();
+				pushed_count += count;
+			}
+			requests.clear();
+		}
+
 		//resource build, destroy functions
 		template<uint32_t res_type> void build(base_resource* res, const char* build_info);
 		template<uint32_t res_type> void destroy(base_resource* res);
 
+		//defragmentation, the moved copy of res is recorded into the defragment cb, old gets the old handles
+		void defragment_memory(block_device_memory& memory, VkDeviceSize byte_budget, VkDeviceSize& moved_size);
+		template<uint32_t res_type> bool relocate(base_resource* res, base_resource* old, VkDeviceSize byte_budget,
+			VkDeviceSize& moved_size);
+		bool allocate_relocation(block_device_memory** memories, const VkMemoryRequirements* mrs, const VkDeviceSize* offsets,
+			uint32_t count, const void* owner, VkDeviceSize* new_offsets);
+		VkBuffer relocate_buffer(VkBuffer buffer, VkDeviceSize size, VkBufferUsageFlags usage, block_device_memory& memory,
+			VkDeviceSize new_offset);
+		void relocate_image(const resource<RES_TYPE_MAT_OPAQUE>::texture& tex, block_device_memory& memory,
+			resource<RES_TYPE_MAT_OPAQUE>::texture& new_tex);
+
+		//opaque material textures, the image and the view are created from the size and the mip level count of tex
+		void create_texture_image(resource<RES_TYPE_MAT_OPAQUE>::texture& tex);
+		void create_texture_view(resource<RES_TYPE_MAT_OPAQUE>::texture& tex);
+
 		//ctor, dtor, singleton pattern
 		resource_manager(const base_info& base);
 		resource_manager(const resource_manager&) = delete;
@@ -109,10 +195,8 @@ namespace rcq
 		pool_host_memory m_resource_pool;
 		vk_memory m_vk_mappable_memory;
 		monotonic_buffer_device_memory m_mappable_memory;	
-		vk_memory m_vk_dl0_memory;
-		freelist_device_memory m_dl0_memory;
-		vk_memory m_vk_dl1_memory;
-		freelist_device_memory m_dl1_memory;
+		block_device_memory m_dl0_memory;
+		block_device_memory m_dl1_memory;
 
 		//threads
 		std::thread m_build_thread;
@@ -123,16 +207,28 @@ namespace rcq
 		std::atomic_bool m_should_end_destroy;
 
 		//queues
-		queue<base_resource_build_info> m_build_queue;
-		queue<base_resource*> m_destroy_queue;
+		mpmc_queue<base_resource_build_info> m_build_queue;
+		mpmc_queue<destroy_request> m_destroy_queue;
+
+		//main thread only
+		vector<base_resource_build_info*> m_claimed_builds;
+		vector<destroy_request> m_pending_destroys;
+		uint64_t m_submitted_frame_count;
+		vector<relocation> m_relocations;
+		vector<destroy_request> m_relocation_destroys;
+		vector<base_resource*> m_defragment_candidates;
 
-		//mutexes
-		std::mutex m_build_queue_mutex;
-		std::mutex m_destroy_queue_mutex;
+		//destroy thread only
+		vector<destroy_request> m_deferred_destroys; //ordered by frame
+		vector<VkDeviceSize> m_freed_dl0_offsets;
+		vector<VkDeviceSize> m_freed_dl1_offsets;
+		std::atomic<size_t> m_deferred_destroy_count;
 
-		//condition variables
-		std::condition_variable m_build_queue_cv;
-		std::condition_variable m_destroy_queue_cv;
+		//the device local memories, the descriptor pools and the resource build queue, held by the build thread for a whole build,
+		//by the destroy thread while it retires and by the defragmentation
+		std::mutex m_memory_mutex;
+		//signalled by the destroy thread after it freed device memory, a build refused a new block waits for it
+		std::condition_variable_any m_memory_freed_cv;
 
 		//pools
 		dp_pool m_dp_pools[DSL_TYPE_COUNT];
@@ -145,11 +241,18 @@ namespace rcq
 		VkFence m_build_f;
 		VkCommandPool m_build_cp;
 		VkCommandBuffer m_build_cb;
+		VkCommandPool m_defragment_cp;
+		VkCommandBuffer m_defragment_cb;
+		VkFence m_defragment_f;
+		bool m_defragment_submitted;
+		uint64_t m_defragment_frame; //the frame running after the last copies, held under the memory mutex
 
 		//helper functions
 		void begin_build_cb();
 		void end_build_cb(const VkSemaphore* wait_semaphores=nullptr, const VkPipelineStageFlags* wait_flags=nullptr, 
 			uint32_t wait_count=0);
 		void wait_for_build_fence();
+		bool allocate_device_memory(block_device_memory& memory, VkDeviceSize size, VkDeviceSize alignment, const void* owner,
+			VkDeviceSize& p);
 	};
 }
\ No newline at end of file
@@ -4,19 +4,13 @@ using namespace rcq;
 
 void resource_manager::build_loop()
 {
-	while (!m_should_end_build || !m_build_queue.empty())
-	{
-		if (m_build_queue.empty())
-		{
-			std::unique_lock<std::mutex> lock(m_build_queue_mutex);
-			while (m_build_queue.empty() && !m_should_end_build)
-				m_build_queue_cv.wait(lock);
-
-			if (m_should_end_build)
-				continue;
-		}
+	RCQ_TRACE_THREAD_NAME("resource build");
 
-		base_resource_build_info* info = m_build_queue.front();
+	base_resource_build_info build_info;
+	while (m_build_queue.pop_wait(build_info, m_should_end_build))
+	{
+		base_resource_build_info* info = &build_info;
+		std::lock_guard<std::mutex> lock(m_memory_mutex);
 		switch (info->resource_type)
 		{
 		case 0:
@@ -40,8 +34,5 @@ void resource_manager::build_loop()
 		}
 		static_assert(6 == RES_TYPE_COUNT);
 		m_mappable_memory.clear();
-
-		m_build_queue.pop();
-
 	}
 }
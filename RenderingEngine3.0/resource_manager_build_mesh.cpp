@@ -7,8 +7,9 @@ using namespace rcq;
 template<>
 void resource_manager::build<RES_TYPE_MESH>(base_resource* res, const char* build_info)
 {
+	RCQ_TRACE_SCOPE("resource_manager::build<mesh>");
 	const resource<RES_TYPE_MESH>::build_info* build = reinterpret_cast<const resource<RES_TYPE_MESH>::build_info*>(build_info);
-	auto& mesh = *reinterpret_cast<resource<RES_TYPE_MESH>*>(res);
+	auto& mesh = *reinterpret_cast<resource<RES_TYPE_MESH>*>(res->data);
 
 	vector<vertex> vertices(&m_host_memory);
 	vector<uint32_t> indices(&m_host_memory);
@@ -20,6 +21,9 @@ void resource_manager::build<RES_TYPE_MESH>(base_resource* res, const char* buil
 	size_t vb_size = sizeof(vertex)*vertices.size();
 	size_t ib_size = sizeof(uint32_t)*indices.size();
 	size_t veb_size = build->calc_tb ? sizeof(vertex_ext)*vertices_ext.size() : 0;
+	mesh.vb_size = vb_size;
+	mesh.ib_size = ib_size;
+	mesh.veb_size = veb_size;
 
 	//size_t sb_size = vb_size + ib_size + veb_size; //staging buffer size
 
@@ -33,7 +37,7 @@ void resource_manager::build<RES_TYPE_MESH>(base_resource* res, const char* buil
 	vb_info.sType = VK_STRUCTURE_TYPE_BUFFER_CREATE_INFO;
 	vb_info.sharingMode = VK_SHARING_MODE_EXCLUSIVE;
 	vb_info.size = vb_size;
-	vb_info.usage = VK_BUFFER_USAGE_VERTEX_BUFFER_BIT | VK_BUFFER_USAGE_TRANSFER_DST_BIT;
+	vb_info.usage = VK_BUFFER_USAGE_VERTEX_BUFFER_BIT | VK_BUFFER_USAGE_TRANSFER_DST_BIT | VK_BUFFER_USAGE_TRANSFER_SRC_BIT;
 
 	assert(vkCreateBuffer(m_base.device, &vb_info, m_vk_alloc, &mesh.vb) == VK_SUCCESS);
 
@@ -45,7 +49,7 @@ void resource_manager::build<RES_TYPE_MESH>(base_resource* res, const char* buil
 	ib_info.sType = VK_STRUCTURE_TYPE_BUFFER_CREATE_INFO;
 	ib_info.sharingMode = VK_SHARING_MODE_EXCLUSIVE;
 	ib_info.size = ib_size;
-	ib_info.usage = VK_BUFFER_USAGE_INDEX_BUFFER_BIT | VK_BUFFER_USAGE_TRANSFER_DST_BIT;
+	ib_info.usage = VK_BUFFER_USAGE_INDEX_BUFFER_BIT | VK_BUFFER_USAGE_TRANSFER_DST_BIT | VK_BUFFER_USAGE_TRANSFER_SRC_BIT;
 
 	assert(vkCreateBuffer(m_base.device, &ib_info, m_vk_alloc, &mesh.ib) == VK_SUCCESS);
 
@@ -63,7 +67,7 @@ void resource_manager::build<RES_TYPE_MESH>(base_resource* res, const char* buil
 		veb_info.sType = VK_STRUCTURE_TYPE_BUFFER_CREATE_INFO;
 		veb_info.sharingMode = VK_SHARING_MODE_EXCLUSIVE;
 		veb_info.size = veb_size;
-		veb_info.usage = VK_BUFFER_USAGE_VERTEX_BUFFER_BIT | VK_BUFFER_USAGE_TRANSFER_DST_BIT;
+		veb_info.usage = VK_BUFFER_USAGE_VERTEX_BUFFER_BIT | VK_BUFFER_USAGE_TRANSFER_DST_BIT | VK_BUFFER_USAGE_TRANSFER_SRC_BIT;
 
 		assert(vkCreateBuffer(m_base.device, &veb_info, m_vk_alloc, &mesh.veb) == VK_SUCCESS);
 
@@ -76,9 +80,13 @@ void resource_manager::build<RES_TYPE_MESH>(base_resource* res, const char* buil
 	}
 
 	//allocate buffer memory
-	mesh.vb_offset = m_dl0_memory.allocate(vb_mr.size, vb_mr.alignment);
-	mesh.ib_offset = m_dl0_memory.allocate(ib_mr.size, ib_mr.alignment);
-	mesh.veb_offset = build->calc_tb ? m_dl0_memory.allocate(veb_mr.size, veb_mr.alignment) : 0;
+	if (!allocate_device_memory(m_dl0_memory, vb_mr.size, vb_mr.alignment, res, mesh.vb_offset))
+		return;
+	if (!allocate_device_memory(m_dl0_memory, ib_mr.size, ib_mr.alignment, res, mesh.ib_offset))
+		return;
+	mesh.veb_offset = 0;
+	if (build->calc_tb && !allocate_device_memory(m_dl0_memory, veb_mr.size, veb_mr.alignment, res, mesh.veb_offset))
+		return;
 
 	/*VkDeviceSize ib_offset = calc_offset(ib_mr.alignment, vb_mr.size);
 	VkDeviceSize veb_offset = calc_offset(veb_mr.alignment, ib_offset + ib_mr.size);
@@ -96,10 +104,13 @@ void resource_manager::build<RES_TYPE_MESH>(base_resource* res, const char* buil
 	}*/
 
 	//bind buffers to memory
-	vkBindBufferMemory(m_base.device, mesh.vb, m_dl0_memory.handle(), mesh.vb_offset);
-	vkBindBufferMemory(m_base.device, mesh.ib, m_dl0_memory.handle(), mesh.ib_offset);
+	vkBindBufferMemory(m_base.device, mesh.vb, m_dl0_memory.handle(mesh.vb_offset),
+		block_device_memory::memory_offset(mesh.vb_offset));
+	vkBindBufferMemory(m_base.device, mesh.ib, m_dl0_memory.handle(mesh.ib_offset),
+		block_device_memory::memory_offset(mesh.ib_offset));
 	if (build->calc_tb)
-		vkBindBufferMemory(m_base.device, mesh.veb, m_dl0_memory.handle(), mesh.veb_offset);
+		vkBindBufferMemory(m_base.device, mesh.veb, m_dl0_memory.handle(mesh.veb_offset),
+			block_device_memory::memory_offset(mesh.veb_offset));
 
 	//fill staging buffer
 
@@ -4,9 +4,47 @@
 
 using namespace rcq;
 
+//the textures are created with the same info by the build and the defragmentation
+void resource_manager::create_texture_image(resource<RES_TYPE_MAT_OPAQUE>::texture& tex)
+{
+	VkImageCreateInfo im = {};
+	im.sType = VK_STRUCTURE_TYPE_IMAGE_CREATE_INFO;
+	im.arrayLayers = 1;
+	im.extent.width = tex.width;
+	im.extent.height = tex.height;
+	im.extent.depth = 1;
+	im.format = VK_FORMAT_R8G8B8A8_UNORM;
+	im.imageType = VK_IMAGE_TYPE_2D;
+	im.initialLayout = VK_IMAGE_LAYOUT_UNDEFINED;
+	im.mipLevels = tex.mip_level_count;
+	im.samples = VK_SAMPLE_COUNT_1_BIT;
+	im.sharingMode = VK_SHARING_MODE_EXCLUSIVE;
+	im.tiling = VK_IMAGE_TILING_OPTIMAL;
+	im.usage = VK_IMAGE_USAGE_TRANSFER_DST_BIT | VK_IMAGE_USAGE_SAMPLED_BIT | VK_IMAGE_USAGE_TRANSFER_SRC_BIT;
+
+	assert(vkCreateImage(m_base.device, &im, m_vk_alloc, &tex.image) == VK_SUCCESS);
+}
+
+void resource_manager::create_texture_view(resource<RES_TYPE_MAT_OPAQUE>::texture& tex)
+{
+	VkImageViewCreateInfo view = {};
+	view.sType = VK_STRUCTURE_TYPE_IMAGE_VIEW_CREATE_INFO;
+	view.format = VK_FORMAT_R8G8B8A8_UNORM;
+	view.image = tex.image;
+	view.subresourceRange.aspectMask = VK_IMAGE_ASPECT_COLOR_BIT;
+	view.subresourceRange.baseArrayLayer = 0;
+	view.subresourceRange.baseMipLevel = 0;
+	view.subresourceRange.layerCount = 1;
+	view.subresourceRange.levelCount = tex.mip_level_count;
+	view.viewType = VK_IMAGE_VIEW_TYPE_2D;
+
+	assert(vkCreateImageView(m_base.device, &view, m_vk_alloc, &tex.view) == VK_SUCCESS);
+}
+
 template<>
 void resource_manager::build<RES_TYPE_MAT_OPAQUE>(base_resource* res, const char* build_info)
 {
+	RCQ_TRACE_SCOPE("resource_manager::build<opaque_material>");
 	const resource<RES_TYPE_MAT_OPAQUE>::build_info* build = reinterpret_cast<const resource<RES_TYPE_MAT_OPAQUE>::build_info*>(build_info);
 
 	auto& mat = *reinterpret_cast<resource<RES_TYPE_MAT_OPAQUE>*>(res->data);
@@ -43,34 +81,21 @@ void resource_manager::build<RES_TYPE_MAT_OPAQUE>(base_resource* res, const char
 				mip_level_size >>= 1;
 				++mip_level_count;
 			}
+			tex.width = static_cast<uint32_t>(width);
+			tex.height = static_cast<uint32_t>(height);
+			tex.mip_level_count = mip_level_count;
 
-			//create image
-			{
-				VkImageCreateInfo im = {};
-				im.sType = VK_STRUCTURE_TYPE_IMAGE_CREATE_INFO;
-				im.arrayLayers = 1;
-				im.extent.width = static_cast<uint32_t>(width);
-				im.extent.height = static_cast<uint32_t>(height);
-				im.extent.depth = 1;
-				im.format = VK_FORMAT_R8G8B8A8_UNORM;
-				im.imageType = VK_IMAGE_TYPE_2D;
-				im.initialLayout = VK_IMAGE_LAYOUT_UNDEFINED;
-				im.mipLevels = mip_level_count;
-				im.samples = VK_SAMPLE_COUNT_1_BIT;
-				im.sharingMode = VK_SHARING_MODE_EXCLUSIVE;
-				im.tiling = VK_IMAGE_TILING_OPTIMAL;
-				im.usage = VK_IMAGE_USAGE_TRANSFER_DST_BIT | VK_IMAGE_USAGE_SAMPLED_BIT | VK_IMAGE_USAGE_TRANSFER_SRC_BIT;
-
-				assert(vkCreateImage(m_base.device, &im, m_vk_alloc, &tex.image) == VK_SUCCESS);
-			}
+			create_texture_image(tex);
 
 			//allocate memory for image
 			VkMemoryRequirements mr;
 			vkGetImageMemoryRequirements(m_base.device, tex.image, &mr);
 
-			tex.offset = m_dl1_memory.allocate(mr.size, mr.alignment);
+			if (!allocate_device_memory(m_dl1_memory, mr.size, mr.alignment, res, tex.offset))
+				return;
 
-			vkBindImageMemory(m_base.device, tex.image, m_dl1_memory.handle(), tex.offset);
+			vkBindImageMemory(m_base.device, tex.image, m_dl1_memory.handle(tex.offset),
+				block_device_memory::memory_offset(tex.offset));
 
 			//transition level0 layout to transfer dst optimal
 			{
@@ -189,22 +214,7 @@ void resource_manager::build<RES_TYPE_MAT_OPAQUE>(base_resource* res, const char
 				2, barriers
 			);
 
-			//create image view
-			{
-				VkImageViewCreateInfo view = {};
-				view.sType = VK_STRUCTURE_TYPE_IMAGE_VIEW_CREATE_INFO;
-				view.format = VK_FORMAT_R8G8B8A8_UNORM;
-				view.image = tex.image;
-				view.subresourceRange.aspectMask = VK_IMAGE_ASPECT_COLOR_BIT;
-				view.subresourceRange.baseArrayLayer = 0;
-				view.subresourceRange.baseMipLevel = 0;
-				view.subresourceRange.layerCount = 1;
-				view.subresourceRange.levelCount = mip_level_count;
-				view.viewType = VK_IMAGE_VIEW_TYPE_2D;
-
-				assert(vkCreateImageView(m_base.device, &view, m_vk_alloc,
-					&tex.view) == VK_SUCCESS);
-			}
+			create_texture_view(tex);
 
 			//create sampler
 			{
@@ -239,7 +249,7 @@ void resource_manager::build<RES_TYPE_MAT_OPAQUE>(base_resource* res, const char
 		buffer.sType = VK_STRUCTURE_TYPE_BUFFER_CREATE_INFO;
 		buffer.sharingMode = VK_SHARING_MODE_EXCLUSIVE;
 		buffer.size = sizeof(resource<RES_TYPE_MAT_OPAQUE>::data);
-		buffer.usage = VK_BUFFER_USAGE_UNIFORM_BUFFER_BIT | VK_BUFFER_USAGE_TRANSFER_DST_BIT;
+		buffer.usage = VK_BUFFER_USAGE_UNIFORM_BUFFER_BIT | VK_BUFFER_USAGE_TRANSFER_DST_BIT | VK_BUFFER_USAGE_TRANSFER_SRC_BIT;
 		assert(vkCreateBuffer(m_base.device, &buffer, m_vk_alloc, &mat.data_buffer) == VK_SUCCESS);
 	}
 
@@ -247,8 +257,10 @@ void resource_manager::build<RES_TYPE_MAT_OPAQUE>(base_resource* res, const char
 	{
 		VkMemoryRequirements mr;
 		vkGetBufferMemoryRequirements(m_base.device, mat.data_buffer, &mr);
-		mat.data_offset = m_dl0_memory.allocate(mr.size, mr.alignment);
-		vkBindBufferMemory(m_base.device, mat.data_buffer, m_dl0_memory.handle(), mat.data_offset);
+		if (!allocate_device_memory(m_dl0_memory, mr.size, mr.alignment, res, mat.data_offset))
+			return;
+		vkBindBufferMemory(m_base.device, mat.data_buffer, m_dl0_memory.handle(mat.data_offset),
+			block_device_memory::memory_offset(mat.data_offset));
 		/*VkMemoryAllocateInfo alloc = {};
 		alloc.sType = VK_STRUCTURE_TYPE_MEMORY_ALLOCATE_INFO;
 		alloc.allocationSize = mr.size;
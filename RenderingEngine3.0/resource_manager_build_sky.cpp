@@ -7,6 +7,7 @@ using namespace rcq;
 template<>
 void resource_manager::build<RES_TYPE_SKY>(base_resource* res, const char* build_info)
 {
+	RCQ_TRACE_SCOPE("resource_manager::build<sky>");
 	resource<RES_TYPE_SKY>* s = reinterpret_cast<resource<RES_TYPE_SKY>*>(res->data);
 	const auto build = reinterpret_cast<const resource<RES_TYPE_SKY>::build_info*>(build_info);
 
@@ -59,8 +60,10 @@ void resource_manager::build<RES_TYPE_SKY>(base_resource* res, const char* build
 
 			VkMemoryRequirements mr;
 			vkGetImageMemoryRequirements(m_base.device, s->tex[i].image, &mr);
-			s->tex[i].offset = m_dl1_memory.allocate(mr.size, mr.alignment);
-			vkBindImageMemory(m_base.device, s->tex[i].image, m_dl1_memory.handle(), s->tex[i].offset);
+			if (!allocate_device_memory(m_dl1_memory, mr.size, mr.alignment, nullptr, s->tex[i].offset))
+				return;
+			vkBindImageMemory(m_base.device, s->tex[i].image, m_dl1_memory.handle(s->tex[i].offset),
+				block_device_memory::memory_offset(s->tex[i].offset));
 
 			VkImageViewCreateInfo view = {};
 			view.sType = VK_STRUCTURE_TYPE_IMAGE_VIEW_CREATE_INFO;
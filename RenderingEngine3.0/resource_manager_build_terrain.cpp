@@ -1,6 +1,7 @@
 #include "resource_manager.h"
 
-#include <fstream>
+#include "utility.h"
+
 #include <assert.h>
 
 using namespace rcq;
@@ -8,25 +9,61 @@ using namespace rcq;
 template<>
 void resource_manager::build<RES_TYPE_TERRAIN>(base_resource* res, const char* build_info)
 {
+	RCQ_TRACE_SCOPE("resource_manager::build<terrain>");
+	assert(m_base.enabled_features.sparseBinding);
+
 	auto t = reinterpret_cast<resource<RES_TYPE_TERRAIN>*>(res->data);
 	auto build = reinterpret_cast<const resource<RES_TYPE_TERRAIN>::build_info*>(build_info);
 
-	new(&t->tex.files) vector<std::ifstream>(&m_host_memory, build->mip_level_count);
+	new(&t->tex.files) vector<raw_file>(&m_host_memory, build->mip_level_count);
+	new(&t->tex.tile_entries) vector<vector<terrain_file::tile_entry>>(&m_host_memory, build->mip_level_count);
 
 	t->level0_tile_size = build->level0_tile_size;
 	t->mip_level_count = build->mip_level_count;
+	t->tile_count = build->level0_image_size / build->level0_tile_size;
+	t->tile_size_in_meters = glm::vec2(build->size_in_meters.x, build->size_in_meters.z) / glm::vec2(t->tile_count);
+	t->page_budget = build->page_budget;
+	t->prefetch_budget = build->prefetch_budget;
 
-	//open files
+	//open files, the row-major .terr files are converted to packed, tile-major .tiles files on first use
 	for (uint32_t i = 0; i < build->mip_level_count; ++i)
 	{
 		char filename[128];
+		char terr_filename[128];
 		char num[2];
 		strcpy_s(filename, build->filename);
 		_itoa_s(i, num, 10);
 		strcat_s(filename, num);
-		strcat_s(filename, ".terr");
-		new(&t->tex.files[i]) std::ifstream(filename, std::ios::binary);
-		assert(t->tex.files[i].is_open());
+		strcpy_s(terr_filename, filename);
+		strcat_s(filename, ".tiles");
+		strcat_s(terr_filename, ".terr");
+
+		glm::uvec2 tile_size = build->level0_tile_size / (1u << i);
+
+		auto& file = t->tex.files[i];
+		new(&file) raw_file;
+		terrain_file::header header = {};
+		bool valid = file.open(filename) && file.read(&header, sizeof(terrain_file::header), 0) &&
+			header.magic == terrain_file::MAGIC && header.version == terrain_file::VERSION;
+
+		//missing, short or outdated files are converted again
+		if (!valid)
+		{
+			file.close();
+			utility::convert_terrain_file(terr_filename, filename, t->tile_count, tile_size);
+			bool opened = file.open(filename);
+			assert(opened);
+			bool read = file.read(&header, sizeof(terrain_file::header), 0);
+			assert(read);
+		}
+
+		assert(header.tile_count == t->tile_count && header.tile_size == tile_size);
+		assert(header.texel_size == sizeof(terrain_file::texel));
+
+		auto& entries = t->tex.tile_entries[i];
+		new(&entries) vector<terrain_file::tile_entry>(&m_host_memory, t->tile_count.x*t->tile_count.y);
+		bool read = file.read(entries.data(), entries.size() * sizeof(terrain_file::tile_entry), sizeof(terrain_file::header));
+		assert(read);
 	}
 
 	//create image
@@ -38,7 +75,7 @@ void resource_manager::build<RES_TYPE_TERRAIN>(base_resource* res, const char* b
 		image.extent.height = build->level0_image_size.y;
 		image.extent.depth = 1;
 		image.flags = VK_IMAGE_CREATE_SPARSE_BINDING_BIT;
-		image.format = VK_FORMAT_R32G32B32A32_SFLOAT;
+		image.format = VK_FORMAT_R32_UINT;
 		image.imageType = VK_IMAGE_TYPE_2D;
 		image.initialLayout = VK_IMAGE_LAYOUT_UNDEFINED;
 		image.mipLevels = build->mip_level_count;
@@ -65,14 +102,17 @@ void resource_manager::build<RES_TYPE_TERRAIN>(base_resource* res, const char* b
 		VkMemoryRequirements mr;
 		vkGetImageMemoryRequirements(m_base.device, t->tex.image, &mr);
 
-		uint64_t dummy_page_size = sparse_mr.formatProperties.imageGranularity.width*sparse_mr.formatProperties.imageGranularity.height;
-		t->tex.mip_tail_offset = m_dl1_memory.allocate(sparse_mr.imageMipTailSize, mr.alignment);
-		t->tex.dummy_page_offset = m_dl1_memory.allocate(dummy_page_size, mr.alignment);
+		//a page is one sparse block, for 32 bit texels it covers 128x128 texels
+		uint64_t dummy_page_size = mr.alignment;
+		if (!allocate_device_memory(m_dl1_memory, sparse_mr.imageMipTailSize, mr.alignment, nullptr, t->tex.mip_tail_offset))
+			return;
+		if (!allocate_device_memory(m_dl1_memory, dummy_page_size, mr.alignment, nullptr, t->tex.dummy_page_offset))
+			return;
 
 		//mip tail bind
 		VkSparseMemoryBind mip_tail = {};
-		mip_tail.memory = m_dl1_memory.handle();
-		mip_tail.memoryOffset = t->tex.mip_tail_offset;
+		mip_tail.memory = m_dl1_memory.handle(t->tex.mip_tail_offset);
+		mip_tail.memoryOffset = block_device_memory::memory_offset(t->tex.mip_tail_offset);
 		mip_tail.resourceOffset = sparse_mr.imageMipTailOffset;
 		mip_tail.size = sparse_mr.imageMipTailSize;
 
@@ -82,10 +122,13 @@ void resource_manager::build<RES_TYPE_TERRAIN>(base_resource* res, const char* b
 		mip_tail_bind.pBinds = &mip_tail;
 
 
-		glm::vec2 tile_count = build->level0_image_size / build->level0_tile_size;
-		t->tile_count = tile_count;
+		glm::vec2 tile_count = t->tile_count;
 		glm::uvec2 page_size(sparse_mr.formatProperties.imageGranularity.width,
 			sparse_mr.formatProperties.imageGranularity.height);
+		t->tex.page_size = page_size;
+
+		//tiles of every level are bound page by page
+		assert(((build->level0_tile_size >> (build->mip_level_count - 1u)) % page_size) == glm::uvec2(0));
 		glm::uvec2 page_count_in_level0_image = build->level0_image_size / page_size;
 
 		uint32_t page_count0 = page_count_in_level0_image.x*page_count_in_level0_image.y;
@@ -126,8 +169,8 @@ void resource_manager::build<RES_TYPE_TERRAIN>(base_resource* res, const char* b
 								static_cast<int32_t>(v*page_size.y),
 								0
 							};
-							page_binds[page_index].memory = m_dl1_memory.handle();
-							page_binds[page_index].memoryOffset = t->tex.dummy_page_offset;
+							page_binds[page_index].memory = m_dl1_memory.handle(t->tex.dummy_page_offset);
+							page_binds[page_index].memoryOffset = block_device_memory::memory_offset(t->tex.dummy_page_offset);
 							page_binds[page_index].offset =
 							{
 								tile_offset.x + page_offset_in_tile.x,
@@ -172,6 +215,7 @@ void resource_manager::build<RES_TYPE_TERRAIN>(base_resource* res, const char* b
 		bind_info.signalSemaphoreCount = 1;
 		bind_info.pSignalSemaphores = &binding_finished_s;
 
+		std::lock_guard<std::mutex> lock(*m_base.queue_mutexes[QUEUE_RESOURCE_BUILD]);
 		vkQueueBindSparse(m_base.queues[QUEUE_RESOURCE_BUILD], 1, &bind_info, VK_NULL_HANDLE);
 	}
 
@@ -188,8 +232,10 @@ void resource_manager::build<RES_TYPE_TERRAIN>(base_resource* res, const char* b
 
 		VkMemoryRequirements mr;
 		vkGetBufferMemoryRequirements(m_base.device, t->data_buffer, &mr);
-		t->data_offset = m_dl0_memory.allocate(mr.size, mr.alignment);
-		vkBindBufferMemory(m_base.device, t->data_buffer, m_dl0_memory.handle(), t->data_offset);
+		if (!allocate_device_memory(m_dl0_memory, mr.size, mr.alignment, nullptr, t->data_offset))
+			return;
+		vkBindBufferMemory(m_base.device, t->data_buffer, m_dl0_memory.handle(t->data_offset),
+			block_device_memory::memory_offset(t->data_offset));
 
 		data_staging_buffer_offset = m_mappable_memory.allocate(sizeof(resource<RES_TYPE_TERRAIN>::data),
 			alignof(resource<RES_TYPE_TERRAIN>::data));
@@ -220,8 +266,10 @@ void resource_manager::build<RES_TYPE_TERRAIN>(base_resource* res, const char* b
 
 		VkMemoryRequirements mr;
 		vkGetBufferMemoryRequirements(m_base.device, t->request_data_buffer, &mr);
-		t->request_data_offset = m_dl0_memory.allocate(mr.size, mr.alignment);
-		vkBindBufferMemory(m_base.device, t->request_data_buffer, m_dl0_memory.handle(), t->request_data_offset);
+		if (!allocate_device_memory(m_dl0_memory, mr.size, mr.alignment, nullptr, t->request_data_offset))
+			return;
+		vkBindBufferMemory(m_base.device, t->request_data_buffer, m_dl0_memory.handle(t->request_data_offset),
+			block_device_memory::memory_offset(t->request_data_offset));
 
 		request_data_staging_buffer_offset = m_mappable_memory.allocate(sizeof(resource<RES_TYPE_TERRAIN>::request_data),
 			alignof(resource<RES_TYPE_TERRAIN>::request_data));
@@ -297,7 +345,7 @@ void resource_manager::build<RES_TYPE_TERRAIN>(base_resource* res, const char* b
 	{
 		VkImageViewCreateInfo view = {};
 		view.sType = VK_STRUCTURE_TYPE_IMAGE_VIEW_CREATE_INFO;
-		view.format = VK_FORMAT_R32G32B32A32_SFLOAT;
+		view.format = VK_FORMAT_R32_UINT;
 		view.image = t->tex.image;
 		view.viewType = VK_IMAGE_VIEW_TYPE_2D;
 		view.subresourceRange.aspectMask = VK_IMAGE_ASPECT_COLOR_BIT;
@@ -5,6 +5,7 @@ using namespace rcq;
 template<>
 void resource_manager::build<RES_TYPE_TR>(base_resource* res, const char* build_info)
 {
+	RCQ_TRACE_SCOPE("resource_manager::build<transform>");
 
 	auto& tr = *reinterpret_cast<resource<RES_TYPE_TR>*>(res->data);
 	const auto& build = *reinterpret_cast<const resource<RES_TYPE_TR>::build_info*>(build_info);
@@ -15,7 +16,7 @@ void resource_manager::build<RES_TYPE_TR>(base_resource* res, const char* build_
 		buffer.sType = VK_STRUCTURE_TYPE_BUFFER_CREATE_INFO;
 		buffer.sharingMode = VK_SHARING_MODE_EXCLUSIVE;
 		buffer.size = sizeof(resource<RES_TYPE_TR>::data);
-		buffer.usage = VK_BUFFER_USAGE_UNIFORM_BUFFER_BIT | VK_BUFFER_USAGE_TRANSFER_DST_BIT;
+		buffer.usage = VK_BUFFER_USAGE_UNIFORM_BUFFER_BIT | VK_BUFFER_USAGE_TRANSFER_DST_BIT | VK_BUFFER_USAGE_TRANSFER_SRC_BIT;
 
 		assert(vkCreateBuffer(m_base.device, &buffer, m_vk_alloc, &tr.data_buffer) == VK_SUCCESS);
 	}
@@ -25,8 +26,10 @@ void resource_manager::build<RES_TYPE_TR>(base_resource* res, const char* build_
 		VkMemoryRequirements mr;
 		vkGetBufferMemoryRequirements(m_base.device, tr.data_buffer, &mr);
 
-		tr.data_offset = m_dl0_memory.allocate(mr.size, mr.alignment);
-		vkBindBufferMemory(m_base.device, tr.data_buffer, m_dl0_memory.handle(), tr.data_offset);
+		if (!allocate_device_memory(m_dl0_memory, mr.size, mr.alignment, res, tr.data_offset))
+			return;
+		vkBindBufferMemory(m_base.device, tr.data_buffer, m_dl0_memory.handle(tr.data_offset),
+			block_device_memory::memory_offset(tr.data_offset));
 	}
 
 	//allocate and fill staging memory
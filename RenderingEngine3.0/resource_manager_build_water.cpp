@@ -10,12 +10,20 @@ using namespace rcq;
 template<>
 void resource_manager::build<RES_TYPE_WATER>(base_resource* res, const char* build_info)
 {
+	RCQ_TRACE_SCOPE("resource_manager::build<water>");
 	auto w = reinterpret_cast<resource<RES_TYPE_WATER>*>(res->data);
 	const auto build = reinterpret_cast<const resource<RES_TYPE_WATER>::build_info*>(build_info);
 
 	w->grid_size_in_meters = build->grid_size_in_meters;
+	w->grid_size = build->grid_size;
+	assert(w->grid_size == WATER_GRID_SIZE_256 || w->grid_size == WATER_GRID_SIZE_512 || w->grid_size == WATER_GRID_SIZE_1024);
 
-	uint32_t noise_size = resource<RES_TYPE_WATER>::GRID_SIZE*resource<RES_TYPE_WATER>::GRID_SIZE * sizeof(glm::vec4);
+	uint32_t grid_size_log2 = 0;
+	while ((1u << grid_size_log2) < w->grid_size)
+		++grid_size_log2;
+
+	//the noise file always holds MAX_WATER_GRID_SIZE^2 samples, smaller grids use its upper left corner
+	uint32_t noise_size = MAX_WATER_GRID_SIZE * MAX_WATER_GRID_SIZE * sizeof(glm::vec4);
 
 	uint64_t noise_staging_buffer_offset = m_mappable_memory.allocate(noise_size, 1);
 	char* data = reinterpret_cast<char*>(m_mappable_memory.map(noise_staging_buffer_offset, noise_size));
@@ -28,7 +36,7 @@ void resource_manager::build<RES_TYPE_WATER>(base_resource* res, const char* bui
 		VkImageCreateInfo im = {};
 		im.sType = VK_STRUCTURE_TYPE_IMAGE_CREATE_INFO;
 		im.arrayLayers = 1;
-		im.extent = { WATER_GRID_SIZE, WATER_GRID_SIZE, 1 };
+		im.extent = { w->grid_size, w->grid_size, 1 };
 		im.format = VK_FORMAT_R32G32B32A32_SFLOAT;
 		im.imageType = VK_IMAGE_TYPE_2D;
 		im.initialLayout = VK_IMAGE_LAYOUT_UNDEFINED;
@@ -42,8 +50,10 @@ void resource_manager::build<RES_TYPE_WATER>(base_resource* res, const char* bui
 
 		VkMemoryRequirements mr;
 		vkGetImageMemoryRequirements(m_base.device, w->noise.image, &mr);
-		w->noise.offset = m_dl1_memory.allocate(mr.size, mr.alignment);
-		vkBindImageMemory(m_base.device, w->noise.image, m_dl1_memory.handle(), w->noise.offset);
+		if (!allocate_device_memory(m_dl1_memory, mr.size, mr.alignment, nullptr, w->noise.offset))
+			return;
+		vkBindImageMemory(m_base.device, w->noise.image, m_dl1_memory.handle(w->noise.offset),
+			block_device_memory::memory_offset(w->noise.offset));
 
 		VkImageViewCreateInfo view = {};
 		view.sType = VK_STRUCTURE_TYPE_IMAGE_VIEW_CREATE_INFO;
@@ -64,8 +74,8 @@ void resource_manager::build<RES_TYPE_WATER>(base_resource* res, const char* bui
 		VkImageCreateInfo im = {};
 		im.sType = VK_STRUCTURE_TYPE_IMAGE_CREATE_INFO;
 		im.arrayLayers = 2;
-		im.extent = { resource<RES_TYPE_WATER>::GRID_SIZE, resource<RES_TYPE_WATER>::GRID_SIZE, 1 };
-		im.format = VK_FORMAT_R32G32B32A32_SFLOAT;
+		im.extent = { w->grid_size, w->grid_size, 1 };
+		im.format = VK_FORMAT_R16G16B16A16_SFLOAT;
 		im.imageType = VK_IMAGE_TYPE_2D;
 		im.initialLayout = VK_IMAGE_LAYOUT_UNDEFINED;
 		im.mipLevels = 1;
@@ -78,12 +88,14 @@ void resource_manager::build<RES_TYPE_WATER>(base_resource* res, const char* bui
 
 		VkMemoryRequirements mr;
 		vkGetImageMemoryRequirements(m_base.device, w->tex.image, &mr);
-		w->tex.offset = m_dl1_memory.allocate(mr.size, mr.alignment);
-		vkBindImageMemory(m_base.device, w->tex.image, m_dl1_memory.handle(), w->tex.offset);
+		if (!allocate_device_memory(m_dl1_memory, mr.size, mr.alignment, nullptr, w->tex.offset))
+			return;
+		vkBindImageMemory(m_base.device, w->tex.image, m_dl1_memory.handle(w->tex.offset),
+			block_device_memory::memory_offset(w->tex.offset));
 
 		VkImageViewCreateInfo view = {};
 		view.sType = VK_STRUCTURE_TYPE_IMAGE_VIEW_CREATE_INFO;
-		view.format = VK_FORMAT_R32G32B32A32_SFLOAT;
+		view.format = VK_FORMAT_R16G16B16A16_SFLOAT;
 		view.image = w->tex.image;
 		view.viewType = VK_IMAGE_VIEW_TYPE_2D_ARRAY;
 		view.subresourceRange.aspectMask = VK_IMAGE_ASPECT_COLOR_BIT;
@@ -104,6 +116,8 @@ void resource_manager::build<RES_TYPE_WATER>(base_resource* res, const char* bui
 	params->base_frequency = build->base_frequency;
 	params->sqrtA = sqrtf(build->A);
 	params->two_pi_per_L = glm::vec2(2.f*PI) / build->grid_size_in_meters;
+	params->grid_size = w->grid_size;
+	params->grid_size_log2 = grid_size_log2;
 	m_mappable_memory.unmap();
 
 	//create fft params buffer
@@ -118,8 +132,10 @@ void resource_manager::build<RES_TYPE_WATER>(base_resource* res, const char* bui
 
 		VkMemoryRequirements mr;
 		vkGetBufferMemoryRequirements(m_base.device, w->fft_params_buffer, &mr);
-		w->fft_params_offset = m_dl0_memory.allocate(mr.size, mr.alignment);
-		vkBindBufferMemory(m_base.device, w->fft_params_buffer, m_dl0_memory.handle(), w->fft_params_offset);
+		if (!allocate_device_memory(m_dl0_memory, mr.size, mr.alignment, nullptr, w->fft_params_offset))
+			return;
+		vkBindBufferMemory(m_base.device, w->fft_params_buffer, m_dl0_memory.handle(w->fft_params_offset),
+			block_device_memory::memory_offset(w->fft_params_offset));
 	}
 
 	//transition layouts and copy from staging buffers
@@ -169,10 +185,10 @@ void resource_manager::build<RES_TYPE_WATER>(base_resource* res, const char* bui
 
 		VkBufferImageCopy bic = {};
 		bic.bufferImageHeight = 0;
-		bic.bufferRowLength = 0;
+		bic.bufferRowLength = MAX_WATER_GRID_SIZE;
 		bic.bufferOffset = noise_staging_buffer_offset;
 		bic.imageOffset = { 0, 0, 0 };
-		bic.imageExtent = { resource<RES_TYPE_WATER>::GRID_SIZE, resource<RES_TYPE_WATER>::GRID_SIZE, 1 };
+		bic.imageExtent = { w->grid_size, w->grid_size, 1 };
 		bic.imageSubresource.aspectMask = VK_IMAGE_ASPECT_COLOR_BIT;
 		bic.imageSubresource.baseArrayLayer = 0;
 		bic.imageSubresource.layerCount = 1;
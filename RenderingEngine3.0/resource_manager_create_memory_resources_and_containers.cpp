@@ -1,10 +1,12 @@
 #include "resource_manager.h"
 
 #include "os_memory.h"
+#include "memory_registry.h"
 
 #include "utility.h"
 
 #include "const_max_alignment.h"
+#include "const_device_memory_block_size.h"
 
 using namespace rcq;
 
@@ -16,18 +18,40 @@ void resource_manager::create_memory_resources_and_containers()
 	m_resource_pool.init(sizeof(base_resource), alignof(base_resource), &m_host_memory);
 	m_vk_alloc.init(&m_host_memory);
 
-	m_vk_mappable_memory.init(m_base.device, MEMORY_TYPE_HVC, &m_vk_alloc);
-
-	m_vk_dl0_memory.init(m_base.device, MEMORY_TYPE_DL0, &m_vk_alloc);
-	constexpr VkDeviceSize SIZE = VkDeviceSize(1)*VkDeviceSize(1024)*VkDeviceSize(1024)*VkDeviceSize(1024);
-	m_dl0_memory.init(SIZE, m_vk_dl0_memory.max_alignment(), &m_vk_dl0_memory, &m_host_memory);
-
-	m_vk_dl1_memory.init(m_base.device, MEMORY_TYPE_DL1, &m_vk_alloc);
-	m_dl1_memory.init(SIZE, m_vk_dl1_memory.max_alignment(), &m_vk_dl1_memory, &m_host_memory);
-
-	m_build_queue.init(&m_host_memory);
-	m_build_queue.init_buffer();
-
-	m_destroy_queue.init(&m_host_memory);
-	m_destroy_queue.init_buffer();
+	m_vk_mappable_memory.init(m_base.device, m_base.memory_types[MEMORY_TYPE_HVC], &m_vk_alloc);
+
+	//the device local memories grow block by block, the blocks are limited by the device and bounded by their heap
+	VkPhysicalDeviceProperties props;
+	vkGetPhysicalDeviceProperties(m_base.physical_device, &props);
+	VkPhysicalDeviceMemoryProperties memory_props;
+	vkGetPhysicalDeviceMemoryProperties(m_base.physical_device, &memory_props);
+
+	constexpr VkDeviceSize ALIGNMENT = 256 * 1024;
+	uint32_t dl0_type = m_base.memory_types[MEMORY_TYPE_DL0];
+	uint32_t dl1_type = m_base.memory_types[MEMORY_TYPE_DL1];
+	m_dl0_memory.init(m_base.device, dl0_type, DEVICE_MEMORY_BLOCK_SIZE, ALIGNMENT, props.limits.maxMemoryAllocationCount,
+		memory_props.memoryHeaps[memory_props.memoryTypes[dl0_type].heapIndex].size, &m_vk_alloc, &m_host_memory);
+	m_dl1_memory.init(m_base.device, dl1_type, DEVICE_MEMORY_BLOCK_SIZE, ALIGNMENT, props.limits.maxMemoryAllocationCount,
+		memory_props.memoryHeaps[memory_props.memoryTypes[dl1_type].heapIndex].size, &m_vk_alloc, &m_host_memory);
+
+	memory_registry::add("resource_manager", "host_memory", &m_host_memory);
+	memory_registry::add("resource_manager", "resource_pool", &m_resource_pool);
+	memory_registry::add("resource_manager", "vk_mappable_memory", &m_vk_mappable_memory);
+	memory_registry::add("resource_manager", "mappable_memory", &m_mappable_memory);
+	memory_registry::add("resource_manager", "dl0_memory", &m_dl0_memory);
+	memory_registry::add("resource_manager", "dl1_memory", &m_dl1_memory);
+
+	constexpr size_t QUEUE_CAPACITY = 1024;
+	m_build_queue.init(&m_host_memory, QUEUE_CAPACITY);
+	m_destroy_queue.init(&m_host_memory, QUEUE_CAPACITY);
+
+	//the build thread uses m_host_memory, the lists of the other threads are kept elsewhere
+	m_claimed_builds.init(&OS_MEMORY);
+	m_pending_destroys.init(&OS_MEMORY);
+	m_deferred_destroys.init(&OS_MEMORY);
+	m_freed_dl0_offsets.init(&OS_MEMORY);
+	m_freed_dl1_offsets.init(&OS_MEMORY);
+	m_relocations.init(&OS_MEMORY);
+	m_relocation_destroys.init(&OS_MEMORY);
+	m_defragment_candidates.init(&OS_MEMORY);
 }
\ No newline at end of file
@@ -0,0 +1,420 @@
+#include "resource_manager.h"
+
+#include "const_defragmentation_candidate_count.h"
+
+#include <algorithm>
+
+using namespace rcq;
+
+//creates the new buffer at new_offset and records the copy
+VkBuffer resource_manager::relocate_buffer(VkBuffer buffer, VkDeviceSize size, VkBufferUsageFlags usage,
+	block_device_memory& memory, VkDeviceSize new_offset)
+{
+	VkBufferCreateInfo b = {};
+	b.sType = VK_STRUCTURE_TYPE_BUFFER_CREATE_INFO;
+	b.sharingMode = VK_SHARING_MODE_EXCLUSIVE;
+	b.size = size;
+	b.usage = usage;
+
+	VkBuffer new_buffer;
+	assert(vkCreateBuffer(m_base.device, &b, m_vk_alloc, &new_buffer) == VK_SUCCESS);
+	vkBindBufferMemory(m_base.device, new_buffer, memory.handle(new_offset),
+		block_device_memory::memory_offset(new_offset));
+
+	VkBufferCopy region = {};
+	region.size = size;
+	vkCmdCopyBuffer(m_defragment_cb, buffer, new_buffer, 1, &region);
+
+	return new_buffer;
+}
+
+//creates the new image at new_tex.offset, records the copy of every mip level and creates the view
+void resource_manager::relocate_image(const resource<RES_TYPE_MAT_OPAQUE>::texture& tex, block_device_memory& memory,
+	resource<RES_TYPE_MAT_OPAQUE>::texture& new_tex)
+{
+	//new_tex is a copy of tex, only its offset differs
+	create_texture_image(new_tex);
+	assert(vkBindImageMemory(m_base.device, new_tex.image, memory.handle(new_tex.offset),
+		block_device_memory::memory_offset(new_tex.offset)) == VK_SUCCESS);
+
+	//transition the old image to transfer src and the new one to transfer dst optimal
+	VkImageMemoryBarrier barriers[2] = {};
+	for (uint32_t i = 0; i < 2; ++i)
+	{
+		barriers[i].sType = VK_STRUCTURE_TYPE_IMAGE_MEMORY_BARRIER;
+		barriers[i].srcAccessMask = 0;
+		barriers[i].dstAccessMask = i == 0 ? VK_ACCESS_TRANSFER_READ_BIT : VK_ACCESS_TRANSFER_WRITE_BIT;
+		barriers[i].srcQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
+		barriers[i].dstQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
+		barriers[i].image = i == 0 ? tex.image : new_tex.image;
+		barriers[i].oldLayout = i == 0 ? VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL : VK_IMAGE_LAYOUT_UNDEFINED;
+		barriers[i].newLayout = i == 0 ? VK_IMAGE_LAYOUT_TRANSFER_SRC_OPTIMAL : VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL;
+		barriers[i].subresourceRange.aspectMask = VK_IMAGE_ASPECT_COLOR_BIT;
+		barriers[i].subresourceRange.baseArrayLayer = 0;
+		barriers[i].subresourceRange.layerCount = 1;
+		barriers[i].subresourceRange.baseMipLevel = 0;
+		barriers[i].subresourceRange.levelCount = tex.mip_level_count;
+	}
+	vkCmdPipelineBarrier(m_defragment_cb, VK_PIPELINE_STAGE_TOP_OF_PIPE_BIT, VK_PIPELINE_STAGE_TRANSFER_BIT, 0,
+		0, nullptr, 0, nullptr, 2, barriers);
+
+	//copy the mip levels
+	VkImageCopy regions[32] = {};
+	assert(tex.mip_level_count <= 32);
+	for (uint32_t i = 0; i < tex.mip_level_count; ++i)
+	{
+		regions[i].srcSubresource.aspectMask = VK_IMAGE_ASPECT_COLOR_BIT;
+		regions[i].srcSubresource.baseArrayLayer = 0;
+		regions[i].srcSubresource.layerCount = 1;
+		regions[i].srcSubresource.mipLevel = i;
+		regions[i].dstSubresource = regions[i].srcSubresource;
+		regions[i].extent.width = std::max(tex.width >> i, 1u);
+		regions[i].extent.height = std::max(tex.height >> i, 1u);
+		regions[i].extent.depth = 1;
+	}
+	vkCmdCopyImage(m_defragment_cb, tex.image, VK_IMAGE_LAYOUT_TRANSFER_SRC_OPTIMAL, new_tex.image,
+		VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL, tex.mip_level_count, regions);
+
+	//transition the new image to shader read only optimal, the old one is destroyed
+	barriers[1].srcAccessMask = VK_ACCESS_TRANSFER_WRITE_BIT;
+	barriers[1].dstAccessMask = VK_ACCESS_SHADER_READ_BIT;
+	barriers[1].oldLayout = VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL;
+	barriers[1].newLayout = VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL;
+	vkCmdPipelineBarrier(m_defragment_cb, VK_PIPELINE_STAGE_TRANSFER_BIT, VK_PIPELINE_STAGE_FRAGMENT_SHADER_BIT, 0,
+		0, nullptr, 0, nullptr, 1, &barriers[1]);
+
+	create_texture_view(new_tex);
+}
+
+//the new ranges of a resource are allocated before anything is recorded, if one does not fit the others are given back
+bool resource_manager::allocate_relocation(block_device_memory** memories, const VkMemoryRequirements* mrs,
+	const VkDeviceSize* offsets, uint32_t count, const void* owner, VkDeviceSize* new_offsets)
+{
+	for (uint32_t i = 0; i < count; ++i)
+	{
+		new_offsets[i] = memories[i]->allocate_below(mrs[i].size, mrs[i].alignment, offsets[i], owner);
+		if (new_offsets[i] == offsets[i])
+		{
+			while (i-- != 0)
+				memories[i]->deallocate(new_offsets[i]);
+			return false;
+		}
+	}
+	return true;
+}
+
+template<>
+bool resource_manager::relocate<RES_TYPE_MESH>(base_resource* res, base_resource* old, VkDeviceSize byte_budget,
+	VkDeviceSize& moved_size)
+{
+	auto& mesh = *reinterpret_cast<resource<RES_TYPE_MESH>*>(res->data);
+
+	VkDeviceSize size = mesh.vb_size + mesh.ib_size + mesh.veb_size;
+	if (moved_size + size > byte_budget)
+		return false;
+
+	//a buffer created with the same create info has the same memory requirements
+	block_device_memory* memories[3] = { &m_dl0_memory, &m_dl0_memory, &m_dl0_memory };
+	VkMemoryRequirements mrs[3];
+	VkDeviceSize offsets[3] = { mesh.vb_offset, mesh.ib_offset, mesh.veb_offset };
+	VkDeviceSize new_offsets[3];
+	uint32_t count = mesh.veb == VK_NULL_HANDLE ? 2 : 3;
+	vkGetBufferMemoryRequirements(m_base.device, mesh.vb, &mrs[0]);
+	vkGetBufferMemoryRequirements(m_base.device, mesh.ib, &mrs[1]);
+	if (mesh.veb != VK_NULL_HANDLE)
+		vkGetBufferMemoryRequirements(m_base.device, mesh.veb, &mrs[2]);
+	if (!allocate_relocation(memories, mrs, offsets, count, res, new_offsets))
+		return false;
+
+	const VkBufferUsageFlags vertex_usage = VK_BUFFER_USAGE_VERTEX_BUFFER_BIT | VK_BUFFER_USAGE_TRANSFER_DST_BIT |
+		VK_BUFFER_USAGE_TRANSFER_SRC_BIT;
+	const VkBufferUsageFlags index_usage = VK_BUFFER_USAGE_INDEX_BUFFER_BIT | VK_BUFFER_USAGE_TRANSFER_DST_BIT |
+		VK_BUFFER_USAGE_TRANSFER_SRC_BIT;
+
+	resource<RES_TYPE_MESH> moved = mesh;
+	moved.vb_offset = new_offsets[0];
+	moved.vb = relocate_buffer(mesh.vb, mesh.vb_size, vertex_usage, m_dl0_memory, moved.vb_offset);
+	moved.ib_offset = new_offsets[1];
+	moved.ib = relocate_buffer(mesh.ib, mesh.ib_size, index_usage, m_dl0_memory, moved.ib_offset);
+	if (mesh.veb != VK_NULL_HANDLE)
+	{
+		moved.veb_offset = new_offsets[2];
+		moved.veb = relocate_buffer(mesh.veb, mesh.veb_size, vertex_usage, m_dl0_memory, moved.veb_offset);
+	}
+
+	*reinterpret_cast<resource<RES_TYPE_MESH>*>(old->data) = mesh;
+	mesh = moved;
+	moved_size += size;
+	return true;
+}
+
+template<>
+bool resource_manager::relocate<RES_TYPE_TR>(base_resource* res, base_resource* old, VkDeviceSize byte_budget,
+	VkDeviceSize& moved_size)
+{
+	auto& tr = *reinterpret_cast<resource<RES_TYPE_TR>*>(res->data);
+
+	VkDeviceSize size = sizeof(resource<RES_TYPE_TR>::data);
+	if (moved_size + size > byte_budget)
+		return false;
+
+	block_device_memory* memory = &m_dl0_memory;
+	VkMemoryRequirements mr;
+	vkGetBufferMemoryRequirements(m_base.device, tr.data_buffer, &mr);
+	VkDeviceSize new_offset;
+	if (!allocate_relocation(&memory, &mr, &tr.data_offset, 1, res, &new_offset))
+		return false;
+
+	resource<RES_TYPE_TR> moved = tr;
+	moved.data_offset = new_offset;
+	moved.data_buffer = relocate_buffer(tr.data_buffer, size, VK_BUFFER_USAGE_UNIFORM_BUFFER_BIT |
+		VK_BUFFER_USAGE_TRANSFER_DST_BIT | VK_BUFFER_USAGE_TRANSFER_SRC_BIT, m_dl0_memory, moved.data_offset);
+
+	//allocate descriptor set
+	{
+		VkDescriptorSetAllocateInfo alloc_info = {};
+		alloc_info.sType = VK_STRUCTURE_TYPE_DESCRIPTOR_SET_ALLOCATE_INFO;
+		alloc_info.descriptorSetCount = 1;
+		alloc_info.pSetLayouts = &m_dsls[DSL_TYPE_TR];
+		alloc_info.descriptorPool = m_dp_pools[DSL_TYPE_TR].use_dp(moved.dp_index);
+
+		assert(vkAllocateDescriptorSets(m_base.device, &alloc_info, &moved.ds) == VK_SUCCESS);
+	}
+
+	//update descriptor set
+	VkDescriptorBufferInfo buffer_info;
+	buffer_info.buffer = moved.data_buffer;
+	buffer_info.offset = 0;
+	buffer_info.range = size;
+
+	VkWriteDescriptorSet write = {};
+	write.sType = VK_STRUCTURE_TYPE_WRITE_DESCRIPTOR_SET;
+	write.descriptorCount = 1;
+	write.descriptorType = VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER;
+	write.dstArrayElement = 0;
+	write.dstBinding = 0;
+	write.dstSet = moved.ds;
+	write.pBufferInfo = &buffer_info;
+
+	vkUpdateDescriptorSets(m_base.device, 1, &write, 0, nullptr);
+
+	*reinterpret_cast<resource<RES_TYPE_TR>*>(old->data) = tr;
+	tr = moved;
+	moved_size += size;
+	return true;
+}
+
+template<>
+bool resource_manager::relocate<RES_TYPE_MAT_OPAQUE>(base_resource* res, base_resource* old, VkDeviceSize byte_budget,
+	VkDeviceSize& moved_size)
+{
+	auto& mat = *reinterpret_cast<resource<RES_TYPE_MAT_OPAQUE>*>(res->data);
+
+	//the textures first, the data buffer is the last range
+	block_device_memory* memories[TEX_TYPE_COUNT + 1];
+	VkMemoryRequirements mrs[TEX_TYPE_COUNT + 1];
+	VkDeviceSize offsets[TEX_TYPE_COUNT + 1];
+	VkDeviceSize new_offsets[TEX_TYPE_COUNT + 1];
+	uint32_t count = 0;
+	VkDeviceSize size = 0;
+	for (auto& tex : mat.texs)
+	{
+		if (tex.image != VK_NULL_HANDLE)
+		{
+			memories[count] = &m_dl1_memory;
+			vkGetImageMemoryRequirements(m_base.device, tex.image, &mrs[count]);
+			offsets[count] = tex.offset;
+			size += mrs[count++].size;
+		}
+	}
+	memories[count] = &m_dl0_memory;
+	vkGetBufferMemoryRequirements(m_base.device, mat.data_buffer, &mrs[count]);
+	offsets[count] = mat.data_offset;
+	size += sizeof(resource<RES_TYPE_MAT_OPAQUE>::data);
+
+	if (moved_size + size > byte_budget || !allocate_relocation(memories, mrs, offsets, count + 1, res, new_offsets))
+		return false;
+
+	resource<RES_TYPE_MAT_OPAQUE> moved = mat;
+	uint32_t range_index = 0;
+	for (uint32_t i = 0; i < TEX_TYPE_COUNT; ++i)
+	{
+		if (mat.texs[i].image != VK_NULL_HANDLE)
+		{
+			moved.texs[i].offset = new_offsets[range_index++];
+			relocate_image(mat.texs[i], m_dl1_memory, moved.texs[i]);
+		}
+	}
+	moved.data_offset = new_offsets[range_index];
+	moved.data_buffer = relocate_buffer(mat.data_buffer, sizeof(resource<RES_TYPE_MAT_OPAQUE>::data),
+		VK_BUFFER_USAGE_UNIFORM_BUFFER_BIT | VK_BUFFER_USAGE_TRANSFER_DST_BIT | VK_BUFFER_USAGE_TRANSFER_SRC_BIT,
+		m_dl0_memory, moved.data_offset);
+
+	//allocate descriptor set
+	{
+		VkDescriptorSetAllocateInfo alloc_info = {};
+		alloc_info.sType = VK_STRUCTURE_TYPE_DESCRIPTOR_SET_ALLOCATE_INFO;
+		alloc_info.descriptorSetCount = 1;
+		alloc_info.pSetLayouts = &m_dsls[DSL_TYPE_MAT_OPAQUE];
+		alloc_info.descriptorPool = m_dp_pools[DSL_TYPE_MAT_OPAQUE].use_dp(moved.dp_index);
+
+		assert(vkAllocateDescriptorSets(m_base.device, &alloc_info, &moved.ds) == VK_SUCCESS);
+	}
+
+	//update descriptor set
+	{
+		VkDescriptorBufferInfo buffer_info = {};
+		buffer_info.buffer = moved.data_buffer;
+		buffer_info.offset = 0;
+		buffer_info.range = sizeof(resource<RES_TYPE_MAT_OPAQUE>::data);
+
+		VkDescriptorImageInfo tex_info[TEX_TYPE_COUNT];
+		VkWriteDescriptorSet write[TEX_TYPE_COUNT + 1] = {};
+
+		write[0].sType = VK_STRUCTURE_TYPE_WRITE_DESCRIPTOR_SET;
+		write[0].descriptorCount = 1;
+		write[0].descriptorType = VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER;
+		write[0].dstArrayElement = 0;
+		write[0].dstBinding = 0;
+		write[0].dstSet = moved.ds;
+		write[0].pBufferInfo = &buffer_info;
+
+		uint32_t write_index = 1;
+		for (uint32_t i = 0; i < TEX_TYPE_COUNT; ++i)
+		{
+			if (moved.texs[i].image != VK_NULL_HANDLE)
+			{
+				tex_info[write_index - 1].imageLayout = VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL;
+				tex_info[write_index - 1].imageView = moved.texs[i].view;
+				tex_info[write_index - 1].sampler = moved.texs[i].sampler;
+
+				write[write_index].sType = VK_STRUCTURE_TYPE_WRITE_DESCRIPTOR_SET;
+				write[write_index].descriptorCount = 1;
+				write[write_index].descriptorType = VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER;
+				write[write_index].dstArrayElement = 0;
+				write[write_index].dstBinding = i + 1;
+				write[write_index].dstSet = moved.ds;
+				write[write_index].pImageInfo = &tex_info[write_index - 1];
+
+				++write_index;
+			}
+		}
+
+		vkUpdateDescriptorSets(m_base.device, write_index, write, 0, nullptr);
+	}
+
+	//the samplers are kept by the moved resource
+	auto& old_mat = *reinterpret_cast<resource<RES_TYPE_MAT_OPAQUE>*>(old->data);
+	old_mat = mat;
+	for (auto& tex : old_mat.texs)
+		tex.sampler = VK_NULL_HANDLE;
+	mat = moved;
+	moved_size += size;
+	return true;
+}
+
+const vector<resource_manager::relocation>& resource_manager::defragment(VkDeviceSize byte_budget)
+{
+	RCQ_TRACE_SCOPE("resource_manager::defragment");
+	assert(m_relocations.empty());
+
+	//a running build keeps the memories, the defragmentation is tried again next frame
+	std::unique_lock<std::mutex> lock(m_memory_mutex, std::try_to_lock);
+	if (!lock.owns_lock())
+		return m_relocations;
+
+	//the copies of the last call are finished, they were submitted before the frame whose render finished fence the engine waited for
+	if (m_defragment_submitted)
+	{
+		assert(vkWaitForFences(m_base.device, 1, &m_defragment_f, VK_TRUE, ~0) == VK_SUCCESS);
+		vkResetFences(m_base.device, 1, &m_defragment_f);
+		m_defragment_submitted = false;
+	}
+
+	VkCommandBufferBeginInfo begin_info = {};
+	begin_info.sType = VK_STRUCTURE_TYPE_COMMAND_BUFFER_BEGIN_INFO;
+	begin_info.flags = VK_COMMAND_BUFFER_USAGE_ONE_TIME_SUBMIT_BIT;
+	assert(vkBeginCommandBuffer(m_defragment_cb, &begin_info) == VK_SUCCESS);
+
+	VkDeviceSize moved_size = 0;
+	defragment_memory(m_dl1_memory, byte_budget, moved_size);
+	defragment_memory(m_dl0_memory, byte_budget, moved_size);
+
+	//the buffer copies are made visible to every later command of the render queue, the images have their own barriers
+	VkMemoryBarrier barrier = {};
+	barrier.sType = VK_STRUCTURE_TYPE_MEMORY_BARRIER;
+	barrier.srcAccessMask = VK_ACCESS_TRANSFER_WRITE_BIT;
+	barrier.dstAccessMask = VK_ACCESS_MEMORY_READ_BIT | VK_ACCESS_MEMORY_WRITE_BIT;
+	vkCmdPipelineBarrier(m_defragment_cb, VK_PIPELINE_STAGE_TRANSFER_BIT, VK_PIPELINE_STAGE_ALL_COMMANDS_BIT, 0,
+		1, &barrier, 0, nullptr, 0, nullptr);
+
+	assert(vkEndCommandBuffer(m_defragment_cb) == VK_SUCCESS);
+	if (m_relocations.empty())
+		return m_relocations;
+
+	//submitted to the render queue ahead of the next frame, which is ordered after the copies by the barriers,
+	//so nothing waits for them here. the next frame uses the moved resources, the old ones are destroyed after it
+	VkSubmitInfo submit = {};
+	submit.sType = VK_STRUCTURE_TYPE_SUBMIT_INFO;
+	submit.commandBufferCount = 1;
+	submit.pCommandBuffers = &m_defragment_cb;
+
+	{
+		std::lock_guard<std::mutex> queue_lock(*m_base.queue_mutexes[QUEUE_RENDER]);
+		assert(vkQueueSubmit(m_base.queues[QUEUE_RENDER], 1, &submit, m_defragment_f) == VK_SUCCESS);
+	}
+	m_defragment_submitted = true;
+	m_defragment_frame = m_submitted_frame_count + 1;
+
+	return m_relocations;
+}
+
+//the resources at the top of the memory are moved first, so the free ranges are merged at the top and the top blocks get freed
+void resource_manager::defragment_memory(block_device_memory& memory, VkDeviceSize byte_budget, VkDeviceSize& moved_size)
+{
+	m_defragment_candidates.clear();
+	memory.for_each_owner_above_free([this](const void* owner)
+	{
+		auto res = const_cast<base_resource*>(reinterpret_cast<const base_resource*>(owner));
+		if (std::find(m_defragment_candidates.begin(), m_defragment_candidates.end(), res) == m_defragment_candidates.end())
+			*m_defragment_candidates.push_back() = res;
+		return m_defragment_candidates.size() < DEFRAGMENTATION_CANDIDATE_COUNT;
+	});
+
+	for (base_resource* res : m_defragment_candidates)
+	{
+		if (moved_size >= byte_budget)
+			return;
+
+		//a resource under build is not ready, a resource moved in this frame is skipped
+		if (res->pinned || !res->ready_bit.load() || std::find_if(m_relocations.begin(), m_relocations.end(),
+			[res](const relocation& r) { return r.res == res; }) != m_relocations.end())
+			continue;
+
+		base_resource* old = reinterpret_cast<base_resource*>(m_resource_pool.allocate(sizeof(base_resource), alignof(base_resource)));
+		old->res_type = res->res_type;
+		old->ready_bit = true;
+		old->pinned = false;
+
+		bool relocated = false;
+		switch (res->res_type)
+		{
+		case RES_TYPE_MAT_OPAQUE:
+			relocated = relocate<RES_TYPE_MAT_OPAQUE>(res, old, byte_budget, moved_size);
+			break;
+		case RES_TYPE_MESH:
+			relocated = relocate<RES_TYPE_MESH>(res, old, byte_budget, moved_size);
+			break;
+		case RES_TYPE_TR:
+			relocated = relocate<RES_TYPE_TR>(res, old, byte_budget, moved_size);
+			break;
+		default:
+			assert(false);
+		}
+
+		if (relocated)
+			*m_relocations.push_back() = { res, old };
+		else
+			m_resource_pool.deallocate(reinterpret_cast<size_t>(old));
+	}
+}
\ No newline at end of file
@@ -1,24 +1,47 @@
 #include "resource_manager.h"
 
+#include <algorithm>
+#include <limits>
+
 using namespace rcq;
 
 void resource_manager::destroy_loop()
 {
-	while (!m_should_end_destroy || !m_destroy_queue.empty())
+	RCQ_TRACE_THREAD_NAME("resource destroy");
+
+	destroy_request request;
+	uint64_t completed_frame_count = 0;
+	while (m_destroy_queue.pop_wait(request, m_should_end_destroy))
 	{
-		if (m_destroy_queue.empty())
-		{
-			std::unique_lock<std::mutex> lock(m_destroy_queue_mutex);
-			while (m_destroy_queue.empty() && !m_should_end_destroy)
-				m_destroy_queue_cv.wait(lock);
+		if (request.res != nullptr)
+			*m_deferred_destroys.push_back() = request;
+		else
+			completed_frame_count = request.frame;
 
-			if (m_should_end_destroy)
-				continue;
-		}
+		//while a build or the defragmentation holds the memories the requests wait for the next frame marker
+		std::unique_lock<std::mutex> lock(m_memory_mutex, std::try_to_lock);
+		if (lock.owns_lock())
+			retire_destroys(completed_frame_count);
+	}
+
+	//the engine is destroyed first, the device is idle
+	std::lock_guard<std::mutex> lock(m_memory_mutex);
+	retire_destroys(std::numeric_limits<uint64_t>::max());
+}
 
-		base_resource* base_res = *m_destroy_queue.front();
+void resource_manager::retire_destroys(uint64_t completed_frame_count)
+{
+	//a resource may have been moved after its destroy request was pushed, nothing is retired until its copy is finished
+	if (completed_frame_count < m_defragment_frame)
+		return;
 
-		while (!base_res->ready_bit.load());
+	//a resource still in the build queue waits for a later call, the build thread needs the lock to finish it
+	size_t retired_count = 0;
+	while (retired_count < m_deferred_destroys.size() && m_deferred_destroys[retired_count].frame <= completed_frame_count &&
+		m_deferred_destroys[retired_count].res->ready_bit.load())
+	{
+		RCQ_TRACE_SCOPE("resource_manager::destroy");
+		base_resource* base_res = m_deferred_destroys[retired_count++].res;
 
 		switch (base_res->res_type)
 		{
@@ -42,7 +65,29 @@ void resource_manager::destroy_loop()
 			break;
 		}
 		static_assert(6 == RES_TYPE_COUNT);
-
-		m_destroy_queue.pop();
 	}
+
+	if (retired_count == 0)
+		return;
+
+	std::copy(m_deferred_destroys.begin() + retired_count, m_deferred_destroys.end(), m_deferred_destroys.begin());
+	m_deferred_destroys.resize(m_deferred_destroys.size() - retired_count);
+	m_deferred_destroy_count.fetch_sub(retired_count);
+
+	free_device_memory();
+	m_memory_freed_cv.notify_all();
+}
+
+void resource_manager::free_device_memory()
+{
+	RCQ_TRACE_SCOPE("resource_manager::free_device_memory");
+
+	//sorted offsets are freed with one walk along the blocks, neighbouring ranges are coalesced on the way
+	std::sort(m_freed_dl0_offsets.begin(), m_freed_dl0_offsets.end());
+	m_dl0_memory.deallocate(m_freed_dl0_offsets.data(), m_freed_dl0_offsets.size());
+	m_freed_dl0_offsets.clear();
+
+	std::sort(m_freed_dl1_offsets.begin(), m_freed_dl1_offsets.end());
+	m_dl1_memory.deallocate(m_freed_dl1_offsets.data(), m_freed_dl1_offsets.size());
+	m_freed_dl1_offsets.clear();
 }
\ No newline at end of file
@@ -4,9 +4,12 @@
 #include "glm.h"
 
 #include "vector.h"
+#include "raw_file.h"
+#include "terrain_file.h"
 
 #include "enum_res_type.h"
 #include "enum_tex_type.h"
+#include "enum_water_grid_size.h"
 
 #include <atomic>
 
@@ -34,6 +37,9 @@ namespace rcq
 			VkImageView view;
 			VkSampler sampler;
 			VkDeviceSize offset;
+			uint32_t width;
+			uint32_t height;
+			uint32_t mip_level_count;
 		};
 
 		struct data
@@ -69,6 +75,9 @@ namespace rcq
 		VkDeviceSize vb_offset;
 		VkDeviceSize ib_offset;
 		VkDeviceSize veb_offset;
+		VkDeviceSize vb_size;
+		VkDeviceSize ib_size;
+		VkDeviceSize veb_size;
 		uint32_t size;
 	};
 
@@ -132,6 +141,8 @@ namespace rcq
 			glm::uvec2 level0_image_size;
 			glm::uvec2 level0_tile_size;
 			glm::vec3 size_in_meters;
+			uint64_t page_budget; //bytes of page memory, the least recently used tiles are evicted above it
+			uint64_t prefetch_budget; //bytes of page memory, tiles are prefetched only below it
 		};
 
 		struct data
@@ -156,7 +167,9 @@ namespace rcq
 			VkSampler sampler;
 			VkDeviceSize mip_tail_offset;
 			VkDeviceSize dummy_page_offset;
-			vector<std::ifstream> files;
+			glm::uvec2 page_size; //sparse block extent in texels
+			vector<raw_file> files;
+			vector<vector<terrain_file::tile_entry>> tile_entries; //mip level, tile_id.x+tile_id.y*tile_count.x
 		};
 
 		texture tex;
@@ -165,7 +178,10 @@ namespace rcq
 		uint32_t dp_index;
 		glm::uvec2 level0_tile_size;
 		glm::uvec2 tile_count;
+		glm::vec2 tile_size_in_meters;
 		uint32_t mip_level_count;
+		uint64_t page_budget;
+		uint64_t prefetch_budget;
 
 		VkBuffer data_buffer;
 		VkDeviceSize data_offset;
@@ -177,14 +193,13 @@ namespace rcq
 	template<>
 	struct resource<RES_TYPE_WATER>
 	{
-		static const uint32_t GRID_SIZE = 1024;
-
 		struct build_info
 		{
 			const char* filename;
 			glm::vec2 grid_size_in_meters;
 			float base_frequency;
 			float A;
+			uint32_t grid_size; //WATER_GRID_SIZE_256, WATER_GRID_SIZE_512 or WATER_GRID_SIZE_1024
 		};
 
 		struct fft_params_data
@@ -192,6 +207,8 @@ namespace rcq
 			glm::vec2 two_pi_per_L; //l=grid side length in meters
 			float sqrtA;
 			float base_frequency;
+			uint32_t grid_size;
+			uint32_t grid_size_log2;
 		};
 
 		struct texture
@@ -213,6 +230,7 @@ namespace rcq
 		VkDeviceSize fft_params_offset;
 
 		glm::vec2 grid_size_in_meters;
+		uint32_t grid_size;
 
 		uint32_t dp_index;
 	};
@@ -271,6 +289,7 @@ namespace rcq
 		char data[resource_details::max_resource_size];
 		uint32_t res_type;
 		std::atomic_bool ready_bit;
+		bool pinned; //a recorded command buffer keeps the handles, the defragmentation does not move it
 	};
 
 	struct alignas(resource_details::max_build_info_alignment) base_resource_build_info
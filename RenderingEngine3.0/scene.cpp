@@ -2,8 +2,13 @@
 
 #include "engine.h"
 
+#include <random>
+
 constexpr float PI = 3.1415927410125732421875f;
 
+//the center of the room
+static const glm::vec3 OFFSET = { 279.f, 5.f, 435.f };
+
 scene::scene(GLFWwindow* window, const glm::vec2& window_size) : m_window(window), m_window_size(window_size)
 {
 	build();
@@ -13,14 +18,18 @@ scene::scene(GLFWwindow* window, const glm::vec2& window_size) : m_window(window
 scene::~scene()
 {
 	rcq_user::destroy_sky();
-	rcq_user::destroy_terrain();
+	if (rcq_user::terrain_supported())
+		rcq_user::destroy_terrain();
 	rcq_user::destroy_water();
 
 	for (auto& handle : m_opaque_objects)
 		rcq_user::destroy_opaque_object(handle);
 
-	for (auto& handle : m_resources)
-		rcq_user::destroy_resource(handle);
+	for (size_t i = 0; i < m_resources.size(); ++i)
+	{
+		if (i != resource::terrain || rcq_user::terrain_supported())
+			rcq_user::destroy_resource(m_resources[i]);
+	}
 	rcq_user::dispatch_resource_destroys();
 }
 
@@ -146,14 +155,19 @@ void scene::build()
 	sky_build_info->sky_image_size = glm::uvec3(32);
 	sky_build_info->transmittance_image_size = glm::uvec2(512);
 
-	//terrain resource
-	rcq_user::build_info<rcq_user::resource::terrain>* terrain_build_info;
-	rcq_user::build_resource<rcq_user::resource::terrain>(&m_resources[resource::terrain], &terrain_build_info);
-	terrain_build_info->filename = "textures/terrain/t1";
-	terrain_build_info->level0_image_size = glm::uvec2(4096, 4096);
-	terrain_build_info->level0_tile_size = glm::uvec2(512, 512);
-	terrain_build_info->mip_level_count = 4;
-	terrain_build_info->size_in_meters = glm::vec3(512.f, 10.f, 512.f);
+	//terrain resource, it is skipped without sparse binding
+	if (rcq_user::terrain_supported())
+	{
+		rcq_user::build_info<rcq_user::resource::terrain>* terrain_build_info;
+		rcq_user::build_resource<rcq_user::resource::terrain>(&m_resources[resource::terrain], &terrain_build_info);
+		terrain_build_info->filename = "textures/terrain/t1";
+		terrain_build_info->level0_image_size = glm::uvec2(4096, 4096);
+		terrain_build_info->level0_tile_size = glm::uvec2(1024, 1024);
+		terrain_build_info->mip_level_count = 4;
+		terrain_build_info->size_in_meters = glm::vec3(512.f, 10.f, 512.f);
+		terrain_build_info->page_budget = 128 * 1024 * 1024;
+		terrain_build_info->prefetch_budget = 96 * 1024 * 1024;
+	}
 
 	//water res
 	m_wave_period = 10000.f;
@@ -163,10 +177,11 @@ void scene::build()
 	water_build_info->A = 1e-4f;
 	water_build_info->base_frequency = 2.f*PI / m_wave_period;
 	water_build_info->grid_size_in_meters = glm::vec2(1024.f*0.03f);
+	water_build_info->grid_size = rcq_user::water_grid_size::size_1024;
 
 	//create transforms
 	rcq_user::build_info<rcq_user::resource::transform>* tr_build_info;
-	glm::vec3 offset = { 279.f, 5.f, 435.f };
+	glm::vec3 offset = OFFSET;
 
 	//floor
 	rcq_user::build_resource<rcq_user::resource::transform>(&m_resources[resource::tr_floor], &tr_build_info);
@@ -226,14 +241,17 @@ void scene::build()
 	rcq_user::set_sky(m_resources[resource::sky]);
 
 	//terrain
-	rcq_user::resource_handle terrain_mats[4] =
+	if (rcq_user::terrain_supported())
 	{
-		m_resources[resource::mat_sand],
-		m_resources[resource::mat_rocksand],
-		m_resources[resource::mat_grass],
-		m_resources[resource::mat_rock]
-	};
-	rcq_user::set_terrain(m_resources[resource::terrain], terrain_mats);
+		rcq_user::resource_handle terrain_mats[4] =
+		{
+			m_resources[resource::mat_sand],
+			m_resources[resource::mat_rocksand],
+			m_resources[resource::mat_grass],
+			m_resources[resource::mat_rock]
+		};
+		rcq_user::set_terrain(m_resources[resource::terrain], terrain_mats);
+	}
 
 	//water
 	rcq_user::set_water(m_resources[resource::water]);	
@@ -267,8 +285,73 @@ void scene::update(float dt)
 	rcq_user::set_render_settings(m_render_settings);
 	rcq_user::render();
 
-	std::cout << "time: " << dt << '\n';
-	std::cout << "view pos: " << m_render_settings.pos.x << ' ' <<m_render_settings.pos.y << ' ' << m_render_settings.pos.z << '\n';
+	//only the interactive scene prints, the console output would be timed with the benchmark frames
+	if (m_window != nullptr)
+	{
+		std::cout << "time: " << dt << '\n';
+		std::cout << "view pos: " << m_render_settings.pos.x << ' ' <<m_render_settings.pos.y << ' ' << m_render_settings.pos.z << '\n';
+	}
+}
+
+void scene::set_camera(const glm::vec3& pos, const glm::vec3& look_dir)
+{
+	m_camera.pos = pos;
+	m_camera.look_dir = glm::normalize(look_dir);
+}
+
+void scene::set_light_dir(const glm::vec3& light_dir)
+{
+	m_render_settings.light_dir = glm::normalize(light_dir);
+}
+
+void scene::add_procedural_objects(uint32_t count, uint32_t seed)
+{
+	//spheres on a jittered grid in front of the room, they share the meshes and the materials of the scene
+	const uint32_t mats[] =
+	{
+		resource::mat_gold,
+		resource::mat_rusted_iron,
+		resource::mat_scuffed_aluminum,
+		resource::mat_bamboo_wood,
+		resource::mat_oak_floor
+	};
+	const float spacing = 1.5f;
+	uint32_t row_size = static_cast<uint32_t>(ceilf(sqrtf(static_cast<float>(count))));
+	glm::vec3 origin = OFFSET + glm::vec3(2.f, -0.75f, -0.5f*spacing*row_size);
+
+	std::mt19937 rng(seed);
+	std::uniform_real_distribution<float> jitter(-0.25f*spacing, 0.25f*spacing);
+	std::uniform_real_distribution<float> scale(0.1f, 0.3f);
+	std::uniform_int_distribution<uint32_t> mat(0, sizeof(mats) / sizeof(mats[0]) - 1);
+
+	size_t first_tr = m_resources.size();
+	m_resources.resize(first_tr + count);
+	std::vector<uint32_t> obj_mats(count);
+	rcq_user::build_info<rcq_user::resource::transform>* tr_build_info;
+	for (uint32_t i = 0; i < count; ++i)
+	{
+		glm::vec3 pos = origin + glm::vec3(spacing*(i / row_size) + jitter(rng), 0.f, spacing*(i % row_size) + jitter(rng));
+		rcq_user::build_resource<rcq_user::resource::transform>(&m_resources[first_tr + i], &tr_build_info);
+		tr_build_info->model = glm::translate(glm::mat4(1.f), pos);
+		tr_build_info->scale = glm::vec3(scale(rng));
+		tr_build_info->tex_scale = glm::vec2(1.f);
+		obj_mats[i] = mats[mat(rng)];
+	}
+	rcq_user::dispatch_resource_builds();
+
+	size_t first_obj = m_opaque_objects.size();
+	m_opaque_objects.resize(first_obj + count);
+	for (uint32_t i = 0; i < count; ++i)
+	{
+		rcq_user::add_opaque_object(m_resources[resource::mesh_sphere], m_resources[obj_mats[i]], m_resources[first_tr + i],
+			&m_opaque_objects[first_obj + i]);
+	}
+}
+
+//without a window (headless mode) the camera and the settings stay where they are
+static bool key_pressed(GLFWwindow* window, int key)
+{
+	return window != nullptr && glfwGetKey(window, key) == GLFW_PRESS;
 }
 
 void scene::update_settings(float dt)
@@ -277,26 +360,26 @@ void scene::update_settings(float dt)
 	float h_rot = 0.f;
 	float v_rot = 0.f;
 
-	if (glfwGetKey(m_window, GLFW_KEY_W))
+	if (key_pressed(m_window, GLFW_KEY_W))
 		move.x += 1.f;
-	if (glfwGetKey(m_window, GLFW_KEY_S))
+	if (key_pressed(m_window, GLFW_KEY_S))
 		move.x -= 1.f;
-	if (glfwGetKey(m_window, GLFW_KEY_A))
+	if (key_pressed(m_window, GLFW_KEY_A))
 		move.z -= 1.f;
-	if (glfwGetKey(m_window, GLFW_KEY_D))
+	if (key_pressed(m_window, GLFW_KEY_D))
 		move.z += 1.f;
-	if (glfwGetKey(m_window, GLFW_KEY_SPACE))
+	if (key_pressed(m_window, GLFW_KEY_SPACE))
 		move.y -= 1.f;
-	if (glfwGetKey(m_window, GLFW_KEY_C))
+	if (key_pressed(m_window, GLFW_KEY_C))
 		move.y += 1.f;
 
-	if (glfwGetKey(m_window, GLFW_KEY_UP))
+	if (key_pressed(m_window, GLFW_KEY_UP))
 		v_rot += 1.f;
-	if (glfwGetKey(m_window, GLFW_KEY_DOWN))
+	if (key_pressed(m_window, GLFW_KEY_DOWN))
 		v_rot -= 1.f;
-	if (glfwGetKey(m_window, GLFW_KEY_LEFT))
+	if (key_pressed(m_window, GLFW_KEY_LEFT))
 		h_rot -= 1.f;
-	if (glfwGetKey(m_window, GLFW_KEY_RIGHT))
+	if (key_pressed(m_window, GLFW_KEY_RIGHT))
 		h_rot += 1.f;
 
 	if (h_rot != 0.f)
@@ -314,7 +397,7 @@ void scene::update_settings(float dt)
 	{
 		move = glm::normalize(move);
 
-		if (glfwGetKey(m_window, GLFW_KEY_LEFT_SHIFT))
+		if (key_pressed(m_window, GLFW_KEY_LEFT_SHIFT))
 			move *= 20.f;
 
 		m_camera.pos += dt*glm::mat3(m_camera.look_dir, glm::vec3(0.f, -1.f, 0.f), glm::vec3(-m_camera.look_dir.z, 0.f, m_camera.look_dir.x))
@@ -334,13 +417,13 @@ void scene::update_settings(float dt)
 	float phi = 0.f;
 	float scale = 0.2f;
 
-	if (glfwGetKey(m_window, GLFW_KEY_I))
+	if (key_pressed(m_window, GLFW_KEY_I))
 		phi += 1.f;
-	if (glfwGetKey(m_window, GLFW_KEY_K))
+	if (key_pressed(m_window, GLFW_KEY_K))
 		phi -= 1.f;
-	if (glfwGetKey(m_window, GLFW_KEY_J))
+	if (key_pressed(m_window, GLFW_KEY_J))
 		theta += 1.f;
-	if (glfwGetKey(m_window, GLFW_KEY_L))
+	if (key_pressed(m_window, GLFW_KEY_L))
 		theta -= 1.f;
 
 	glm::mat4 rot = glm::rotate(scale*dt*theta, glm::vec3(0.f, 1.f, 0.f));
@@ -351,13 +434,13 @@ void scene::update_settings(float dt)
 	theta = 0.f;
 	float speed = 0.f;
 
-	if (glfwGetKey(m_window, GLFW_KEY_N))
+	if (key_pressed(m_window, GLFW_KEY_N))
 		speed += 5.f;
-	if (glfwGetKey(m_window, GLFW_KEY_M))
+	if (key_pressed(m_window, GLFW_KEY_M))
 		speed -= 5.f;
-	if (glfwGetKey(m_window, GLFW_KEY_V))
+	if (key_pressed(m_window, GLFW_KEY_V))
 		theta += 1.f;
-	if (glfwGetKey(m_window, GLFW_KEY_B))
+	if (key_pressed(m_window, GLFW_KEY_B))
 		theta -= 1.f;
 
 	m_render_settings.wind = (glm::length(m_render_settings.wind) + dt*speed)*glm::normalize(m_render_settings.wind);
@@ -13,6 +13,11 @@ public:
 	scene& operator=(scene&&) = delete;
 
 	void update(float dt);
+
+	//scripted control for the benchmarks, the keys move the camera and the light on top of it
+	void set_camera(const glm::vec3& pos, const glm::vec3& look_dir);
+	void set_light_dir(const glm::vec3& light_dir);
+	void add_procedural_objects(uint32_t count, uint32_t seed);
 private:
 
 	struct resource
@@ -0,0 +1,14 @@
+#pragma once
+
+#include <stdint.h>
+#include <stddef.h>
+
+namespace rcq
+{
+	//spir-v embedded by shaders/compile_all.bat, size is in bytes
+	struct shader_code
+	{
+		const uint32_t* code;
+		size_t size;
+	};
+}
\ No newline at end of file
@@ -1,3 +1,3 @@
 C:\VulkanSDK\1.0.65.1\Bin32\glslangValidator.exe
-C:\VulkanSDK\1.0.65.1\Bin32\glslangValidator.exe -V bloom.comp
-pause
\ No newline at end of file
+C:\VulkanSDK\1.0.65.1\Bin32\glslangValidator.exe -V --vn spirv_bloom_blur_comp -o comp.h bloom.comp
+if not "%1"=="-nopause" pause
\ No newline at end of file
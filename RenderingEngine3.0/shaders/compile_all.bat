@@ -0,0 +1,9 @@
+@echo off
+rem compiles every shader into a header with the spir-v as a uint32_t array, run as a pre-build step
+pushd %~dp0
+for /d /r %%d in (*) do if exist "%%d\compile.bat" (
+	pushd "%%d"
+	call compile.bat -nopause
+	popd
+)
+popd
\ No newline at end of file
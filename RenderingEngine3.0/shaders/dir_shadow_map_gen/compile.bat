@@ -1,4 +1,4 @@
 C:\VulkanSDK\1.0.61.1\Bin32\glslangValidator.exe
-C:\VulkanSDK\1.0.61.1\Bin32\glslangValidator.exe -V dir_shadow_map_gen.vert
-C:\VulkanSDK\1.0.61.1\Bin32\glslangValidator.exe -V dir_shadow_map_gen.geom
-pause
\ No newline at end of file
+C:\VulkanSDK\1.0.61.1\Bin32\glslangValidator.exe -V --vn spirv_dir_shadow_map_gen_vert -o vert.h dir_shadow_map_gen.vert
+C:\VulkanSDK\1.0.61.1\Bin32\glslangValidator.exe -V --vn spirv_dir_shadow_map_gen_geom -o geom.h dir_shadow_map_gen.geom
+if not "%1"=="-nopause" pause
\ No newline at end of file
@@ -1,5 +1,5 @@
 C:\VulkanSDK\1.0.61.1\Bin32\glslangValidator.exe
-C:\VulkanSDK\1.0.61.1\Bin32\glslangValidator.exe -V environment_map_gen_mat.vert
-C:\VulkanSDK\1.0.61.1\Bin32\glslangValidator.exe -V environment_map_gen_mat.geom
-C:\VulkanSDK\1.0.61.1\Bin32\glslangValidator.exe -V environment_map_gen_mat.frag
-pause
\ No newline at end of file
+C:\VulkanSDK\1.0.61.1\Bin32\glslangValidator.exe -V --vn spirv_environment_map_gen_mat_vert -o vert.h environment_map_gen_mat.vert
+C:\VulkanSDK\1.0.61.1\Bin32\glslangValidator.exe -V --vn spirv_environment_map_gen_mat_geom -o geom.h environment_map_gen_mat.geom
+C:\VulkanSDK\1.0.61.1\Bin32\glslangValidator.exe -V --vn spirv_environment_map_gen_mat_frag -o frag.h environment_map_gen_mat.frag
+if not "%1"=="-nopause" pause
\ No newline at end of file
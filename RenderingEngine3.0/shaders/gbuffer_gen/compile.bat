@@ -1,4 +1,4 @@
 C:\VulkanSDK\1.0.65.1\Bin32\glslangValidator.exe
-C:\VulkanSDK\1.0.65.1\Bin32\glslangValidator.exe -V gbuffer_gen.vert
-C:\VulkanSDK\1.0.65.1\Bin32\glslangValidator.exe -V gbuffer_gen.frag
-pause
\ No newline at end of file
+C:\VulkanSDK\1.0.65.1\Bin32\glslangValidator.exe -V --vn spirv_gbuffer_gen_vert -o vert.h gbuffer_gen.vert
+C:\VulkanSDK\1.0.65.1\Bin32\glslangValidator.exe -V --vn spirv_gbuffer_gen_frag -o frag.h gbuffer_gen.frag
+if not "%1"=="-nopause" pause
\ No newline at end of file
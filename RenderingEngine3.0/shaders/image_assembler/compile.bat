@@ -1,4 +1,4 @@
 C:\VulkanSDK\1.0.65.1\Bin32\glslangValidator.exe
-C:\VulkanSDK\1.0.65.1\Bin32\glslangValidator.exe -V image_assembler.vert
-C:\VulkanSDK\1.0.65.1\Bin32\glslangValidator.exe -V image_assembler.frag
-pause
\ No newline at end of file
+C:\VulkanSDK\1.0.65.1\Bin32\glslangValidator.exe -V --vn spirv_image_assembler_vert -o vert.h image_assembler.vert
+C:\VulkanSDK\1.0.65.1\Bin32\glslangValidator.exe -V --vn spirv_image_assembler_frag -o frag.h image_assembler.frag
+if not "%1"=="-nopause" pause
\ No newline at end of file
@@ -1,4 +1,4 @@
 C:\VulkanSDK\1.0.65.1\Bin32\glslangValidator.exe
-C:\VulkanSDK\1.0.65.1\Bin32\glslangValidator.exe -V postprocessing.vert
-C:\VulkanSDK\1.0.65.1\Bin32\glslangValidator.exe -V postprocessing.frag
-pause
\ No newline at end of file
+C:\VulkanSDK\1.0.65.1\Bin32\glslangValidator.exe -V --vn spirv_postprocessing_vert -o vert.h postprocessing.vert
+C:\VulkanSDK\1.0.65.1\Bin32\glslangValidator.exe -V --vn spirv_postprocessing_frag -o frag.h postprocessing.frag
+if not "%1"=="-nopause" pause
\ No newline at end of file
@@ -1,5 +1,5 @@
 C:\VulkanSDK\1.0.65.1\Bin32\glslangValidator.exe
-C:\VulkanSDK\1.0.65.1\Bin32\glslangValidator.exe -V sky.vert
-C:\VulkanSDK\1.0.65.1\Bin32\glslangValidator.exe -V sky.geom
-C:\VulkanSDK\1.0.65.1\Bin32\glslangValidator.exe -V sky.frag
-pause
\ No newline at end of file
+C:\VulkanSDK\1.0.65.1\Bin32\glslangValidator.exe -V --vn spirv_sky_vert -o vert.h sky.vert
+C:\VulkanSDK\1.0.65.1\Bin32\glslangValidator.exe -V --vn spirv_sky_geom -o geom.h sky.geom
+C:\VulkanSDK\1.0.65.1\Bin32\glslangValidator.exe -V --vn spirv_sky_frag -o frag.h sky.frag
+if not "%1"=="-nopause" pause
\ No newline at end of file
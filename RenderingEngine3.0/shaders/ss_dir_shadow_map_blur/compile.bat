@@ -1,4 +1,4 @@
 C:\VulkanSDK\1.0.61.1\Bin32\glslangValidator.exe
-C:\VulkanSDK\1.0.61.1\Bin32\glslangValidator.exe -V ss_dir_shadow_map_blur.vert
-C:\VulkanSDK\1.0.61.1\Bin32\glslangValidator.exe -V ss_dir_shadow_map_blur.frag
-pause
\ No newline at end of file
+C:\VulkanSDK\1.0.61.1\Bin32\glslangValidator.exe -V --vn spirv_ss_dir_shadow_map_blur_vert -o vert.h ss_dir_shadow_map_blur.vert
+C:\VulkanSDK\1.0.61.1\Bin32\glslangValidator.exe -V --vn spirv_ss_dir_shadow_map_blur_frag -o frag.h ss_dir_shadow_map_blur.frag
+if not "%1"=="-nopause" pause
\ No newline at end of file
@@ -1,4 +1,4 @@
 C:\VulkanSDK\1.0.61.1\Bin32\glslangValidator.exe
-C:\VulkanSDK\1.0.61.1\Bin32\glslangValidator.exe -V ssao_blur.vert
-C:\VulkanSDK\1.0.61.1\Bin32\glslangValidator.exe -V ssao_blur.frag
-pause
\ No newline at end of file
+C:\VulkanSDK\1.0.61.1\Bin32\glslangValidator.exe -V --vn spirv_ssao_blur_vert -o vert.h ssao_blur.vert
+C:\VulkanSDK\1.0.61.1\Bin32\glslangValidator.exe -V --vn spirv_ssao_blur_frag -o frag.h ssao_blur.frag
+if not "%1"=="-nopause" pause
\ No newline at end of file
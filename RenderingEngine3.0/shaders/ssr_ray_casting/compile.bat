@@ -1,5 +1,5 @@
 C:\VulkanSDK\1.0.61.1\Bin32\glslangValidator.exe
-C:\VulkanSDK\1.0.61.1\Bin32\glslangValidator.exe -V ssr_ray_casting.vert
-C:\VulkanSDK\1.0.61.1\Bin32\glslangValidator.exe -V ssr_ray_casting.geom
-C:\VulkanSDK\1.0.61.1\Bin32\glslangValidator.exe -V ssr_ray_casting.frag
-pause
\ No newline at end of file
+C:\VulkanSDK\1.0.61.1\Bin32\glslangValidator.exe -V --vn spirv_ssr_ray_casting_vert -o vert.h ssr_ray_casting.vert
+C:\VulkanSDK\1.0.61.1\Bin32\glslangValidator.exe -V --vn spirv_ssr_ray_casting_geom -o geom.h ssr_ray_casting.geom
+C:\VulkanSDK\1.0.61.1\Bin32\glslangValidator.exe -V --vn spirv_ssr_ray_casting_frag -o frag.h ssr_ray_casting.frag
+if not "%1"=="-nopause" pause
\ No newline at end of file
@@ -1,4 +1,4 @@
 C:\VulkanSDK\1.0.61.1\Bin32\glslangValidator.exe
-C:\VulkanSDK\1.0.61.1\Bin32\glslangValidator.exe -V sun.vert
-C:\VulkanSDK\1.0.61.1\Bin32\glslangValidator.exe -V sun.frag
-pause
\ No newline at end of file
+C:\VulkanSDK\1.0.61.1\Bin32\glslangValidator.exe -V --vn spirv_sun_vert -o vert.h sun.vert
+C:\VulkanSDK\1.0.61.1\Bin32\glslangValidator.exe -V --vn spirv_sun_frag -o frag.h sun.frag
+if not "%1"=="-nopause" pause
\ No newline at end of file
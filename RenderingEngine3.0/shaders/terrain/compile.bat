@@ -1,6 +1,6 @@
 C:\VulkanSDK\1.0.65.1\Bin32\glslangValidator.exe
-C:\VulkanSDK\1.0.65.1\Bin32\glslangValidator.exe -V terrain.vert
-C:\VulkanSDK\1.0.65.1\Bin32\glslangValidator.exe -V terrain.tesc
-C:\VulkanSDK\1.0.65.1\Bin32\glslangValidator.exe -V terrain.tese
-C:\VulkanSDK\1.0.65.1\Bin32\glslangValidator.exe -V terrain.frag
-pause
\ No newline at end of file
+C:\VulkanSDK\1.0.65.1\Bin32\glslangValidator.exe -V --vn spirv_terrain_vert -o vert.h terrain.vert
+C:\VulkanSDK\1.0.65.1\Bin32\glslangValidator.exe -V --vn spirv_terrain_tesc -o tesc.h terrain.tesc
+C:\VulkanSDK\1.0.65.1\Bin32\glslangValidator.exe -V --vn spirv_terrain_tese -o tese.h terrain.tese
+C:\VulkanSDK\1.0.65.1\Bin32\glslangValidator.exe -V --vn spirv_terrain_frag -o frag.h terrain.frag
+if not "%1"=="-nopause" pause
\ No newline at end of file
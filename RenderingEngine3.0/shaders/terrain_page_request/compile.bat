@@ -1,3 +1,3 @@
 C:\VulkanSDK\1.0.65.1\Bin32\glslangValidator.exe
-C:\VulkanSDK\1.0.65.1\Bin32\glslangValidator.exe -V terrain_page_request.comp
-pause
\ No newline at end of file
+C:\VulkanSDK\1.0.65.1\Bin32\glslangValidator.exe -V --vn spirv_terrain_page_request_comp -o comp.h terrain_page_request.comp
+if not "%1"=="-nopause" pause
\ No newline at end of file
@@ -1,6 +1,6 @@
 C:\VulkanSDK\1.0.65.1\Bin32\glslangValidator.exe
-C:\VulkanSDK\1.0.65.1\Bin32\glslangValidator.exe -V water_drawer.vert
-C:\VulkanSDK\1.0.65.1\Bin32\glslangValidator.exe -V water_drawer.tesc
-C:\VulkanSDK\1.0.65.1\Bin32\glslangValidator.exe -V water_drawer.tese
-C:\VulkanSDK\1.0.65.1\Bin32\glslangValidator.exe -V water_drawer.frag
-pause
\ No newline at end of file
+C:\VulkanSDK\1.0.65.1\Bin32\glslangValidator.exe -V --vn spirv_water_drawer_vert -o vert.h water_drawer.vert
+C:\VulkanSDK\1.0.65.1\Bin32\glslangValidator.exe -V --vn spirv_water_drawer_tesc -o tesc.h water_drawer.tesc
+C:\VulkanSDK\1.0.65.1\Bin32\glslangValidator.exe -V --vn spirv_water_drawer_tese -o tese.h water_drawer.tese
+C:\VulkanSDK\1.0.65.1\Bin32\glslangValidator.exe -V --vn spirv_water_drawer_frag -o frag.h water_drawer.frag
+if not "%1"=="-nopause" pause
\ No newline at end of file
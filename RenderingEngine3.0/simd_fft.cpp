@@ -0,0 +1,232 @@
+#include "simd_fft.h"
+
+#include "os_memory.h"
+
+#include <utility>
+#include <assert.h>
+#include <math.h>
+#include <intrin.h>
+#include <immintrin.h>
+
+using namespace rcq;
+
+namespace
+{
+	struct sse
+	{
+		typedef __m128 type;
+		static constexpr uint32_t width = 4;
+
+		static type load(const float* p) { return _mm_load_ps(p); }
+		static void store(float* p, type a) { _mm_store_ps(p, a); }
+		static type set1(float f) { return _mm_set1_ps(f); }
+		static type add(type a, type b) { return _mm_add_ps(a, b); }
+		static type sub(type a, type b) { return _mm_sub_ps(a, b); }
+		static type mul(type a, type b) { return _mm_mul_ps(a, b); }
+		static type mul_add(type a, type b, type c) { return _mm_add_ps(_mm_mul_ps(a, b), c); }
+		static type mul_sub(type a, type b, type c) { return _mm_sub_ps(_mm_mul_ps(a, b), c); }
+	};
+
+	struct avx2
+	{
+		typedef __m256 type;
+		static constexpr uint32_t width = 8;
+
+		static type load(const float* p) { return _mm256_load_ps(p); }
+		static void store(float* p, type a) { _mm256_store_ps(p, a); }
+		static type set1(float f) { return _mm256_set1_ps(f); }
+		static type add(type a, type b) { return _mm256_add_ps(a, b); }
+		static type sub(type a, type b) { return _mm256_sub_ps(a, b); }
+		static type mul(type a, type b) { return _mm256_mul_ps(a, b); }
+		static type mul_add(type a, type b, type c) { return _mm256_fmadd_ps(a, b, c); }
+		static type mul_sub(type a, type b, type c) { return _mm256_fmsub_ps(a, b, c); }
+	};
+
+	bool is_avx2_supported()
+	{
+		int info[4];
+		__cpuid(info, 0);
+		if (info[0] < 7)
+			return false;
+
+		//avx, fma and the os saving the ymm registers
+		__cpuid(info, 1);
+		constexpr int fma_avx_osxsave = (1 << 12) | (1 << 27) | (1 << 28);
+		if ((info[2] & fma_avx_osxsave) != fma_avx_osxsave || (_xgetbv(0) & 6) != 6)
+			return false;
+
+		__cpuidex(info, 7, 0);
+		return (info[1] & (1 << 5)) != 0;
+	}
+
+	template<typename simd>
+	inline void complex_mult(typename simd::type w_re, typename simd::type w_im, typename simd::type a_re,
+		typename simd::type a_im, typename simd::type& re, typename simd::type& im)
+	{
+		re = simd::mul_sub(w_re, a_re, simd::mul(w_im, a_im));
+		im = simd::mul_add(w_re, a_im, simd::mul(w_im, a_re));
+	}
+}
+
+simd_fft::simd_fft(uint32_t size, bool allow_avx2) :
+	m_size(size)
+{
+	assert(size >= 2 && (size & (size - 1)) == 0);
+
+	m_size_log2 = 0;
+	while ((1u << m_size_log2) < m_size)
+		++m_size_log2;
+	m_stage_count = (m_size_log2 & 1) + (m_size_log2 >> 1);
+
+	m_twiddles_re = reinterpret_cast<float*>(OS_MEMORY.allocate(m_size * sizeof(float), alignof(float)));
+	m_twiddles_im = reinterpret_cast<float*>(OS_MEMORY.allocate(m_size * sizeof(float), alignof(float)));
+	for (uint32_t m = 0; m < m_size; ++m)
+	{
+		double angle = 2.0*3.14159265358979323846*m / m_size;
+		m_twiddles_re[m] = static_cast<float>(cos(angle));
+		m_twiddles_im[m] = static_cast<float>(sin(angle));
+	}
+
+	if (allow_avx2 && is_avx2_supported())
+	{
+		m_radix2_stage = radix2_stage<avx2>;
+		m_radix4_stage = radix4_stage<avx2>;
+	}
+	else
+	{
+		m_radix2_stage = radix2_stage<sse>;
+		m_radix4_stage = radix4_stage<sse>;
+	}
+}
+
+simd_fft::~simd_fft()
+{
+	OS_MEMORY.deallocate(reinterpret_cast<size_t>(m_twiddles_re));
+	OS_MEMORY.deallocate(reinterpret_cast<size_t>(m_twiddles_im));
+}
+
+float* const* simd_fft::transform_columns(float* const* src, float* const* tmp, uint32_t plane_count, uint32_t lane_begin,
+	uint32_t lane_end) const
+{
+	//a radix-2 stage for odd log2 sizes, radix-4 stages for the rest
+	uint32_t p = 1;
+	if ((m_size_log2 & 1) != 0)
+	{
+		m_radix2_stage(src, tmp, m_twiddles_re, m_twiddles_im, m_size, p, plane_count, lane_begin, lane_end);
+		std::swap(src, tmp);
+		p = 2;
+	}
+	for (; p < m_size; p <<= 2)
+	{
+		m_radix4_stage(src, tmp, m_twiddles_re, m_twiddles_im, m_size, p, plane_count, lane_begin, lane_end);
+		std::swap(src, tmp);
+	}
+	return src;
+}
+
+template<typename simd>
+void simd_fft::radix2_stage(const float* const* in, float* const* out, const float* twiddles_re,
+	const float* twiddles_im, uint32_t size, uint32_t p, uint32_t plane_count, uint32_t lane_begin, uint32_t lane_end)
+{
+	using v = typename simd::type;
+	uint32_t half_size = size >> 1;
+
+	for (uint32_t t = 0; t < half_size; ++t)
+	{
+		uint32_t k = t & (p - 1);
+		uint32_t m = k*(half_size / p);
+		v w_re = simd::set1(twiddles_re[m]);
+		v w_im = simd::set1(twiddles_im[m]);
+
+		size_t src0 = static_cast<size_t>(t)*size;
+		size_t src1 = static_cast<size_t>(t + half_size)*size;
+		size_t dst0 = static_cast<size_t>(((t - k) << 1) + k)*size;
+		size_t dst1 = dst0 + static_cast<size_t>(p)*size;
+
+		for (uint32_t plane = 0; plane < plane_count; plane += 2)
+		{
+			const float* in_re = in[plane];
+			const float* in_im = in[plane + 1];
+			float* out_re = out[plane];
+			float* out_im = out[plane + 1];
+
+			for (uint32_t lane = lane_begin; lane < lane_end; lane += simd::width)
+			{
+				v h0_re = simd::load(in_re + src0 + lane);
+				v h0_im = simd::load(in_im + src0 + lane);
+				v h1_re, h1_im;
+				complex_mult<simd>(w_re, w_im, simd::load(in_re + src1 + lane), simd::load(in_im + src1 + lane), h1_re, h1_im);
+
+				simd::store(out_re + dst0 + lane, simd::add(h0_re, h1_re));
+				simd::store(out_im + dst0 + lane, simd::add(h0_im, h1_im));
+				simd::store(out_re + dst1 + lane, simd::sub(h0_re, h1_re));
+				simd::store(out_im + dst1 + lane, simd::sub(h0_im, h1_im));
+			}
+		}
+	}
+}
+
+template<typename simd>
+void simd_fft::radix4_stage(const float* const* in, float* const* out, const float* twiddles_re,
+	const float* twiddles_im, uint32_t size, uint32_t p, uint32_t plane_count, uint32_t lane_begin, uint32_t lane_end)
+{
+	using v = typename simd::type;
+	uint32_t quarter_size = size >> 2;
+
+	for (uint32_t t = 0; t < quarter_size; ++t)
+	{
+		uint32_t k = t & (p - 1);
+		uint32_t m = k*(quarter_size / p);
+		v w1_re = simd::set1(twiddles_re[m]);
+		v w1_im = simd::set1(twiddles_im[m]);
+		v w2_re = simd::set1(twiddles_re[2 * m]);
+		v w2_im = simd::set1(twiddles_im[2 * m]);
+		v w3_re = simd::set1(twiddles_re[3 * m]);
+		v w3_im = simd::set1(twiddles_im[3 * m]);
+
+		size_t src[4];
+		size_t dst[4];
+		for (uint32_t r = 0; r < 4; ++r)
+		{
+			src[r] = static_cast<size_t>(t + r*quarter_size)*size;
+			dst[r] = static_cast<size_t>(((t - k) << 2) + k + r*p)*size;
+		}
+
+		for (uint32_t plane = 0; plane < plane_count; plane += 2)
+		{
+			const float* in_re = in[plane];
+			const float* in_im = in[plane + 1];
+			float* out_re = out[plane];
+			float* out_im = out[plane + 1];
+
+			for (uint32_t lane = lane_begin; lane < lane_end; lane += simd::width)
+			{
+				v h0_re = simd::load(in_re + src[0] + lane);
+				v h0_im = simd::load(in_im + src[0] + lane);
+				v h1_re, h1_im, h2_re, h2_im, h3_re, h3_im;
+				complex_mult<simd>(w1_re, w1_im, simd::load(in_re + src[1] + lane), simd::load(in_im + src[1] + lane), h1_re, h1_im);
+				complex_mult<simd>(w2_re, w2_im, simd::load(in_re + src[2] + lane), simd::load(in_im + src[2] + lane), h2_re, h2_im);
+				complex_mult<simd>(w3_re, w3_im, simd::load(in_re + src[3] + lane), simd::load(in_im + src[3] + lane), h3_re, h3_im);
+
+				v a0_re = simd::add(h0_re, h2_re);
+				v a0_im = simd::add(h0_im, h2_im);
+				v a1_re = simd::sub(h0_re, h2_re);
+				v a1_im = simd::sub(h0_im, h2_im);
+				v a2_re = simd::add(h1_re, h3_re);
+				v a2_im = simd::add(h1_im, h3_im);
+				//i*(h1-h3)
+				v a3_re = simd::sub(h3_im, h1_im);
+				v a3_im = simd::sub(h1_re, h3_re);
+
+				simd::store(out_re + dst[0] + lane, simd::add(a0_re, a2_re));
+				simd::store(out_im + dst[0] + lane, simd::add(a0_im, a2_im));
+				simd::store(out_re + dst[1] + lane, simd::add(a1_re, a3_re));
+				simd::store(out_im + dst[1] + lane, simd::add(a1_im, a3_im));
+				simd::store(out_re + dst[2] + lane, simd::sub(a0_re, a2_re));
+				simd::store(out_im + dst[2] + lane, simd::sub(a0_im, a2_im));
+				simd::store(out_re + dst[3] + lane, simd::sub(a1_re, a3_re));
+				simd::store(out_im + dst[3] + lane, simd::sub(a1_im, a3_im));
+			}
+		}
+	}
+}
\ No newline at end of file
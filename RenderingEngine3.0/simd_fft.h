@@ -0,0 +1,59 @@
+#pragma once
+
+#include <stdint.h>
+
+namespace rcq
+{
+	//inverse stockham fft over the columns of split complex planes, out[j] = sum in[n]*exp(2*pi*i*j*n/size), unscaled.
+	//element (lane, row) of a plane is at row*size+lane, lanes are neighbouring columns transformed together.
+	//planes come in re, im pairs and must be 32 byte aligned.
+	class simd_fft
+	{
+	public:
+		//the widest simd width, lane ranges must be multiples of it
+		static constexpr uint32_t LANE_STEP = 8;
+
+		//the avx2 kernels are used if the cpu has them, unless allow_avx2 is false
+		simd_fft(uint32_t size, bool allow_avx2 = true);
+		~simd_fft();
+		simd_fft(const simd_fft&) = delete;
+		simd_fft(simd_fft&&) = delete;
+		simd_fft& operator=(const simd_fft&) = delete;
+		simd_fft& operator=(simd_fft&&) = delete;
+
+		//the result is in src if the stage count is even, in tmp otherwise, the returned planes are the ones holding it
+		float* const* transform_columns(float* const* src, float* const* tmp, uint32_t plane_count, uint32_t lane_begin,
+			uint32_t lane_end) const;
+
+		uint32_t size() const
+		{
+			return m_size;
+		}
+		uint32_t stage_count() const
+		{
+			return m_stage_count;
+		}
+
+	private:
+		typedef void(*stage_fn)(const float* const* in, float* const* out, const float* twiddles_re,
+			const float* twiddles_im, uint32_t size, uint32_t p, uint32_t plane_count, uint32_t lane_begin, uint32_t lane_end);
+
+		template<typename simd>
+		static void radix2_stage(const float* const* in, float* const* out, const float* twiddles_re,
+			const float* twiddles_im, uint32_t size, uint32_t p, uint32_t plane_count, uint32_t lane_begin, uint32_t lane_end);
+		template<typename simd>
+		static void radix4_stage(const float* const* in, float* const* out, const float* twiddles_re,
+			const float* twiddles_im, uint32_t size, uint32_t p, uint32_t plane_count, uint32_t lane_begin, uint32_t lane_end);
+
+		uint32_t m_size;
+		uint32_t m_size_log2;
+		uint32_t m_stage_count;
+
+		//exp(2*pi*i*m/size), m in [0, size)
+		float* m_twiddles_re;
+		float* m_twiddles_im;
+
+		stage_fn m_radix2_stage;
+		stage_fn m_radix4_stage;
+	};
+}
\ No newline at end of file
@@ -93,7 +93,8 @@ namespace rcq
 			next->index = m_size;
 			++m_size;
 
-			return get_data(s.index);
+			//a reused slot points to the end of the data, not to its own index
+			return get_data(next->index);
 		}
 
 		bool destroy(slot s)
@@ -106,10 +107,13 @@ namespace rcq
 			++real_slot->generation;
 			--m_size;
 
+			//the last element is moved in place of the deleted one, its slot is found through the slot view
 			if (real_slot->index != m_size)
 			{
 				memcpy(deleted, get_data(m_size), sizeof(T));
-				get_slot(m_size)->index = real_slot->index;
+				slot* moved = *get_slot_view(m_size);
+				moved->index = real_slot->index;
+				*get_slot_view(real_slot->index) = moved;
 			}
 
 			real_slot->index = m_next_slot;
@@ -148,7 +152,7 @@ namespace rcq
 			while (remaining>0)
 			{
 				auto data = current_chunk->data;
-				uint32_t steps = remaining > m_chunk_size ? m_chunk_size : remaining;
+				uint32_t steps = remaining > chunk_size ? chunk_size : remaining;
 				remaining -= steps;
 				while (steps-- > 0)
 					f(*data++);
@@ -179,7 +183,7 @@ namespace rcq
 
 			constexpr size_t alignment = alignof(T) < alignof(slot) ?  alignof(slot) : alignof(T);
 
-			size_t new_chunk_pointer = m_memory->allocate(sizeof(T) + sizeof(slot*) + sizeof(slot)*chunk_size, alignment);
+			size_t new_chunk_pointer = m_memory->allocate((sizeof(T) + sizeof(slot*) + sizeof(slot))*chunk_size, alignment);
 
 			auto new_chunk = m_chunks.push_back();
 			new_chunk->data = reinterpret_cast<T*>(new_chunk_pointer);
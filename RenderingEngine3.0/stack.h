@@ -71,13 +71,15 @@ namespace rcq
 		{
 			while (m_top_node != nullptr)
 			{
+				node* next = m_top_node->next;
 				m_memory->deallocate(reinterpret_cast<size_t>(m_top_node));
-				m_top_node = m_top_node->next;
+				m_top_node = next;
 			}
 			while (m_first_available_node != nullptr)
 			{
+				node* next = m_first_available_node->next;
 				m_memory->deallocate(reinterpret_cast<size_t>(m_first_available_node));
-				m_first_available_node = m_first_available_node->next;
+				m_first_available_node = next;
 			}
 			m_size = 0;
 		}
@@ -0,0 +1,39 @@
+#pragma once
+
+#include "host_memory.h"
+
+#include <mutex>
+
+namespace rcq
+{
+	//serializes access to the upstream memory resource, so it can be shared between threads
+	class synchronized_host_memory : public host_memory
+	{
+	public:
+		synchronized_host_memory() {}
+
+		synchronized_host_memory(host_memory* upstream) :
+			host_memory(upstream->max_alignment(), upstream)
+		{}
+
+		void init(host_memory* upstream)
+		{
+			host_memory::init(upstream->max_alignment(), upstream);
+		}
+
+		size_t allocate(size_t size, size_t alignment) override
+		{
+			std::lock_guard<std::mutex> lock(m_mutex);
+			return m_upstream->allocate(size, alignment);
+		}
+
+		void deallocate(size_t p) override
+		{
+			std::lock_guard<std::mutex> lock(m_mutex);
+			m_upstream->deallocate(p);
+		}
+
+	private:
+		std::mutex m_mutex;
+	};
+}
\ No newline at end of file
@@ -0,0 +1,38 @@
+#pragma once
+
+#include "glm.h"
+
+#include <stdint.h>
+
+namespace rcq
+{
+	//tile-major terrain mip level file:
+	//header, index table with one entry per tile (tile_id.x+tile_id.y*tile_count.x), tile data
+	//every tile is stored contiguously, row-major inside the tile, starting at a TILE_ALIGNMENT aligned offset
+	struct terrain_file
+	{
+		static constexpr uint32_t MAGIC = 0x54514352; //"RCQT"
+		static constexpr uint32_t VERSION = 2;
+		static constexpr uint64_t TILE_ALIGNMENT = 4096;
+
+		//same layout in the file and in the R32_UINT terrain image:
+		//bits 0-15 height as unorm, bits 16-31 four 4 bit material weights, the gradient is computed in the shader
+		typedef uint32_t texel;
+
+		struct header
+		{
+			uint32_t magic;
+			uint32_t version;
+			glm::uvec2 tile_count;
+			glm::uvec2 tile_size; //in texels
+			uint32_t texel_size;
+			uint32_t padding;
+		};
+
+		struct tile_entry
+		{
+			uint64_t offset;
+			uint64_t size;
+		};
+	};
+}
\ No newline at end of file
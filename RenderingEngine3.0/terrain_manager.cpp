@@ -2,14 +2,17 @@
 
 #include "os_memory.h"
 #include "utility.h"
+#include "trace.h"
+#include "memory_registry.h"
 
 #include "const_max_alignment.h"
 #include "const_max_tile_count.h"
-
-#include <fstream>
+#include "const_terrain_fence_poll_interval.h"
 
 #include "enum_memory_type.h"
 
+#include <algorithm>
+
 
 using namespace rcq;
 
@@ -38,19 +41,21 @@ void terrain_manager::destroy()
 
 void terrain_manager::create_memory_resources_and_containers()
 {
-	constexpr VkDeviceSize PAGE_POOL_SIZE = 2048;
-
 	m_host_memory.init(64 * 1024 * 1024, MAX_ALIGNMENT, &OS_MEMORY);
 	m_vk_alloc.init(&m_host_memory);
 
-	m_vk_page_pool.init(m_base.device, MEMORY_TYPE_DL1, &m_vk_alloc);
-	m_page_pool.init(64 * 64 * sizeof(glm::vec4), 256, PAGE_POOL_SIZE, &m_vk_page_pool, &m_host_memory);
-	m_mappable_memory.init(m_base.device, MEMORY_TYPE_HVC, &m_vk_alloc);
+	m_vk_page_pool.init(m_base.device, m_base.memory_types[MEMORY_TYPE_DL1], &m_vk_alloc);
+	//the pool is one chunk of the page cap, it never grows
+	m_page_pool.init(m_page_size, m_page_size, m_max_page_count, &m_vk_page_pool, &m_host_memory);
+	m_mappable_memory.init(m_base.device, m_base.memory_types[MEMORY_TYPE_HVC], &m_vk_alloc);
 
-	m_request_queue.init(&m_host_memory);
-	m_request_queue.init_buffer();
-	m_result_queue.init(&m_host_memory);
-	m_result_queue.init_buffer();
+	memory_registry::add("terrain_manager", "host_memory", &m_host_memory);
+	memory_registry::add("terrain_manager", "vk_page_pool", &m_vk_page_pool);
+	memory_registry::add("terrain_manager", "page_pool", &m_page_pool);
+	memory_registry::add("terrain_manager", "mappable_memory", &m_mappable_memory);
+
+	constexpr size_t RESULT_QUEUE_CAPACITY = 1024;
+	m_result_queue.init(&m_host_memory, RESULT_QUEUE_CAPACITY);
 }
 
 void terrain_manager::create_cp_allocate_cb()
@@ -63,217 +68,722 @@ void terrain_manager::create_cp_allocate_cb()
 		cp.queueFamilyIndex = m_base.queue_family_index;
 		assert(vkCreateCommandPool(m_base.device, &cp, m_vk_alloc, &m_cp) == VK_SUCCESS);
 	}
-	//allocate cb
+	//allocate cbs
 	{
+		VkCommandBuffer cbs[TERRAIN_STREAMING_BATCH_COUNT];
+
 		VkCommandBufferAllocateInfo cb = {};
 		cb.sType = VK_STRUCTURE_TYPE_COMMAND_BUFFER_ALLOCATE_INFO;
-		cb.commandBufferCount = 1;
+		cb.commandBufferCount = TERRAIN_STREAMING_BATCH_COUNT;
 		cb.commandPool = m_cp;
 		cb.level = VK_COMMAND_BUFFER_LEVEL_PRIMARY;
-		assert(vkAllocateCommandBuffers(m_base.device, &cb, &m_cb) == VK_SUCCESS);
+		assert(vkAllocateCommandBuffers(m_base.device, &cb, cbs) == VK_SUCCESS);
+
+		for (uint32_t i = 0; i < TERRAIN_STREAMING_BATCH_COUNT; ++i)
+			m_batches[i].cb = cbs[i];
 	}
 }
 
 
-void terrain_manager::poll_requests()
+void terrain_manager::poll_requests(const render_settings& settings)
 {
-	//std::lock_guard<std::mutex> lock(m_request_queue_mutex);
-	for (uint32_t i = 0; i < m_request_data->request_count; ++i)
+	glm::vec2 view_pos = glm::vec2(settings.pos.x, settings.pos.z);
+	glm::vec2 predicted_view_pos = predict_view_pos(view_pos);
+
 	{
-		*m_request_queue.create_back() = m_request_data->requests[i];
+		std::lock_guard<std::mutex> lock(m_request_mutex);
+		glm::vec2 view_pos_in_tiles = view_pos / m_tile_size_in_meters;
+		if (view_pos_in_tiles != m_view_pos_in_tiles)
+		{
+			m_view_pos_in_tiles = view_pos_in_tiles;
+			m_request_heap_dirty = true;
+		}
+		update_residency(view_pos, settings.near, settings.far);
+
+		//the pages of the new loads are counted one by one, while they are fit under the cap
+		for (uint32_t i = 0; i < m_request_data->request_count; ++i)
+		{
+			uint32_t request = m_request_data->requests[i];
+			if (request >> 31)
+			{
+				uint32_t tile_index = (request & (MAX_TILE_COUNT - 1u)) +
+					((request >> MAX_TILE_COUNT_LOG2) & (MAX_TILE_COUNT - 1u))*m_tile_count.x;
+				m_requested_page_count -= level_page_count(static_cast<uint32_t>(m_requested_mip_levels[tile_index]));
+			}
+		}
+
+		for (uint32_t i = 0; i < m_request_data->request_count; ++i)
+		{
+			uint32_t request = m_request_data->requests[i];
+			uint32_t tile_index = (request & (MAX_TILE_COUNT - 1u)) +
+				((request >> MAX_TILE_COUNT_LOG2) & (MAX_TILE_COUNT - 1u))*m_tile_count.x;
+
+			if ((request >> 31) && !fit_under_page_cap(tile_index))
+			{
+				//the shader requests the level again later
+				m_requested_mip_levels[tile_index] += 1.f;
+				++m_stats.rejected_load_count;
+				continue;
+			}
+			add_request(tile_index, (request >> 31) ? -1 : 1, false);
+		}
+
+		//the request shader is not running now, the requested mip levels can be written
+		prefetch(view_pos, predicted_view_pos, settings.near, settings.far);
 	}
-	m_request_queue.commit();
+	m_request_cv.notify_one();
 	m_request_data->request_count = 0;
 }
-void terrain_manager::poll_results()
+
+terrain_residency_stats terrain_manager::get_residency_stats()
 {
-	//std::lock_guard<std::mutex> lock(m_result_queue_mutex);
-	while (!m_result_queue.empty())
+	m_stats.requested_page_count = static_cast<uint32_t>(m_requested_page_count);
+	m_stats.resident_page_count = m_resident_page_count;
+	return m_stats;
+}
+
+void terrain_manager::update_residency(const glm::vec2& view_pos, float near_plane, float far_plane)
+{
+	constexpr float TOLERANCE = 0.5f; //the tolerance of terrain_page_request.comp
+
+	uint32_t tile_count = m_tile_count.x*m_tile_count.y;
+	float mip_level_count = static_cast<float>(m_mip_level_count);
+
+	++m_poll_index;
+	m_requested_page_count = 0;
+	for (uint32_t i = 0; i < tile_count; ++i)
 	{
-		uint32_t result = *m_result_queue.front();
-		m_result_queue.pop();
+		float level = m_requested_mip_levels[i];
+		m_requested_page_count += m_page_counts_from_level[static_cast<uint32_t>(level)];
+
+		glm::vec2 tile_center = (glm::vec2(i % m_tile_count.x, i / m_tile_count.x) + glm::vec2(0.5f))*m_tile_size_in_meters;
+		float required_level = mip_level_count*(glm::distance(tile_center, view_pos) - near_plane) / (far_plane - near_plane);
+		if (required_level <= level + TOLERANCE)
+			m_last_use[i] = m_poll_index;
+	}
+}
 
-		glm::uvec2 tile_id =
+bool terrain_manager::fit_under_page_cap(uint32_t tile_index)
+{
+	uint64_t page_count = level_page_count(static_cast<uint32_t>(m_requested_mip_levels[tile_index]));
+	m_requested_page_count += page_count;
+	while (m_requested_page_count > m_max_page_count)
+	{
+		if (!evict_lru_tile(tile_index))
 		{
-			result & (MAX_TILE_COUNT - 1u),
-			(result >> MAX_TILE_COUNT_LOG2) & (MAX_TILE_COUNT - 1u)
-		};
+			m_requested_page_count -= page_count;
+			return false;
+		}
+	}
+	return true;
+}
 
-		if (result >> 31)
-			m_current_mip_levels[tile_id.x + tile_id.y*m_tile_count.x] -= 1.f;
-		else
-			m_current_mip_levels[tile_id.x + tile_id.y*m_tile_count.x] += 1.f;
+bool terrain_manager::evict_lru_tile(uint32_t except_tile_index)
+{
+	//tiles used in this poll are kept, the coarsest level is never freed, as in terrain_page_request.comp
+	uint32_t tile_count = m_tile_count.x*m_tile_count.y;
+	float max_level = static_cast<float>(m_mip_level_count) - 1.5f;
+	uint32_t lru = tile_count;
+	for (uint32_t i = 0; i < tile_count; ++i)
+	{
+		if (i == except_tile_index || m_last_use[i] == m_poll_index || m_requested_mip_levels[i] > max_level)
+			continue;
+		if (lru == tile_count || m_last_use[i] < m_last_use[lru])
+			lru = i;
 	}
+	if (lru == tile_count)
+		return false;
+
+	//the freed level reaches m_current_mip_levels through the results, as any other free
+	float level = m_requested_mip_levels[lru];
+	m_requested_page_count -= level_page_count(static_cast<uint32_t>(level));
+	m_requested_mip_levels[lru] = level + 1.f;
+	add_request(lru, 1, false);
+	++m_stats.evicted_level_count;
+	return true;
 }
 
-void terrain_manager::loop()
+void terrain_manager::add_request(uint32_t tile_index, int32_t level_change, bool prefetch)
+{
+	int32_t& change = m_pending_level_changes[tile_index];
+	int32_t old_change = change;
+	change += level_change;
+
+	//a tile requested by the gpu loses its low prefetch priority
+	m_prefetched[tile_index] = prefetch && (old_change == 0 || m_prefetched[tile_index]);
+
+	//m_pending_tiles has room for every tile, push_back never allocates here
+	if (old_change == 0)
+	{
+		m_pending_tile_positions[tile_index] = static_cast<uint32_t>(m_pending_tiles.size());
+		*m_pending_tiles.push_back() = tile_index;
+	}
+	else if (change == 0)
+		remove_pending_tile(tile_index);
+	m_request_heap_dirty = true;
+}
+
+glm::vec2 terrain_manager::predict_view_pos(const glm::vec2& view_pos)
 {
-	while (!m_should_end)
+	constexpr float LOOKAHEAD = 0.5f; //seconds
+
+	auto now = std::chrono::steady_clock::now();
+	if (m_view_tracked)
 	{
-		if (m_request_queue.empty()) continue;
-		uint32_t request;
+		float dt = std::chrono::duration<float>(now - m_last_poll_time).count();
+		if (dt > 0.f)
+			m_view_velocity = 0.5f*(m_view_velocity + (view_pos - m_last_view_pos) / dt);
+	}
+	m_view_tracked = true;
+	m_last_poll_time = now;
+	m_last_view_pos = view_pos;
+
+	return view_pos + m_view_velocity*LOOKAHEAD;
+}
+
+void terrain_manager::prefetch(const glm::vec2& view_pos, const glm::vec2& predicted_view_pos, float near_plane, float far_plane)
+{
+	//the tolerances of terrain_page_request.comp
+	constexpr float TOLERANCE = 0.5f;
+	constexpr float FREE_TOLERANCE = 1.5f;
+
+	uint32_t tile_count = m_tile_count.x*m_tile_count.y;
+	float mip_level_count = static_cast<float>(m_mip_level_count);
+
+	//prefetched pages are allocated only below the budget
+	for (uint32_t i = 0; i < tile_count; ++i)
+	{
+		glm::vec2 tile_center = (glm::vec2(i % m_tile_count.x, i / m_tile_count.x) + glm::vec2(0.5f))*m_tile_size_in_meters;
+		float required_level = mip_level_count*(glm::distance(tile_center, view_pos) - near_plane) / (far_plane - near_plane);
+		float predicted_level = mip_level_count*(glm::distance(tile_center, predicted_view_pos) - near_plane) /
+			(far_plane - near_plane);
+		float level = m_requested_mip_levels[i];
+
+		//the next level is requested before the shader would request it, but not so early that the shader frees it
+		if (level > predicted_level + TOLERANCE && level > 0.5f &&
+			level <= required_level + TOLERANCE && level - 1.f >= required_level - FREE_TOLERANCE)
 		{
-			//std::lock_guard<std::mutex> lock(m_request_queue_mutex);
-			request = *m_request_queue.front();
-			m_request_queue.pop();
+			uint64_t new_page_count = level_page_count(static_cast<uint32_t>(level) - 1u);
+			if (m_requested_page_count + new_page_count > m_prefetch_budget_in_pages)
+				continue;
+
+			m_requested_page_count += new_page_count;
+			m_requested_mip_levels[i] = level - 1.f;
+			add_request(i, -1, true);
+			++m_stats.prefetched_level_count;
 		}
+	}
+}
 
-		glm::uvec2 tile_id =
+void terrain_manager::poll_results()
+{
+	constexpr size_t MAX_RESULT_COUNT = 64;
+	uint32_t results[MAX_RESULT_COUNT];
+	size_t result_count;
+	while ((result_count = m_result_queue.try_pop(results, MAX_RESULT_COUNT)) != 0)
+	{
+		for (size_t i = 0; i < result_count; ++i)
 		{
-			request & (MAX_TILE_COUNT - 1u),
-			(request >> MAX_TILE_COUNT_LOG2) & (MAX_TILE_COUNT - 1u)
-		};
-		if (request >> 31)
+			uint32_t result = results[i];
+			glm::uvec2 tile_id =
+			{
+				result & (MAX_TILE_COUNT - 1u),
+				(result >> MAX_TILE_COUNT_LOG2) & (MAX_TILE_COUNT - 1u)
+			};
+
+			//the dropped load is requested again by the shader, as a rejected one
+			if (result & load_failed_bit)
+			{
+				m_requested_mip_levels[tile_id.x + tile_id.y*m_tile_count.x] += 1.f;
+				++m_stats.failed_load_count;
+			}
+			else if (result >> 31)
+				m_current_mip_levels[tile_id.x + tile_id.y*m_tile_count.x] -= 1.f;
+			else
+				m_current_mip_levels[tile_id.x + tile_id.y*m_tile_count.x] += 1.f;
+		}
+	}
+}
+
+void terrain_manager::loop()
+{
+	RCQ_TRACE_THREAD_NAME("terrain loader");
+
+	uint32_t request;
+	while (wait_for_request(request))
+	{
+		//the requests that are ready are gathered into one batch
+		do
+		{
+			process_request(request);
+		} while ((m_batches[m_next_batch].in_flight || m_batches[m_next_batch].slot_count < max_batch_slot_count) &&
+			try_pop_request(request));
+
+		submit_batch();
+	}
+}
+
+void terrain_manager::process_request(uint32_t request)
+{
+	RCQ_TRACE_SCOPE("terrain_manager::process_request");
+
+	glm::uvec2 tile_id =
+	{
+		request & (MAX_TILE_COUNT - 1u),
+		(request >> MAX_TILE_COUNT_LOG2) & (MAX_TILE_COUNT - 1u)
+	};
+
+	//requests of the same tile are applied in order
+	wait_for_tile(request);
+
+	if (request >> 31)
+	{
+		//a failed read leaves the tile as it was, the load is requested again a few times, then dropped and
+		//reported to the main thread
+		uint32_t tile_index = tile_id.x + tile_id.y*m_tile_count.x;
+		if (decrease_min_mip_level(tile_id, request))
+			m_failed_read_counts[tile_index] = 0;
+		else if (++m_failed_read_counts[tile_index] < TERRAIN_LOAD_RETRY_COUNT)
 		{
-			decrease_min_mip_level(tile_id);
+			std::lock_guard<std::mutex> lock(m_request_mutex);
+			add_request(tile_index, -1, false);
 		}
 		else
 		{
-			increase_min_mip_level(tile_id);
+			m_failed_read_counts[tile_index] = 0;
+			uint32_t result = request | load_failed_bit;
+			post_results(&result, 1);
 		}
+	}
+	else
+	{
+		increase_min_mip_level(tile_id);
+		m_failed_read_counts[tile_id.x + tile_id.y*m_tile_count.x] = 0;
 
-		*m_result_queue.create_back() = request;
-		m_result_queue.commit();
+		post_results(&request, 1);
 	}
+}
 
+bool terrain_manager::wait_for_request(uint32_t& request)
+{
+	while (true)
+	{
+		bool in_flight = false;
+		for (auto& batch : m_batches)
+			in_flight |= !retire_batch(batch, false);
+
+		std::unique_lock<std::mutex> lock(m_request_mutex);
+		if (m_should_end)
+			return false;
+		if (!m_pending_tiles.empty())
+		{
+			request = pop_request();
+			return true;
+		}
+
+		//nothing to retire, sleep until a request or the end arrives. otherwise the fences are polled,
+		//a new request is not left waiting for a copy to finish
+		auto ready = [this]()
+		{
+			return m_should_end || !m_pending_tiles.empty();
+		};
+		if (in_flight)
+			m_request_cv.wait_for(lock, TERRAIN_FENCE_POLL_INTERVAL, ready);
+		else
+			m_request_cv.wait(lock, ready);
+	}
 }
 
-void terrain_manager::decrease_min_mip_level(const glm::uvec2& tile_id)
+bool terrain_manager::try_pop_request(uint32_t& request)
 {
-	uint32_t new_mip_level = static_cast<uint32_t>(m_current_mip_levels[tile_id.x + tile_id.y*m_tile_count.x]) - 1u;
-	auto& file = m_terrain->tex.files[new_mip_level];
-	glm::uvec2 tile_size_in_pages = m_tile_size_in_pages;
-	for (uint32_t i = 0; i < new_mip_level; ++i)
-		tile_size_in_pages /= 2u;
-	glm::uvec2 page_size = { 64, 64 };
-	glm::uvec2 file_size = m_tile_count*tile_size_in_pages*page_size;
-	glm::uvec2 tile_offset2D_in_file = tile_id*tile_size_in_pages*page_size;
+	std::lock_guard<std::mutex> lock(m_request_mutex);
+	if (m_should_end || m_pending_tiles.empty())
+		return false;
 
-	auto& pages = m_pages[new_mip_level][tile_id.x][tile_id.y];
-	pages.resize(tile_size_in_pages.x*tile_size_in_pages.y);
+	request = pop_request();
+	return true;
+}
 
-	size_t tile_offset_in_bytes = (tile_offset2D_in_file.y*file_size.x + tile_offset2D_in_file.x) * sizeof(glm::vec4);
-	size_t page_index = 0;
+terrain_manager::request_priority terrain_manager::get_request_priority(uint32_t tile_index)
+{
+	request_priority p;
+	p.tile_index = tile_index;
+	if (m_pending_level_changes[tile_index] > 0)
+	{
+		p.rank = 0;
+		p.distance = 0.f;
+		return p;
+	}
 
-	char* pages_staging = m_pages_staging;
-	for (uint32_t i = 0; i < tile_size_in_pages.x; ++i)
+	uint32_t level = m_loaded_mip_levels[tile_index] - 1u;
+	p.rank = 1 + (m_prefetched[tile_index] != 0 ? m_mip_level_count : 0) + (m_mip_level_count - 1 - level);
+	glm::vec2 tile_center = glm::vec2(tile_index % m_tile_count.x, tile_index / m_tile_count.x) + glm::vec2(0.5f);
+	p.distance = glm::distance(tile_center, m_view_pos_in_tiles);
+	return p;
+}
+
+uint32_t terrain_manager::pop_request()
+{
+	//m_request_heap has room for every tile, push_back never allocates here
+	if (m_request_heap_dirty)
 	{
-		for (uint32_t j = 0; j < tile_size_in_pages.y; ++j)
-		{
-			pages[page_index] = m_page_pool.allocate(m_page_size, 1);
+		m_request_heap.clear();
+		for (uint32_t tile_index : m_pending_tiles)
+			*m_request_heap.push_back() = get_request_priority(tile_index);
+		std::make_heap(m_request_heap.begin(), m_request_heap.end(), is_lower_priority);
+		m_request_heap_dirty = false;
+	}
 
-			size_t page_offset_in_bytes = tile_offset_in_bytes
-				+ (file_size.x*page_size.y*j + i*page_size.x) * sizeof(glm::vec4);
+	//the loaded levels changed since the priority was pushed
+	request_priority top;
+	while (true)
+	{
+		std::pop_heap(m_request_heap.begin(), m_request_heap.end(), is_lower_priority);
+		top = *m_request_heap.last();
+		m_request_heap.resize(m_request_heap.size() - 1);
+
+		request_priority current = get_request_priority(top.tile_index);
+		if (current.rank == top.rank)
+			break;
+		*m_request_heap.push_back() = current;
+		std::push_heap(m_request_heap.begin(), m_request_heap.end(), is_lower_priority);
+	}
 
-			for (uint32_t k = 0; k < page_size.y; ++k)
-			{
-				size_t offset_in_bytes = page_offset_in_bytes + k*file_size.x * sizeof(glm::vec4);
-				file.seekg(offset_in_bytes);
-				file.read(pages_staging, page_size.x * sizeof(glm::vec4));
-				pages_staging += (page_size.x * sizeof(glm::vec4));
-			}
-			++page_index;
-		}
+	uint32_t tile_index = top.tile_index;
+	bool is_free = top.rank == 0;
+	int32_t& change = m_pending_level_changes[tile_index];
+	change += is_free ? -1 : 1;
+	if (change == 0)
+		remove_pending_tile(tile_index);
+	else
+	{
+		//pushed with the level before the request, it is corrected when it gets to the top
+		*m_request_heap.push_back() = top;
+		std::push_heap(m_request_heap.begin(), m_request_heap.end(), is_lower_priority);
 	}
 
-	//bind pages to virtual texture
-	uint32_t page_count = tile_size_in_pages.x*tile_size_in_pages.y;
-	vector<VkSparseImageMemoryBind> image_binds(&m_host_memory, page_count);
+	uint32_t request = (tile_index % m_tile_count.x) | ((tile_index / m_tile_count.x) << MAX_TILE_COUNT_LOG2);
+	return is_free ? request : request | (1u << 31);
+}
 
-	page_index = 0;
-	for (uint32_t i = 0; i < tile_size_in_pages.x; ++i)
+void terrain_manager::remove_pending_tile(uint32_t tile_index)
+{
+	uint32_t position = m_pending_tile_positions[tile_index];
+	uint32_t moved_tile_index = *m_pending_tiles.last();
+	m_pending_tiles[position] = moved_tile_index;
+	m_pending_tile_positions[moved_tile_index] = position;
+	m_pending_tiles.resize(m_pending_tiles.size() - 1);
+}
+
+terrain_manager::streaming_slot& terrain_manager::acquire_slot()
+{
+	//the batch is retired before it is gathered again, then a free slot is left for every load of it
+	auto& batch = m_batches[m_next_batch];
+	retire_batch(batch, true);
+
+	for (uint32_t i = 0; i < TERRAIN_STREAMING_SLOT_COUNT; ++i)
 	{
-		for (uint32_t j = 0; j < tile_size_in_pages.y; ++j)
+		if (m_slots[i].batch == TERRAIN_STREAMING_BATCH_COUNT)
 		{
-			auto& b = image_binds[page_index];
-			b.flags = 0;
-			b.extent = { page_size.x, page_size.y, 1 };
-			b.offset = {
-				static_cast<int32_t>(tile_offset2D_in_file.x + i*page_size.x),
-				static_cast<int32_t>(tile_offset2D_in_file.y + j*page_size.y),
-				0 };
-			b.memory = m_page_pool.handle();
-			b.memoryOffset = pages[page_index];
-			b.subresource.aspectMask = VK_IMAGE_ASPECT_COLOR_BIT;
-			b.subresource.arrayLayer = 0;
-			b.subresource.mipLevel = new_mip_level;
-
-			++page_index;
+			m_slots[i].batch = m_next_batch;
+			batch.slots[batch.slot_count++] = i;
+			return m_slots[i];
 		}
 	}
+	assert(false);
+	return m_slots[0];
+}
+
+void terrain_manager::submit_batch()
+{
+	auto& batch = m_batches[m_next_batch];
+	if (batch.in_flight || batch.slot_count == 0)
+		return;
+
+	RCQ_TRACE_SCOPE("terrain_manager::submit_batch");
 
+	//bind the pages of every tile at once
 	VkSparseImageMemoryBindInfo image_bind_info = {};
-	image_bind_info.bindCount = page_count;
+	image_bind_info.bindCount = static_cast<uint32_t>(m_image_binds.size());
 	image_bind_info.image = m_terrain->tex.image;
-	image_bind_info.pBinds = image_binds.data();
+	image_bind_info.pBinds = m_image_binds.data();
 
 	VkBindSparseInfo bind_info = {};
 	bind_info.sType = VK_STRUCTURE_TYPE_BIND_SPARSE_INFO;
 	bind_info.imageBindCount = 1;
 	bind_info.pImageBinds = &image_bind_info;
 	bind_info.signalSemaphoreCount = 1;
-	bind_info.pSignalSemaphores = &m_binding_finished_s;
+	bind_info.pSignalSemaphores = &batch.binding_finished_s;
 
-
-	vkQueueBindSparse(m_base.queues[QUEUE_TERRAIN_LOADER], 1, &bind_info, VK_NULL_HANDLE);
-
-
-	//copy from staging buffers
-	vector<VkBufferImageCopy> regions(&m_host_memory, page_count);
-	page_index = 0;
-	for (uint32_t i = 0; i < tile_size_in_pages.x; ++i)
 	{
-		for (uint32_t j = 0; j < tile_size_in_pages.y; ++j)
-		{
-			auto& r = regions[page_index];
-			r.bufferImageHeight = 0;
-			r.bufferRowLength = 0;
-			r.bufferOffset = page_index*m_page_size+m_pages_staging_offset;
-			r.imageOffset = {
-				static_cast<int32_t>(tile_offset2D_in_file.x + i*page_size.x),
-				static_cast<int32_t>(tile_offset2D_in_file.y + j*page_size.y),
-				0 };
-			r.imageExtent = { page_size.x, page_size.y, 1 };
-			r.imageSubresource.aspectMask = VK_IMAGE_ASPECT_COLOR_BIT;
-			r.imageSubresource.baseArrayLayer = 0;
-			r.imageSubresource.layerCount = 1;
-			r.imageSubresource.mipLevel = new_mip_level;
-
-			++page_index; 
-		}
+		std::lock_guard<std::mutex> lock(*m_base.queue_mutexes[QUEUE_TERRAIN_LOADER]);
+		assert(vkQueueBindSparse(m_base.queues[QUEUE_TERRAIN_LOADER], 1, &bind_info, VK_NULL_HANDLE) == VK_SUCCESS);
 	}
 
+	//copy every tile with one command
 	VkCommandBufferBeginInfo begin = {};
 	begin.sType = VK_STRUCTURE_TYPE_COMMAND_BUFFER_BEGIN_INFO;
 	begin.flags = VK_COMMAND_BUFFER_USAGE_ONE_TIME_SUBMIT_BIT;
-	assert(vkBeginCommandBuffer(m_cb, &begin) == VK_SUCCESS);
+	assert(vkBeginCommandBuffer(batch.cb, &begin) == VK_SUCCESS);
 
-	vkCmdCopyBufferToImage(m_cb, m_mapped_buffer, m_terrain->tex.image,
-		VK_IMAGE_LAYOUT_GENERAL, page_count, regions.data());
+	vkCmdCopyBufferToImage(batch.cb, m_mapped_buffer, m_terrain->tex.image,
+		VK_IMAGE_LAYOUT_GENERAL, batch.slot_count, m_copy_regions);
 
-	assert(vkEndCommandBuffer(m_cb) == VK_SUCCESS);
+	assert(vkEndCommandBuffer(batch.cb) == VK_SUCCESS);
 
 	VkSubmitInfo submit = {};
 	submit.sType = VK_STRUCTURE_TYPE_SUBMIT_INFO;
 	submit.commandBufferCount = 1;
-	submit.pCommandBuffers = &m_cb;
+	submit.pCommandBuffers = &batch.cb;
 	VkPipelineStageFlags wait_stage = VK_PIPELINE_STAGE_TRANSFER_BIT;
 	submit.waitSemaphoreCount = 1;
 	submit.pWaitDstStageMask = &wait_stage;
-	submit.pWaitSemaphores = &m_binding_finished_s;
-	assert(vkQueueSubmit(m_base.queues[QUEUE_TERRAIN_LOADER], 1, &submit, m_copy_finished_f) == VK_SUCCESS);
-	vkWaitForFences(m_base.device, 1, &m_copy_finished_f, VK_TRUE, std::numeric_limits<uint64_t>::max());
-	vkResetFences(m_base.device, 1, &m_copy_finished_f);
+	submit.pWaitSemaphores = &batch.binding_finished_s;
+	{
+		std::lock_guard<std::mutex> lock(*m_base.queue_mutexes[QUEUE_TERRAIN_LOADER]);
+		assert(vkQueueSubmit(m_base.queues[QUEUE_TERRAIN_LOADER], 1, &submit, batch.copy_finished_f) == VK_SUCCESS);
+	}
+
+	//the results are sent when the copy has finished, the loader moves on to the next batch
+	batch.in_flight = true;
+	m_image_binds.clear();
+	m_next_batch = (m_next_batch + 1) % TERRAIN_STREAMING_BATCH_COUNT;
+}
+
+bool terrain_manager::retire_batch(streaming_batch& batch, bool wait)
+{
+	if (!batch.in_flight)
+		return true;
+
+	if (wait)
+		vkWaitForFences(m_base.device, 1, &batch.copy_finished_f, VK_TRUE, std::numeric_limits<uint64_t>::max());
+	else if (vkGetFenceStatus(m_base.device, batch.copy_finished_f) != VK_SUCCESS)
+		return false;
+
+	vkResetFences(m_base.device, 1, &batch.copy_finished_f);
+	batch.in_flight = false;
+
+	uint32_t results[max_batch_slot_count];
+	for (uint32_t i = 0; i < batch.slot_count; ++i)
+	{
+		auto& slot = m_slots[batch.slots[i]];
+		results[i] = slot.request;
+		slot.batch = TERRAIN_STREAMING_BATCH_COUNT;
+	}
+	post_results(results, batch.slot_count);
+	batch.slot_count = 0;
+
+	return true;
+}
+
+void terrain_manager::post_results(const uint32_t* results, uint32_t count)
+{
+	//the main thread drains the queue every frame, it is full only for a moment
+	uint32_t posted_count = 0;
+	while (posted_count != count)
+	{
+		size_t n = m_result_queue.try_push(results + posted_count, count - posted_count);
+		if (n == 0)
+			std::this_thread::yield();
+		posted_count += static_cast<uint32_t>(n);
+	}
+}
+
+void terrain_manager::wait_for_tile(uint32_t request)
+{
+	//a tile of the gathered batch is submitted first
+	constexpr uint32_t tile_mask = ~(1u << 31);
+	for (auto& slot : m_slots)
+	{
+		if (slot.batch != TERRAIN_STREAMING_BATCH_COUNT && (slot.request & tile_mask) == (request & tile_mask))
+		{
+			auto& batch = m_batches[slot.batch];
+			if (!batch.in_flight)
+				submit_batch();
+			retire_batch(batch, true);
+		}
+	}
+}
+
+bool terrain_manager::read(const read_batch& batch)
+{
+	{
+		std::lock_guard<std::mutex> lock(m_io_mutex);
+		m_read_batch = batch;
+		m_finished_io_thread_count = 0;
+		m_read_failed = false;
+		++m_read_batch_index;
+	}
+	m_io_cv.notify_all();
+
+	bool succeeded = read_rows(batch, 0);
+
+	std::unique_lock<std::mutex> lock(m_io_mutex);
+	m_io_finished_cv.wait(lock, [this]()
+	{
+		return m_finished_io_thread_count == TERRAIN_IO_THREAD_COUNT - 1;
+	});
+	return succeeded && !m_read_failed;
+}
+
+bool terrain_manager::read_rows(const read_batch& batch, uint32_t thread_index)
+{
+	uint32_t row_begin = batch.row_count*thread_index / TERRAIN_IO_THREAD_COUNT;
+	uint32_t row_end = batch.row_count*(thread_index + 1) / TERRAIN_IO_THREAD_COUNT;
+	if (row_begin == row_end)
+		return true;
+
+	//contiguous rows are read at once
+	if (batch.stride == batch.row_size)
+	{
+		return batch.file->read(batch.dst + row_begin*batch.row_size, (row_end - row_begin)*batch.row_size,
+			batch.offset + row_begin*batch.stride);
+	}
+
+	for (uint32_t row = row_begin; row < row_end; ++row)
+	{
+		if (!batch.file->read(batch.dst + row*batch.row_size, batch.row_size, batch.offset + row*batch.stride))
+			return false;
+	}
+	return true;
+}
+
+void terrain_manager::io_loop(uint32_t thread_index)
+{
+	RCQ_TRACE_THREAD_NAME("terrain io");
+
+	uint32_t batch_index = 0;
+	while (true)
+	{
+		read_batch batch;
+		{
+			std::unique_lock<std::mutex> lock(m_io_mutex);
+			m_io_cv.wait(lock, [this, batch_index]()
+			{
+				return m_io_should_end || m_read_batch_index != batch_index;
+			});
+			if (m_io_should_end)
+				return;
+			batch = m_read_batch;
+			batch_index = m_read_batch_index;
+		}
+
+		bool succeeded = read_rows(batch, thread_index);
+
+		{
+			std::lock_guard<std::mutex> lock(m_io_mutex);
+			m_read_failed |= !succeeded;
+			++m_finished_io_thread_count;
+		}
+		m_io_finished_cv.notify_one();
+	}
+}
+
+bool terrain_manager::decrease_min_mip_level(const glm::uvec2& tile_id, uint32_t request)
+{
+	uint32_t tile_index = tile_id.x + tile_id.y*m_tile_count.x;
+	uint32_t new_mip_level = m_loaded_mip_levels[tile_index] - 1u;
+	m_loaded_mip_levels[tile_index] = new_mip_level;
+
+	auto& file = m_terrain->tex.files[new_mip_level];
+	glm::uvec2 tile_size_in_pages = m_tile_size_in_pages;
+	for (uint32_t i = 0; i < new_mip_level; ++i)
+		tile_size_in_pages /= 2u;
+	glm::uvec2 page_size = m_page_size_in_texels;
+	glm::uvec2 tile_size = tile_size_in_pages*page_size;
+	glm::uvec2 tile_offset_in_image = tile_id*tile_size;
+
+	auto& slot = acquire_slot();
+	uint32_t region_index = m_batches[m_next_batch].slot_count - 1;
+
+	//the tile is stored contiguously in the file, it is read straight into the staging area of the slot
+	{
+		const auto& entry = m_terrain->tex.tile_entries[new_mip_level][tile_index];
+		assert(entry.size == static_cast<uint64_t>(tile_size.x)*tile_size.y * sizeof(terrain_file::texel));
+
+		read_batch batch;
+		batch.file = &file;
+		batch.dst = slot.staging;
+		batch.offset = entry.offset;
+		batch.row_size = static_cast<uint64_t>(tile_size.x) * sizeof(terrain_file::texel);
+		batch.stride = batch.row_size;
+		batch.row_count = tile_size.y;
+
+		//the slot goes back to the batch and the level stays missing
+		if (!read(batch))
+		{
+			auto& gathered = m_batches[m_next_batch];
+			--gathered.slot_count;
+			slot.batch = TERRAIN_STREAMING_BATCH_COUNT;
+			m_loaded_mip_levels[tile_index] = new_mip_level + 1u;
+			return false;
+		}
+	}
+
+	auto& pages = m_pages[new_mip_level][tile_id.x][tile_id.y];
+	pages.resize(tile_size_in_pages.x*tile_size_in_pages.y);
+
+	//the page binds are gathered for the batch
+	uint32_t page_count = tile_size_in_pages.x*tile_size_in_pages.y;
+	size_t page_index = 0;
+	for (uint32_t i = 0; i < tile_size_in_pages.x; ++i)
+	{
+		for (uint32_t j = 0; j < tile_size_in_pages.y; ++j)
+		{
+			pages[page_index] = m_page_pool.allocate(m_page_size, 1);
+
+			auto& b = *m_image_binds.push_back();
+			b.flags = 0;
+			b.extent = { page_size.x, page_size.y, 1 };
+			b.offset = {
+				static_cast<int32_t>(tile_offset_in_image.x + i*page_size.x),
+				static_cast<int32_t>(tile_offset_in_image.y + j*page_size.y),
+				0 };
+			b.memory = m_page_pool.handle();
+			b.memoryOffset = pages[page_index];
+			b.subresource.aspectMask = VK_IMAGE_ASPECT_COLOR_BIT;
+			b.subresource.arrayLayer = 0;
+			b.subresource.mipLevel = new_mip_level;
+
+			++page_index;
+		}
+	}
+
+	m_resident_page_count += page_count;
+
+	//the whole tile is copied with one region
+	VkBufferImageCopy& region = m_copy_regions[region_index];
+	region = {};
+	region.bufferImageHeight = 0;
+	region.bufferRowLength = 0;
+	region.bufferOffset = slot.staging_offset;
+	region.imageOffset = {
+		static_cast<int32_t>(tile_offset_in_image.x),
+		static_cast<int32_t>(tile_offset_in_image.y),
+		0 };
+	region.imageExtent = { tile_size.x, tile_size.y, 1 };
+	region.imageSubresource.aspectMask = VK_IMAGE_ASPECT_COLOR_BIT;
+	region.imageSubresource.baseArrayLayer = 0;
+	region.imageSubresource.layerCount = 1;
+	region.imageSubresource.mipLevel = new_mip_level;
+
+	//the result is sent when the copy of the batch has finished
+	slot.request = request;
+	return true;
 }
 
 
 void terrain_manager::increase_min_mip_level(const glm::uvec2& tile_id)
 {
-	uint32_t destroy_mip_level = static_cast<uint32_t>(m_current_mip_levels[tile_id.x + tile_id.y*m_tile_count.x]);
+	uint32_t tile_index = tile_id.x + tile_id.y*m_tile_count.x;
+	uint32_t destroy_mip_level = m_loaded_mip_levels[tile_index];
+	m_loaded_mip_levels[tile_index] = destroy_mip_level + 1u;
+
 	auto& pages = m_pages[destroy_mip_level][tile_id.x][tile_id.y];
 
 	for (uint32_t i = 0; i < pages.size(); ++i)
 		m_page_pool.deallocate(pages[i]);
+	m_resident_page_count -= static_cast<uint32_t>(pages.size());
 
 	pages.clear();
 }
@@ -281,17 +791,24 @@ void terrain_manager::increase_min_mip_level(const glm::uvec2& tile_id)
 void terrain_manager::init_resources(const glm::uvec2& tile_count, const glm::uvec2& tile_size,
 	uint32_t mip_level_count, VkDescriptorSet request_ds, VkDescriptorSet draw_ds)
 {
+	m_page_size_in_texels = m_terrain->tex.page_size;
+	m_page_size = m_page_size_in_texels.x*m_page_size_in_texels.y * sizeof(terrain_file::texel);
+	m_max_page_count = m_terrain->page_budget / m_page_size;
+
 	create_memory_resources_and_containers();
 	create_cp_allocate_cb();
 
 	m_tile_count = tile_count;
 	m_tile_size = tile_size;
-	m_tile_size_in_pages = tile_size / 64u;
+	m_tile_size_in_meters = m_terrain->tile_size_in_meters;
+	m_mip_level_count = mip_level_count;
+	m_tile_size_in_pages = tile_size / m_page_size_in_texels;
 
-	uint64_t size = sizeof(request_data) + 2 * 4 * tile_count.x*tile_count.y+
-		m_tile_size_in_pages.x*m_tile_size_in_pages.y*64*64*sizeof(glm::vec4);
-
-	m_page_size = 64 * 64 * sizeof(glm::vec4);
+	//every streaming slot can hold a level 0 tile, the staging areas are texel aligned
+	uint64_t slot_staging_size = m_tile_size_in_pages.x*m_tile_size_in_pages.y*m_page_size;
+	uint64_t staging_offset = (sizeof(request_data) + 2 * 4 * tile_count.x*tile_count.y + sizeof(glm::vec4) - 1) /
+		sizeof(glm::vec4) * sizeof(glm::vec4);
+	uint64_t size = staging_offset + TERRAIN_STREAMING_SLOT_COUNT*slot_staging_size;
 
 	//create mapped buffer
 	VkDeviceSize request_buffer_offset;
@@ -320,8 +837,11 @@ void terrain_manager::init_resources(const glm::uvec2& tile_count, const glm::uv
 		m_request_data = reinterpret_cast<request_data*>(data);
 		m_requested_mip_levels = reinterpret_cast<float*>(data + sizeof(request_data));
 		m_current_mip_levels = reinterpret_cast<float*>(data + sizeof(request_data) + 4 * tile_count.x*tile_count.y);
-		m_pages_staging = data + sizeof(request_data) + 2 * 4 * tile_count.x*tile_count.y;
-		m_pages_staging_offset=m_mapped_offset+ sizeof(request_data) + 2 * 4 * tile_count.x*tile_count.y;
+		for (uint32_t i = 0; i < TERRAIN_STREAMING_SLOT_COUNT; ++i)
+		{
+			m_slots[i].staging_offset = staging_offset + i*slot_staging_size;
+			m_slots[i].staging = data + m_slots[i].staging_offset;
+		}
 		m_request_data->request_count = 0;
 		auto requested_mip_level = m_requested_mip_levels;
 		auto current_mip_level = m_current_mip_levels;
@@ -356,21 +876,72 @@ void terrain_manager::init_resources(const glm::uvec2& tile_count, const glm::uv
 		assert(vkCreateBufferView(m_base.device, &view, m_vk_alloc, &m_current_mip_levels_view) == VK_SUCCESS);
 	}
 
-	VkSemaphoreCreateInfo s = {};
-	s.sType = VK_STRUCTURE_TYPE_SEMAPHORE_CREATE_INFO;
-	assert(vkCreateSemaphore(m_base.device, &s, m_vk_alloc, &m_binding_finished_s) == VK_SUCCESS);
+	//create streaming batch sync objects
+	{
+		VkSemaphoreCreateInfo s = {};
+		s.sType = VK_STRUCTURE_TYPE_SEMAPHORE_CREATE_INFO;
+
+		VkFenceCreateInfo f = {};
+		f.sType = VK_STRUCTURE_TYPE_FENCE_CREATE_INFO;
 
-	VkFenceCreateInfo f = {};
-	f.sType = VK_STRUCTURE_TYPE_FENCE_CREATE_INFO;
-	assert(vkCreateFence(m_base.device, &f, m_vk_alloc, &m_copy_finished_f) == VK_SUCCESS);
+		for (auto& batch : m_batches)
+		{
+			assert(vkCreateSemaphore(m_base.device, &s, m_vk_alloc, &batch.binding_finished_s) == VK_SUCCESS);
+			assert(vkCreateFence(m_base.device, &f, m_vk_alloc, &batch.copy_finished_f) == VK_SUCCESS);
+			batch.slot_count = 0;
+			batch.in_flight = false;
+		}
+		for (auto& slot : m_slots)
+			slot.batch = TERRAIN_STREAMING_BATCH_COUNT;
+		m_next_batch = 0;
 
-	VkCommandBufferAllocateInfo alloc = {};
-	alloc.sType = VK_STRUCTURE_TYPE_COMMAND_BUFFER_ALLOCATE_INFO;
-	alloc.commandBufferCount = 1;
-	alloc.commandPool = m_cp;
-	alloc.level = VK_COMMAND_BUFFER_LEVEL_PRIMARY;
+		m_image_binds.init(&m_host_memory, max_batch_slot_count*m_tile_size_in_pages.x*m_tile_size_in_pages.y);
+		m_image_binds.clear();
+	}
 
-	assert(vkAllocateCommandBuffers(m_base.device, &alloc, &m_cb) == VK_SUCCESS);
+	m_loaded_mip_levels.init(&m_host_memory, tile_count.x*tile_count.y);
+	for (auto& l : m_loaded_mip_levels)
+		l = mip_level_count;
+
+	m_pending_level_changes.init(&m_host_memory, tile_count.x*tile_count.y);
+	for (auto& c : m_pending_level_changes)
+		c = 0;
+	m_pending_tiles.init(&m_host_memory, tile_count.x*tile_count.y);
+	m_pending_tiles.clear();
+	m_pending_tile_positions.init(&m_host_memory, tile_count.x*tile_count.y);
+	m_request_heap.init(&m_host_memory, tile_count.x*tile_count.y);
+	m_request_heap.clear();
+	m_request_heap_dirty = false;
+	m_prefetched.init(&m_host_memory, tile_count.x*tile_count.y);
+	for (auto& p : m_prefetched)
+		p = 0;
+	m_failed_read_counts.init(&m_host_memory, tile_count.x*tile_count.y);
+	for (auto& c : m_failed_read_counts)
+		c = 0;
+	m_view_pos_in_tiles = glm::vec2(0.f);
+
+	m_view_tracked = false;
+	m_view_velocity = glm::vec2(0.f);
+	m_page_counts_from_level.init(&m_host_memory, mip_level_count + 1);
+	m_page_counts_from_level[mip_level_count] = 0;
+	for (uint32_t i = mip_level_count; i > 0; --i)
+	{
+		glm::uvec2 tile_size_in_pages = m_tile_size_in_pages;
+		for (uint32_t j = 0; j < i - 1; ++j)
+			tile_size_in_pages /= 2u;
+		m_page_counts_from_level[i - 1] = m_page_counts_from_level[i] + tile_size_in_pages.x*tile_size_in_pages.y;
+	}
+	m_prefetch_budget_in_pages = std::min(m_terrain->prefetch_budget / m_page_size, m_max_page_count);
+
+	m_last_use.init(&m_host_memory, tile_count.x*tile_count.y);
+	for (auto& u : m_last_use)
+		u = 0;
+	m_poll_index = 0;
+	m_requested_page_count = 0;
+	m_resident_page_count = 0;
+	m_stats = {};
+	m_stats.page_size = m_page_size;
+	m_stats.page_cap = static_cast<uint32_t>(m_max_page_count);
 
 	m_pages.init(&m_host_memory, mip_level_count);
 	for (auto& v : m_pages)
@@ -419,6 +990,17 @@ void terrain_manager::init_resources(const glm::uvec2& tile_count, const glm::uv
 		vkUpdateDescriptorSets(m_base.device, 3, w, 0, nullptr);
 	}
 
+	m_io_should_end = false;
+	m_read_failed = false;
+	m_read_batch_index = 0;
+	for (uint32_t i = 0; i < TERRAIN_IO_THREAD_COUNT - 1; ++i)
+	{
+		m_io_threads[i] = std::thread([this, i]()
+		{
+			io_loop(i + 1);
+		});
+	}
+
 	m_should_end = false;
 	m_thread = std::thread([this]()
 	{
@@ -428,23 +1010,41 @@ void terrain_manager::init_resources(const glm::uvec2& tile_count, const glm::uv
 
 void terrain_manager::destroy_resources()
 {
-	m_should_end = true;
+	{
+		std::lock_guard<std::mutex> lock(m_request_mutex);
+		m_should_end = true;
+	}
+	m_request_cv.notify_one();
 	m_thread.join();
 
-	vkQueueWaitIdle(m_base.queues[QUEUE_TERRAIN_LOADER]);
+	{
+		std::lock_guard<std::mutex> lock(m_io_mutex);
+		m_io_should_end = true;
+	}
+	m_io_cv.notify_all();
+	for (auto& t : m_io_threads)
+		t.join();
+
+	{
+		std::lock_guard<std::mutex> lock(*m_base.queue_mutexes[QUEUE_TERRAIN_LOADER]);
+		vkQueueWaitIdle(m_base.queues[QUEUE_TERRAIN_LOADER]);
+	}
 
-	vkDestroyFence(m_base.device, m_copy_finished_f, m_vk_alloc);
-	vkDestroySemaphore(m_base.device, m_binding_finished_s, m_vk_alloc);
+	for (auto& batch : m_batches)
+	{
+		vkDestroyFence(m_base.device, batch.copy_finished_f, m_vk_alloc);
+		vkDestroySemaphore(m_base.device, batch.binding_finished_s, m_vk_alloc);
+	}
 	vkDestroyCommandPool(m_base.device, m_cp, m_vk_alloc);
 
 	vkDestroyBufferView(m_base.device, m_current_mip_levels_view, m_vk_alloc);
 	vkDestroyBufferView(m_base.device, m_requested_mip_levels_view, m_vk_alloc);
 	vkDestroyBuffer(m_base.device, m_mapped_buffer, m_vk_alloc);
 	
+	memory_registry::remove_owner("terrain_manager");
 	m_mappable_memory.deallocate(0);
 
 	m_result_queue.reset();
-	m_request_queue.reset();
 	m_page_pool.reset();
 	for(auto& u : m_pages)
 	{
@@ -459,5 +1059,15 @@ void terrain_manager::destroy_resources()
 		u.reset();
 	}
 	m_pages.reset();
+	m_loaded_mip_levels.reset();
+	m_image_binds.reset();
+	m_last_use.reset();
+	m_page_counts_from_level.reset();
+	m_prefetched.reset();
+	m_failed_read_counts.reset();
+	m_pending_tiles.reset();
+	m_pending_tile_positions.reset();
+	m_request_heap.reset();
+	m_pending_level_changes.reset();
 	m_host_memory.reset();
 }
\ No newline at end of file
@@ -5,13 +5,24 @@
 #include "freelist_host_memory.h"
 #include "pool_device_memory.h"
 
-#include "queue.h"
+#include "mpmc_queue.h"
 #include "vector.h"
 
 #include "resources.h"
 #include "base_info.h"
+#include "render_settings.h"
+#include "terrain_residency_stats.h"
+
+#include "const_terrain_io_thread_count.h"
+#include "const_terrain_streaming_slot_count.h"
+#include "const_terrain_streaming_batch_count.h"
+#include "const_terrain_load_retry_count.h"
 
 #include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <atomic>
+#include <chrono>
 
 namespace rcq
 {
@@ -19,8 +30,9 @@ namespace rcq
 	{
 	public:
 
-		void poll_requests();
+		void poll_requests(const render_settings& settings);
 		void poll_results();
+		terrain_residency_stats get_residency_stats();
 		static void init(const base_info& base);
 		static void destroy();
 
@@ -52,11 +64,83 @@ namespace rcq
 		void create_memory_resources_and_containers();
 		void create_cp_allocate_cb();
 
-		//request managing
+		//request managing, the pending tiles are popped from a heap by request_priority
+		struct request_priority
+		{
+			uint32_t rank; //frees first, then gpu requested loads, then prefetched ones, coarser levels first
+			float distance; //in tiles, the nearest tile wins among equal ranks
+			uint32_t tile_index;
+		};
+		static bool is_lower_priority(const request_priority& a, const request_priority& b)
+		{
+			return a.rank > b.rank || (a.rank == b.rank && a.distance > b.distance);
+		}
+		request_priority get_request_priority(uint32_t tile_index);
 		void loop();
-		void decrease_min_mip_level(const glm::uvec2& tile_id);
+		void process_request(uint32_t request);
+		bool wait_for_request(uint32_t& request);
+		bool try_pop_request(uint32_t& request);
+		uint32_t pop_request();
+		void add_request(uint32_t tile_index, int32_t level_change, bool prefetch);
+		//marks the result of a load dropped after TERRAIN_LOAD_RETRY_COUNT failed reads, bit 31 marks the loads
+		static const uint32_t load_failed_bit = 1u << 30;
+		void remove_pending_tile(uint32_t tile_index);
+
+		//residency
+		void update_residency(const glm::vec2& view_pos, float near_plane, float far_plane);
+		bool fit_under_page_cap(uint32_t tile_index);
+		bool evict_lru_tile(uint32_t except_tile_index);
+		uint64_t level_page_count(uint32_t mip_level)
+		{
+			return m_page_counts_from_level[mip_level] - m_page_counts_from_level[mip_level + 1];
+		}
+
+		//prefetching
+		glm::vec2 predict_view_pos(const glm::vec2& view_pos);
+		void prefetch(const glm::vec2& view_pos, const glm::vec2& predicted_view_pos, float near_plane, float far_plane);
+		bool decrease_min_mip_level(const glm::uvec2& tile_id, uint32_t request);
 		void increase_min_mip_level(const glm::uvec2& tile_id);
 
+		//a tile load owns a slot from the read until the copy of its batch finishes
+		struct streaming_slot
+		{
+			VkDeviceSize staging_offset;
+			char* staging;
+			uint32_t request;
+			uint32_t batch; //TERRAIN_STREAMING_BATCH_COUNT if the slot is free
+		};
+
+		//the loads of a polling window are bound with one vkQueueBindSparse and copied with one submit
+		struct streaming_batch
+		{
+			VkCommandBuffer cb;
+			VkSemaphore binding_finished_s;
+			VkFence copy_finished_f;
+			uint32_t slots[TERRAIN_STREAMING_SLOT_COUNT];
+			uint32_t slot_count;
+			bool in_flight;
+		};
+		static const uint32_t max_batch_slot_count = TERRAIN_STREAMING_SLOT_COUNT / TERRAIN_STREAMING_BATCH_COUNT;
+		streaming_slot& acquire_slot();
+		void submit_batch();
+		bool retire_batch(streaming_batch& batch, bool wait);
+		void post_results(const uint32_t* results, uint32_t count);
+		void wait_for_tile(uint32_t request);
+
+		//rows of a file region, read by all io threads together
+		struct read_batch
+		{
+			const raw_file* file;
+			char* dst;
+			uint64_t offset;
+			uint64_t stride;
+			uint64_t row_size;
+			uint32_t row_count;
+		};
+		bool read(const read_batch& batch);
+		bool read_rows(const read_batch& batch, uint32_t thread_index);
+		void io_loop(uint32_t thread_index);
+
 		struct request_data
 		{
 			static const uint32_t max_request_count = 256;
@@ -78,8 +162,6 @@ namespace rcq
 		float* m_requested_mip_levels;
 		VkBufferView m_current_mip_levels_view;
 		float* m_current_mip_levels;
-		VkDeviceSize m_pages_staging_offset;
-		char* m_pages_staging;
 
 		//memory resources
 		freelist_host_memory m_host_memory;
@@ -90,27 +172,74 @@ namespace rcq
 		vk_memory m_vk_page_pool;
 		pool_device_memory m_page_pool;
 		
+		//pending requests, opposite requests of a tile cancel each other out
+		std::mutex m_request_mutex;
+		std::condition_variable m_request_cv;
+		vector<int32_t> m_pending_level_changes; //>0: levels to free, <0: levels to load
+		vector<uint32_t> m_pending_tiles; //tiles with nonzero level change
+		vector<uint32_t> m_pending_tile_positions; //index of the tile in m_pending_tiles
+		vector<uint8_t> m_prefetched; //the pending loads of the tile come from the prefetcher only
+		vector<uint8_t> m_failed_read_counts; //failed reads of the next level of the tile in a row, only used by the loader
+		glm::vec2 m_view_pos_in_tiles;
+
+		//only the loader pops, it can only lower the priorities, a stale top is pushed back with its real priority.
+		//any other change rebuilds the heap at the next pop
+		vector<request_priority> m_request_heap;
+		bool m_request_heap_dirty;
+
+		//camera motion, only used on the main thread
+		glm::vec2 m_last_view_pos;
+		glm::vec2 m_view_velocity;
+		std::chrono::steady_clock::time_point m_last_poll_time;
+		bool m_view_tracked;
+		vector<uint64_t> m_page_counts_from_level; //pages of a tile from a mip level to the coarsest one
+		uint64_t m_prefetch_budget_in_pages;
+
+		//residency, only used on the main thread
+		vector<uint32_t> m_last_use; //the last poll in which the finest requested level of the tile was needed
+		uint32_t m_poll_index;
+		uint64_t m_requested_page_count;
+		uint64_t m_max_page_count;
+		terrain_residency_stats m_stats;
+		std::atomic<uint32_t> m_resident_page_count;
+
 		//queues
-		queue<uint32_t> m_request_queue;
-		queue<uint32_t> m_result_queue;
+		mpmc_queue<uint32_t> m_result_queue;
 
 		//thread
 		std::thread m_thread;
-		bool m_should_end;
-
-		//synchronization objects
-		VkSemaphore m_binding_finished_s;
-		VkFence m_copy_finished_f;
-
-		//cp, cb
-		VkCommandBuffer m_cb;
+		std::atomic<bool> m_should_end;
+
+		//io threads, the loader thread reads with index 0
+		std::thread m_io_threads[TERRAIN_IO_THREAD_COUNT - 1];
+		std::mutex m_io_mutex;
+		std::condition_variable m_io_cv;
+		std::condition_variable m_io_finished_cv;
+		read_batch m_read_batch;
+		uint32_t m_read_batch_index;
+		uint32_t m_finished_io_thread_count;
+		bool m_read_failed;
+		bool m_io_should_end;
+
+		//streaming slots and batches, the batches are gathered round robin
+		streaming_slot m_slots[TERRAIN_STREAMING_SLOT_COUNT];
+		streaming_batch m_batches[TERRAIN_STREAMING_BATCH_COUNT];
+		uint32_t m_next_batch;
+		vector<VkSparseImageMemoryBind> m_image_binds; //of the gathered batch
+		VkBufferImageCopy m_copy_regions[max_batch_slot_count]; //of the gathered batch
+
+		//cp
 		VkCommandPool m_cp;
 		
 		//data
 		vector<vector<vector<vector<uint64_t>>>> m_pages; //mip_level, tile_id.x // tile_id.y
+		vector<uint32_t> m_loaded_mip_levels; //the loader's view, m_current_mip_levels follows it through the results
 		glm::uvec2 m_tile_count;
 		glm::uvec2 m_tile_size;
+		glm::vec2 m_tile_size_in_meters;
+		uint32_t m_mip_level_count;
 		glm::uvec2 m_tile_size_in_pages;
 		uint32_t m_page_size;
+		glm::uvec2 m_page_size_in_texels;
 	};
 }
\ No newline at end of file
@@ -0,0 +1,18 @@
+#pragma once
+
+#include <stdint.h>
+
+namespace rcq
+{
+	struct terrain_residency_stats
+	{
+		uint64_t page_size;
+		uint32_t page_cap; //pages, the least recently used tiles are evicted above it
+		uint32_t requested_page_count; //pages of the requested levels
+		uint32_t resident_page_count; //pages bound to the terrain image
+		uint64_t evicted_level_count;
+		uint64_t rejected_load_count; //loads dropped because nothing could be evicted
+		uint64_t failed_load_count; //loads dropped because the tile could not be read
+		uint64_t prefetched_level_count;
+	};
+}
\ No newline at end of file
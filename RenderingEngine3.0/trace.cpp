@@ -0,0 +1,108 @@
+#include "trace.h"
+
+#include <fstream>
+#include <mutex>
+
+using namespace rcq;
+
+static trace::thread_buffer g_buffers[TRACE_MAX_THREAD_COUNT];
+static std::atomic<uint32_t> g_buffer_count(0);
+static std::mutex g_save_mutex; //the copy buffer is shared by the dumps
+
+trace::thread_buffer* trace::this_thread_buffer()
+{
+	thread_local thread_buffer* buffer = nullptr;
+	thread_local bool registered = false;
+	if (!registered)
+	{
+		registered = true;
+		uint32_t index = g_buffer_count.fetch_add(1);
+		if (index < TRACE_MAX_THREAD_COUNT)
+		{
+			buffer = g_buffers + index;
+			buffer->thread_index = index;
+			buffer->thread_name = nullptr;
+			buffer->write_count.store(0, std::memory_order_release);
+		}
+	}
+	return buffer;
+}
+
+void trace::set_thread_name(const char* name)
+{
+	thread_buffer* buffer = this_thread_buffer();
+	if (buffer != nullptr)
+		buffer->thread_name = name;
+}
+
+static void write_escaped(std::ofstream& file, const char* str)
+{
+	for (; *str != '\0'; ++str)
+	{
+		if (*str == '"' || *str == '\\')
+			file << '\\';
+		file << *str;
+	}
+}
+
+bool trace::save(const char* filename)
+{
+	std::lock_guard<std::mutex> lock(g_save_mutex);
+
+	std::ofstream file(filename, std::ios::trunc);
+	if (!file.is_open())
+		return false;
+
+	static event events[TRACE_EVENT_COUNT];
+	bool first = true;
+	auto separator = [&first, &file]()
+	{
+		file << (first ? "\n" : ",\n");
+		first = false;
+	};
+
+	file << "{\"displayTimeUnit\": \"ms\", \"traceEvents\": [";
+
+	uint32_t buffer_count = g_buffer_count.load();
+	buffer_count = buffer_count < TRACE_MAX_THREAD_COUNT ? buffer_count : TRACE_MAX_THREAD_COUNT;
+	for (uint32_t i = 0; i < buffer_count; ++i)
+	{
+		thread_buffer& buffer = g_buffers[i];
+
+		//copy the events, then drop the ones the writer could have overwritten meanwhile
+		uint64_t end = buffer.write_count.load(std::memory_order_acquire);
+		uint64_t begin = end > TRACE_EVENT_COUNT ? end - TRACE_EVENT_COUNT : 0;
+		for (uint64_t j = begin; j < end; ++j)
+			events[j - begin] = buffer.events[j & (TRACE_EVENT_COUNT - 1)];
+		std::atomic_thread_fence(std::memory_order_acquire);
+		uint64_t written = buffer.write_count.load(std::memory_order_relaxed);
+		uint64_t valid_begin = written > TRACE_EVENT_COUNT ? written - TRACE_EVENT_COUNT + 1 : 0;
+		valid_begin = valid_begin > begin ? valid_begin : begin;
+
+		const char* thread_name = buffer.thread_name;
+		separator();
+		file << "{\"name\": \"thread_name\", \"ph\": \"M\", \"pid\": 0, \"tid\": " << buffer.thread_index <<
+			", \"args\": {\"name\": \"";
+		if (thread_name != nullptr)
+			write_escaped(file, thread_name);
+		else
+			file << "thread " << buffer.thread_index;
+		file << "\"}}";
+
+		//chrome expects microseconds
+		for (uint64_t j = valid_begin; j < end; ++j)
+		{
+			const event& e = events[j - begin];
+			separator();
+			file << "{\"name\": \"";
+			write_escaped(file, e.name);
+			file << "\", \"ph\": \"X\", \"pid\": 0, \"tid\": " << buffer.thread_index <<
+				", \"ts\": " << e.begin / 1000 << '.' << (e.begin % 1000) / 100 <<
+				", \"dur\": " << (e.end - e.begin) / 1000 << '.' << ((e.end - e.begin) % 1000) / 100 << "}";
+		}
+	}
+
+	file << "\n]}\n";
+	file.close();
+	return true;
+}
\ No newline at end of file
@@ -0,0 +1,82 @@
+#pragma once
+
+#include "const_trace_event_count.h"
+#include "const_trace_max_thread_count.h"
+
+#include <atomic>
+#include <chrono>
+#include <stdint.h>
+
+namespace rcq
+{
+	//scoped cpu events, every thread writes its own ring buffer, the dump reads them while they are written
+	namespace trace
+	{
+		struct event
+		{
+			const char* name; //string literal
+			uint64_t begin; //ns
+			uint64_t end; //ns
+		};
+
+		//single writer, the reader drops the events overwritten during its copy
+		struct thread_buffer
+		{
+			event events[TRACE_EVENT_COUNT];
+			std::atomic<uint64_t> write_count;
+			const char* thread_name;
+			uint32_t thread_index;
+		};
+
+		//null if TRACE_MAX_THREAD_COUNT threads are traced already
+		thread_buffer* this_thread_buffer();
+		void set_thread_name(const char* name);
+
+		//chrome trace event format, can be called anytime from any thread
+		bool save(const char* filename);
+
+		inline uint64_t now()
+		{
+			return std::chrono::duration_cast<std::chrono::nanoseconds>(
+				std::chrono::steady_clock::now().time_since_epoch()).count();
+		}
+
+		class scope
+		{
+		public:
+			scope(const char* name) : m_name(name), m_begin(now()) {}
+
+			~scope()
+			{
+				thread_buffer* buffer = this_thread_buffer();
+				if (buffer == nullptr)
+					return;
+
+				uint64_t index = buffer->write_count.load(std::memory_order_relaxed);
+				event& e = buffer->events[index & (TRACE_EVENT_COUNT - 1)];
+				e.name = m_name;
+				e.begin = m_begin;
+				e.end = now();
+				buffer->write_count.store(index + 1, std::memory_order_release);
+			}
+
+			scope(const scope&) = delete;
+			scope& operator=(const scope&) = delete;
+
+		private:
+			const char* m_name;
+			uint64_t m_begin;
+		};
+	}
+}
+
+//define RCQ_DISABLE_TRACE to compile the tracing out
+#ifndef RCQ_DISABLE_TRACE
+#define RCQ_TRACE_CONCAT_IMPL(a, b) a##b
+#define RCQ_TRACE_CONCAT(a, b) RCQ_TRACE_CONCAT_IMPL(a, b)
+#define RCQ_TRACE_SCOPE(name) rcq::trace::scope RCQ_TRACE_CONCAT(rcq_trace_scope_, __LINE__)(name)
+#define RCQ_TRACE_THREAD_NAME(name) rcq::trace::set_thread_name(name)
+#else
+#define RCQ_TRACE_SCOPE(name)
+#define RCQ_TRACE_THREAD_NAME(name)
+#endif
\ No newline at end of file
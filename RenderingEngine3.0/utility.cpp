@@ -4,23 +4,20 @@
 #include <fstream>
 #include "vector.h"
 #include "os_memory.h"
+#include "terrain_file.h"
 
 using namespace rcq;
 
-/*uint32_t utility::find_memory_type(VkPhysicalDevice device, uint32_t type_filter, VkMemoryPropertyFlags properties)
+uint32_t utility::find_memory_type(const VkPhysicalDeviceMemoryProperties& memory_properties, uint32_t type_filter,
+	VkMemoryPropertyFlags properties)
 {
-	VkPhysicalDeviceMemoryProperties memory_properties;
-	vkGetPhysicalDeviceMemoryProperties(device, &memory_properties);
-
 	for (uint32_t i = 0; i < memory_properties.memoryTypeCount; ++i)
 	{
 		if ((type_filter & (1 << i)) && ((memory_properties.memoryTypes[i].propertyFlags & properties) == properties))
 			return i;
 	}
-
-	assert(false);
 	return ~0;
-}*/
+}
 
 void utility::read_file(const char* filename, char* dst, uint32_t& size)
 {
@@ -228,3 +225,79 @@ void utility::load_mesh(vector<vertex>& vertices, vector<uint32_t>& indices, vec
 
 
 }
+
+//helper for terrain converter, .terr texels are (grad.x, grad.y, height, 4x8 bit material weights as float bits)
+inline terrain_file::texel pack_terrain_texel(const glm::vec4& t)
+{
+	float height = glm::clamp(t.z, 0.f, 1.f);
+	terrain_file::texel packed = static_cast<terrain_file::texel>(height*65535.f + 0.5f);
+
+	uint32_t mask = *reinterpret_cast<const uint32_t*>(&t.w);
+	for (uint32_t i = 0; i < 4; ++i)
+	{
+		uint32_t weight = (mask >> (8 * i)) & 255u;
+		packed |= ((weight * 15u + 127u) / 255u) << (16 + 4 * i);
+	}
+	return packed;
+}
+
+void utility::convert_terrain_file(const char* src_filename, const char* dst_filename, const glm::uvec2& tile_count,
+	const glm::uvec2& tile_size)
+{
+	constexpr uint64_t src_texel_size = sizeof(glm::vec4);
+	constexpr uint64_t texel_size = sizeof(terrain_file::texel);
+
+	std::ifstream src(src_filename, std::ios::binary);
+	assert(src.is_open());
+	std::ofstream dst(dst_filename, std::ios::binary | std::ios::trunc);
+	assert(dst.is_open());
+
+	terrain_file::header header = {};
+	header.magic = terrain_file::MAGIC;
+	header.version = terrain_file::VERSION;
+	header.tile_count = tile_count;
+	header.tile_size = tile_size;
+	header.texel_size = static_cast<uint32_t>(texel_size);
+
+	//index table
+	uint32_t tile_total_count = tile_count.x*tile_count.y;
+	uint64_t tile_data_size = static_cast<uint64_t>(tile_size.x)*tile_size.y*texel_size;
+	vector<terrain_file::tile_entry> entries(&OS_MEMORY, tile_total_count);
+
+	uint64_t offset = sizeof(terrain_file::header) + tile_total_count * sizeof(terrain_file::tile_entry);
+	for (auto& e : entries)
+	{
+		offset = (offset + terrain_file::TILE_ALIGNMENT - 1) / terrain_file::TILE_ALIGNMENT*terrain_file::TILE_ALIGNMENT;
+		e.offset = offset;
+		e.size = tile_data_size;
+		offset += tile_data_size;
+	}
+
+	dst.write(reinterpret_cast<const char*>(&header), sizeof(terrain_file::header));
+	dst.write(reinterpret_cast<const char*>(entries.data()), tile_total_count * sizeof(terrain_file::tile_entry));
+
+	//a row of tiles is contiguous in the source file, it is read at once, packed and split into tiles
+	uint64_t row_texel_count = static_cast<uint64_t>(tile_count.x)*tile_size.x;
+	vector<glm::vec4> tile_row(&OS_MEMORY, row_texel_count*tile_size.y);
+	vector<terrain_file::texel> tile(&OS_MEMORY, static_cast<size_t>(tile_size.x)*tile_size.y);
+
+	for (uint32_t y = 0; y < tile_count.y; ++y)
+	{
+		src.read(reinterpret_cast<char*>(tile_row.data()), row_texel_count*tile_size.y*src_texel_size);
+		assert(src.good());
+
+		for (uint32_t x = 0; x < tile_count.x; ++x)
+		{
+			terrain_file::texel* tile_data = tile.data();
+			for (uint32_t row = 0; row < tile_size.y; ++row)
+			{
+				const glm::vec4* src_row = tile_row.data() + row*row_texel_count + x*tile_size.x;
+				for (uint32_t i = 0; i < tile_size.x; ++i)
+					*tile_data++ = pack_terrain_texel(src_row[i]);
+			}
+
+			dst.seekp(entries[x + y*tile_count.x].offset);
+			dst.write(reinterpret_cast<const char*>(tile.data()), tile_data_size);
+		}
+	}
+}
\ No newline at end of file
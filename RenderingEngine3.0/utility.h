@@ -4,11 +4,14 @@
 #include "vulkan.h"
 #include "vector.h"
 #include "vertex.h"
+#include "glm.h"
 
 
 namespace rcq::utility
 {
-	//uint32_t find_memory_type(VkPhysicalDevice device, uint32_t type_filter, VkMemoryPropertyFlags properties);
+	//the first memory type in type_filter with the properties, ~0 if there is none
+	uint32_t find_memory_type(const VkPhysicalDeviceMemoryProperties& memory_properties, uint32_t type_filter,
+		VkMemoryPropertyFlags properties);
 
 	void read_file(const char* filename, char* dst, uint32_t& size);
 
@@ -17,4 +20,8 @@ namespace rcq::utility
 
 	void load_mesh(vector<vertex>& vertices, vector<uint32_t>& indices, vector<vertex_ext>& vertices_ext, bool calc_tb, 
 		const char* filename, host_memory* memory);
+
+	//converts a row-major float .terr mip level file to the tile-major, packed terrain_file layout
+	void convert_terrain_file(const char* src_filename, const char* dst_filename, const glm::uvec2& tile_count,
+		const glm::uvec2& tile_size);
 }
@@ -4,29 +4,37 @@
 #include "device_memory.h"
 
 #include <assert.h>
+#include <atomic>
 
 namespace rcq
 {
 	class vk_memory : public device_memory
 	{
 	public:
-		vk_memory() {}
+		vk_memory() :
+			m_real_handle(VK_NULL_HANDLE)
+		{}
 
-		vk_memory(VkDevice device, uint32_t memory_type_index, const vk_allocator* vk_alloc) :
+		//the allocation is returned at base, a block heap keeps its block index in the offsets this way
+		vk_memory(VkDevice device, uint32_t memory_type_index, const vk_allocator* vk_alloc, VkDeviceSize base = 0) :
 			device_memory(VkDeviceSize(1)<<(sizeof(VkDeviceSize)*8-1), device, nullptr, nullptr),
-			m_vk_alloc(vk_alloc),
-			m_memory_type_index(memory_type_index)
+			m_real_handle(VK_NULL_HANDLE),
+			m_base(base),
+			m_memory_type_index(memory_type_index),
+			m_vk_alloc(vk_alloc)
 		{
 			m_handle = &m_real_handle;
 		}
 
-		void init(VkDevice device, uint32_t memory_type_index, const vk_allocator* vk_alloc)
+		void init(VkDevice device, uint32_t memory_type_index, const vk_allocator* vk_alloc, VkDeviceSize base = 0)
 		{
 			device_memory::init(VkDeviceSize(1) << (sizeof(VkDeviceSize) * 8 - 1), device, nullptr, nullptr);
 
 			m_vk_alloc = vk_alloc;
 			m_memory_type_index = memory_type_index;
 			m_handle = &m_real_handle;
+			m_real_handle = VK_NULL_HANDLE;
+			m_base = base;
 		}
 
 		~vk_memory()
@@ -35,28 +43,66 @@ namespace rcq
 		}
 
 		VkDeviceSize allocate(VkDeviceSize size, VkDeviceSize alignment = 0) override
+		{
+			return allocate_impl(size, nullptr);
+		}
+
+		//the allocation belongs to image only, VK_KHR_dedicated_allocation has to be enabled
+		VkDeviceSize allocate_dedicated(VkDeviceSize size, VkImage image)
+		{
+			VkMemoryDedicatedAllocateInfoKHR dedicated = {};
+			dedicated.sType = VK_STRUCTURE_TYPE_MEMORY_DEDICATED_ALLOCATE_INFO_KHR;
+			dedicated.image = image;
+			return allocate_impl(size, &dedicated);
+		}
+
+		void deallocate(VkDeviceSize p) override
+		{
+			assert(p == m_base && m_real_handle!=VK_NULL_HANDLE);
+			vkFreeMemory(m_device, m_real_handle, *m_vk_alloc);
+			m_real_handle = VK_NULL_HANDLE;
+			allocation_counter().fetch_sub(1);
+
+			m_accounting.deallocated(m_size);
+			m_accounting.upstream_deallocated(m_size);
+		}
+
+		//live allocations of every vk_memory, maxMemoryAllocationCount limits them for the device
+		static uint32_t allocation_count()
+		{
+			return allocation_counter().load();
+		}
+
+	private:
+		VkDeviceSize allocate_impl(VkDeviceSize size, const void* next)
 		{
 			assert(m_real_handle == VK_NULL_HANDLE);
 
 			VkMemoryAllocateInfo alloc = {};
 			alloc.sType = VK_STRUCTURE_TYPE_MEMORY_ALLOCATE_INFO;
+			alloc.pNext = next;
 			alloc.memoryTypeIndex = m_memory_type_index;
 			alloc.allocationSize = size;
 
 			assert(vkAllocateMemory(m_device, &alloc, *m_vk_alloc, &m_real_handle)==VK_SUCCESS);
+			allocation_counter().fetch_add(1);
 
-			return 0;
+			m_size = size;
+			m_accounting.upstream_allocated(size);
+			m_accounting.allocated(size);
+
+			return m_base;
 		}
 
-		void deallocate(VkDeviceSize p) override
+		static std::atomic<uint32_t>& allocation_counter()
 		{
-			assert(p == 0 && m_real_handle!=VK_NULL_HANDLE);
-			vkFreeMemory(m_device, m_real_handle, *m_vk_alloc);
-			m_real_handle = VK_NULL_HANDLE;
+			static std::atomic<uint32_t> count(0);
+			return count;
 		}
 
-	private:
 		VkDeviceMemory m_real_handle;
+		VkDeviceSize m_base;
+		VkDeviceSize m_size;
 		uint32_t m_memory_type_index;
 		const vk_allocator* m_vk_alloc;
 	};
@@ -0,0 +1,244 @@
+#include "water_simulator.h"
+
+#include "os_memory.h"
+#include "utility.h"
+
+#include "const_water_grid_size.h"
+#include "const_water_simulation_thread_count.h"
+#include "const_pi.h"
+
+#include <thread>
+#include <math.h>
+
+using namespace rcq;
+
+namespace
+{
+	constexpr float G_SQUARE = 96.2361f;
+	constexpr float G = 9.81f;
+
+	static_assert(WATER_GRID_SIZE_256 % (WATER_SIMULATION_THREAD_COUNT*simd_fft::LANE_STEP) == 0,
+		"every thread must get a whole number of simd lanes");
+
+	template<typename F>
+	void run_parallel(uint32_t grid_size, F f)
+	{
+		uint32_t lane_count = grid_size / WATER_SIMULATION_THREAD_COUNT;
+
+		std::thread threads[WATER_SIMULATION_THREAD_COUNT - 1];
+		for (uint32_t i = 1; i < WATER_SIMULATION_THREAD_COUNT; ++i)
+			threads[i - 1] = std::thread(f, i*lane_count, (i + 1)*lane_count);
+		f(0, lane_count);
+
+		for (auto& t : threads)
+			t.join();
+	}
+}
+
+water_simulator::water_simulator(const resource<RES_TYPE_WATER>::build_info& build) :
+	m_fft(build.grid_size)
+{
+	m_grid_size = build.grid_size;
+	assert(m_grid_size == WATER_GRID_SIZE_256 || m_grid_size == WATER_GRID_SIZE_512 || m_grid_size == WATER_GRID_SIZE_1024);
+
+	m_grid_size_log2 = 0;
+	while ((1u << m_grid_size_log2) < m_grid_size)
+		++m_grid_size_log2;
+	m_stage_count = m_fft.stage_count();
+
+	m_grid_size_in_meters = build.grid_size_in_meters;
+	m_params.base_frequency = build.base_frequency;
+	m_params.sqrtA = sqrtf(build.A);
+	m_params.two_pi_per_L = glm::vec2(2.f*PI) / build.grid_size_in_meters;
+	m_params.grid_size = m_grid_size;
+	m_params.grid_size_log2 = m_grid_size_log2;
+
+	size_t element_count = static_cast<size_t>(m_grid_size)*m_grid_size;
+
+	//load noise
+	{
+		size_t noise_size = static_cast<size_t>(MAX_WATER_GRID_SIZE)*MAX_WATER_GRID_SIZE * sizeof(glm::vec4);
+		glm::vec4* file_data = reinterpret_cast<glm::vec4*>(OS_MEMORY.allocate(noise_size, alignof(glm::vec4)));
+		uint32_t __size;
+		utility::read_file(build.filename, reinterpret_cast<char*>(file_data), __size);
+
+		m_noise = reinterpret_cast<glm::vec2*>(OS_MEMORY.allocate(element_count * sizeof(glm::vec2), alignof(glm::vec2)));
+		for (uint32_t y = 0; y < m_grid_size; ++y)
+		{
+			for (uint32_t x = 0; x < m_grid_size; ++x)
+			{
+				const glm::vec4& n = file_data[y*MAX_WATER_GRID_SIZE + x];
+				m_noise[x*m_grid_size + y] = glm::vec2(n.x, n.y);
+			}
+		}
+
+		OS_MEMORY.deallocate(reinterpret_cast<size_t>(file_data));
+	}
+
+	for (auto& planes : m_planes)
+	{
+		for (auto& plane : planes)
+			plane = reinterpret_cast<float*>(OS_MEMORY.allocate(element_count * sizeof(float), 32));
+	}
+	m_result = m_planes[1];
+}
+
+water_simulator::~water_simulator()
+{
+	for (auto& planes : m_planes)
+	{
+		for (auto plane : planes)
+			OS_MEMORY.deallocate(reinterpret_cast<size_t>(plane));
+	}
+	OS_MEMORY.deallocate(reinterpret_cast<size_t>(m_noise));
+}
+
+void water_simulator::simulate(const glm::vec2& wind, float time)
+{
+	m_wind_dir = glm::normalize(wind);
+	m_one_over_wind_speed_to_the_4 = 1.f / powf(glm::length(wind), 4.f);
+	m_time = time;
+
+	run_parallel(m_grid_size, [this](uint32_t lane_begin, uint32_t lane_end)
+	{
+		transform_first_axis(lane_begin, lane_end);
+	});
+	run_parallel(m_grid_size, [this](uint32_t lane_begin, uint32_t lane_end)
+	{
+		transpose(lane_begin, lane_end);
+	});
+	run_parallel(m_grid_size, [this](uint32_t lane_begin, uint32_t lane_end)
+	{
+		transform_second_axis(lane_begin, lane_end);
+	});
+}
+
+float water_simulator::height(const glm::vec2& pos) const
+{
+	return sample(m_result[HEIGHT_RE], pos);
+}
+
+glm::vec2 water_simulator::grad(const glm::vec2& pos) const
+{
+	return glm::vec2(sample(m_result[GRAD_X_RE], pos), sample(m_result[GRAD_Z_RE], pos)) / m_grid_size_in_meters;
+}
+
+float water_simulator::sample(const float* plane, const glm::vec2& pos) const
+{
+	glm::vec2 texel = pos / m_grid_size_in_meters * static_cast<float>(m_grid_size) - 0.5f;
+	glm::vec2 base = glm::floor(texel);
+	glm::vec2 f = texel - base;
+
+	int mask = static_cast<int>(m_grid_size) - 1;
+	uint32_t x0 = static_cast<uint32_t>(static_cast<int>(base.x) & mask);
+	uint32_t y0 = static_cast<uint32_t>(static_cast<int>(base.y) & mask);
+	uint32_t x1 = (x0 + 1) & mask;
+	uint32_t y1 = (y0 + 1) & mask;
+
+	float top = glm::mix(plane[y0*m_grid_size + x0], plane[y0*m_grid_size + x1], f.x);
+	float bottom = glm::mix(plane[y1*m_grid_size + x0], plane[y1*m_grid_size + x1], f.x);
+	return glm::mix(top, bottom, f.y);
+}
+
+void water_simulator::generate_spectrum(uint32_t lane_begin, uint32_t lane_end)
+{
+	//same as generate_spectrum in water_compute.comp, written in the transposed layout
+	int size = static_cast<int>(m_grid_size);
+	int half_size = size >> 1;
+	float one_over_L_square = m_one_over_wind_speed_to_the_4*G_SQUARE;
+	float* const* planes = m_planes[0];
+
+	for (int x = 0; x < size; ++x)
+	{
+		float der_x = 0.f;
+		if (x < half_size)
+			der_x = static_cast<float>(x);
+		else if (x > half_size)
+			der_x = static_cast<float>(x - size);
+		der_x *= -m_params.two_pi_per_L.x;
+
+		for (int y = static_cast<int>(lane_begin); y < static_cast<int>(lane_end); ++y)
+		{
+			size_t index = static_cast<size_t>(x)*size + y;
+			glm::vec2 noise_k = m_noise[index];
+			glm::vec2 noise_minusk = m_noise[static_cast<size_t>((size - x) & (size - 1))*size + ((size - y) & (size - 1))];
+			glm::vec2 k_vec = m_params.two_pi_per_L*glm::vec2(static_cast<float>(x - half_size), static_cast<float>(y - half_size));
+			float k_length = glm::length(k_vec);
+
+			glm::vec2 h_k_t(0.f);
+			if (x != half_size || y != half_size)
+			{
+				glm::vec2 k_norm = k_vec / k_length;
+				float one_over_k_length_square = 1.f / (k_length*k_length);
+				float sqrt_P_k = m_params.sqrtA*expf(-0.5f*one_over_k_length_square*one_over_L_square)*
+					one_over_k_length_square*fabsf(glm::dot(m_wind_dir, k_norm));
+				glm::vec2 h_0_k = sqrt_P_k*noise_k;
+				glm::vec2 h_0_minusk = sqrt_P_k*noise_minusk;
+
+				float omega_k = floorf(sqrtf(G*k_length) / m_params.base_frequency)*m_params.base_frequency;
+				float phi = omega_k*m_time;
+				float c = cosf(phi);
+				float s = sinf(phi);
+
+				h_k_t.x = h_0_k.x*c - h_0_k.y*s + h_0_minusk.x*c - h_0_minusk.y*s;
+				h_k_t.y = h_0_k.x*s + h_0_k.y*c - h_0_minusk.x*s - h_0_minusk.y*c;
+			}
+
+			float der_y = 0.f;
+			if (y < half_size)
+				der_y = static_cast<float>(y);
+			else if (y > half_size)
+				der_y = static_cast<float>(y - size);
+			der_y *= -m_params.two_pi_per_L.y;
+
+			planes[HEIGHT_RE][index] = h_k_t.x;
+			planes[HEIGHT_IM][index] = h_k_t.y;
+			planes[GRAD_X_RE][index] = -h_k_t.y*der_x;
+			planes[GRAD_X_IM][index] = h_k_t.x*der_x;
+			planes[GRAD_Z_RE][index] = -h_k_t.y*der_y;
+			planes[GRAD_Z_IM][index] = h_k_t.x*der_y;
+		}
+	}
+}
+
+void water_simulator::transform_first_axis(uint32_t lane_begin, uint32_t lane_end)
+{
+	//lanes are y, the columns of the transposed layout run along x
+	generate_spectrum(lane_begin, lane_end);
+	m_fft.transform_columns(m_planes[0], m_planes[1], PLANE_COUNT, lane_begin, lane_end);
+}
+
+void water_simulator::transpose(uint32_t lane_begin, uint32_t lane_end)
+{
+	float* const* src = m_planes[m_stage_count & 1];
+	float* const* dst = m_planes[(m_stage_count & 1) ^ 1];
+
+	for (uint32_t plane = 0; plane < PLANE_COUNT; ++plane)
+	{
+		for (uint32_t y = 0; y < m_grid_size; ++y)
+		{
+			for (uint32_t x = lane_begin; x < lane_end; ++x)
+				dst[plane][y*m_grid_size + x] = src[plane][x*m_grid_size + y];
+		}
+	}
+}
+
+void water_simulator::transform_second_axis(uint32_t lane_begin, uint32_t lane_end)
+{
+	//lanes are x, the columns run along y
+	float* const* result = m_fft.transform_columns(m_planes[(m_stage_count & 1) ^ 1], m_planes[m_stage_count & 1], PLANE_COUNT,
+		lane_begin, lane_end);
+
+	//sign correction, only the real parts are read
+	for (uint32_t y = 0; y < m_grid_size; ++y)
+	{
+		for (uint32_t x = lane_begin; x < lane_end; ++x)
+		{
+			float correction = static_cast<float>(2 * ((x + y) & 1) - 1);
+			size_t index = static_cast<size_t>(y)*m_grid_size + x;
+			result[HEIGHT_RE][index] *= correction;
+			result[GRAD_X_RE][index] *= correction;
+			result[GRAD_Z_RE][index] *= correction;
+		}
+	}
+}
\ No newline at end of file
@@ -0,0 +1,86 @@
+#pragma once
+
+#include "resources.h"
+#include "simd_fft.h"
+
+namespace rcq
+{
+	//cpu reference of the water_compute shader, evaluates the same spectrum and fft for gameplay queries
+	//and for validating the gpu output. simulate() and the queries must not overlap.
+	class water_simulator
+	{
+	public:
+		water_simulator(const resource<RES_TYPE_WATER>::build_info& build);
+		~water_simulator();
+		water_simulator(const water_simulator&) = delete;
+		water_simulator(water_simulator&&) = delete;
+		water_simulator& operator=(const water_simulator&) = delete;
+		water_simulator& operator=(water_simulator&&) = delete;
+
+		//wind and time as in render_settings
+		void simulate(const glm::vec2& wind, float time);
+
+		//pos is the world space xz position in meters, sampled like the water drawer (bilinear, repeat)
+		float height(const glm::vec2& pos) const;
+		glm::vec2 grad(const glm::vec2& pos) const;
+
+		//the raw grids, same values as layer 0 .x and layer 1 .xz of the water texture
+		uint32_t grid_size() const
+		{
+			return m_grid_size;
+		}
+		const float* heights() const
+		{
+			return m_result[HEIGHT_RE];
+		}
+		const float* grads_x() const
+		{
+			return m_result[GRAD_X_RE];
+		}
+		const float* grads_z() const
+		{
+			return m_result[GRAD_Z_RE];
+		}
+
+	private:
+		//planes of the three complex fields, stored as separate real and imaginary arrays
+		enum PLANE
+		{
+			HEIGHT_RE,
+			HEIGHT_IM,
+			GRAD_X_RE,
+			GRAD_X_IM,
+			GRAD_Z_RE,
+			GRAD_Z_IM,
+			PLANE_COUNT
+		};
+
+		//simulation steps, each thread works on its own range of lanes
+		void generate_spectrum(uint32_t lane_begin, uint32_t lane_end);
+		void transform_first_axis(uint32_t lane_begin, uint32_t lane_end);
+		void transpose(uint32_t lane_begin, uint32_t lane_end);
+		void transform_second_axis(uint32_t lane_begin, uint32_t lane_end);
+
+		float sample(const float* plane, const glm::vec2& pos) const;
+
+		uint32_t m_grid_size;
+		uint32_t m_grid_size_log2;
+		resource<RES_TYPE_WATER>::fft_params_data m_params;
+		glm::vec2 m_grid_size_in_meters;
+
+		glm::vec2 m_wind_dir;
+		float m_one_over_wind_speed_to_the_4;
+		float m_time;
+
+		//noise.xy, transposed: element (x, y) is at x*grid_size+y
+		glm::vec2* m_noise;
+
+		//the same stockham stages as the shader, simd lanes are neighbouring columns
+		simd_fft m_fft;
+
+		//the first axis is transformed in the transposed layout, the result always ends up in m_planes[1]
+		float* m_planes[2][PLANE_COUNT];
+		float* const* m_result;
+		uint32_t m_stage_count;
+	};
+}
\ No newline at end of file